@@ -0,0 +1,105 @@
+// Assembly benchmark: compares the templated coefficient providers against the
+// type-erased std::function paths on the element loop of EllipticFEMSolver. The last column
+// assembles the static coefficients on the grid view of the same mesh, where a constant
+// operator takes the reference element matrices of assembleUniformGrid.
+//
+// Usage: AssemblyBenchmark [Nx] [Ny] [repetitions]
+
+#include "AssemblyKernels.h"
+#include "CoefficientProviders.h"
+#include "EllipticFEMSolver.h"
+#include "MeshGenerator.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Time repeated assembly into the same system; the values accumulate but only the time matters
+template <class MeshType, class Coefficients>
+double nanosecondsPerElement(const MeshType& mesh, const Coefficients& coeffs, int repetitions) {
+    const std::size_t n = mesh.nodeCount();
+    std::vector<std::vector<double>> K(n, std::vector<double>(n, 0.0));
+    std::vector<double> F(n, 0.0);
+
+    assembleElements(mesh, coeffs, K, F); // Warm-up
+
+    auto start = Clock::now();
+    for (int r = 0; r < repetitions; ++r) {
+        assembleElements(mesh, coeffs, K, F);
+    }
+    std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+    // Keep the result observable so the loop is not optimized away
+    volatile double sink = F[n / 2];
+    (void)sink;
+
+    return elapsed.count() / (static_cast<double>(repetitions) * mesh.elementCount());
+}
+
+// Run one coefficient set through the three paths
+template <class A11, class A12, class A22, class B1, class B2, class C, class F>
+void runCase(const std::string& name, const Mesh& mesh, const StructuredMeshView& grid, int repetitions,
+             const CoefficientSet<A11, A12, A22, B1, B2, C, F>& coeffs) {
+    auto pointwise = makeCoefficientSet(
+        FunctionCoefficient{ toCoefficientFunction(coeffs.a11) }, FunctionCoefficient{ toCoefficientFunction(coeffs.a12) },
+        FunctionCoefficient{ toCoefficientFunction(coeffs.a22) }, FunctionCoefficient{ toCoefficientFunction(coeffs.b1) },
+        FunctionCoefficient{ toCoefficientFunction(coeffs.b2) }, FunctionCoefficient{ toCoefficientFunction(coeffs.c) },
+        FunctionCoefficient{ toCoefficientFunction(coeffs.f) });
+
+    DynamicCoefficientSet batched = {
+        { EllipticFEMSolver::toBatchFunction(toCoefficientFunction(coeffs.a11)) },
+        { EllipticFEMSolver::toBatchFunction(toCoefficientFunction(coeffs.a12)) },
+        { EllipticFEMSolver::toBatchFunction(toCoefficientFunction(coeffs.a22)) },
+        { EllipticFEMSolver::toBatchFunction(toCoefficientFunction(coeffs.b1)) },
+        { EllipticFEMSolver::toBatchFunction(toCoefficientFunction(coeffs.b2)) },
+        { EllipticFEMSolver::toBatchFunction(toCoefficientFunction(coeffs.c)) },
+        { EllipticFEMSolver::toBatchFunction(toCoefficientFunction(coeffs.f)) }
+    };
+
+    double tPointwise = nanosecondsPerElement(mesh, pointwise, repetitions);
+    double tBatched = nanosecondsPerElement(mesh, batched, repetitions);
+    double tStatic = nanosecondsPerElement(mesh, coeffs, repetitions);
+    double tGrid = nanosecondsPerElement(grid, coeffs, repetitions);
+
+    std::printf("%-20s %14.2f %14.2f %14.2f %9.2fx %14.2f\n",
+                name.c_str(), tPointwise, tBatched, tStatic, tPointwise / tStatic, tGrid);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int Nx = argc > 1 ? std::atoi(argv[1]) : 40;
+    int Ny = argc > 2 ? std::atoi(argv[2]) : 40;
+    int repetitions = argc > 3 ? std::atoi(argv[3]) : 200;
+
+    MeshGenerator generator(2.0, 2.0, Nx, Ny);
+    Mesh mesh = generator.generate();
+    StructuredMeshView grid = generator.view();
+
+    std::printf("Mesh: %d x %d nodes, %zu elements, %d repetitions\n", Nx, Ny, mesh.elementCount(), repetitions);
+    std::printf("%-20s %14s %14s %14s %10s %14s\n", "case [ns/element]", "std::function", "batched", "static", "speedup", "static grid");
+
+    runCase("poisson", mesh, grid, repetitions, makeCoefficientSet(
+        ConstantCoefficient{ 1.0 }, ZeroCoefficient{}, ConstantCoefficient{ 1.0 },
+        ZeroCoefficient{}, ZeroCoefficient{}, ZeroCoefficient{},
+        [](double x, double y) { return 2.0 * M_PI * M_PI * std::sin(M_PI * x) * std::sin(M_PI * y); }));
+
+    auto convectionDiffusion = [](double x, double) { return 0.01 + 0.005 * x; };
+    runCase("convection-diffusion", mesh, grid, repetitions, makeCoefficientSet(
+        convectionDiffusion, ZeroCoefficient{}, convectionDiffusion,
+        ConstantCoefficient{ 1.0 }, ZeroCoefficient{}, ZeroCoefficient{},
+        [](double x, double y) { return std::exp(-10.0 * ((x - 2.0) * (x - 2.0) + (y - 0.5) * (y - 0.5))); }));
+
+    auto reactionDiffusion = [](double x, double y) { return 0.1 + 0.05 * x * y; };
+    runCase("reaction-diffusion", mesh, grid, repetitions, makeCoefficientSet(
+        reactionDiffusion, ZeroCoefficient{}, reactionDiffusion,
+        ZeroCoefficient{}, ZeroCoefficient{}, ConstantCoefficient{ 1.0 },
+        [](double x, double y) { return 10.0 * std::exp(-5.0 * ((x - 1.0) * (x - 1.0) + (y - 1.0) * (y - 1.0))); }));
+
+    return 0;
+}
\ No newline at end of file
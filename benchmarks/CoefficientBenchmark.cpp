@@ -0,0 +1,186 @@
+// Coefficient evaluation benchmark: evaluations per second for every coefficient string of the
+// preset table, through each evaluation path of FunctionParser and through equivalent C++ lambdas.
+// Results are written as JSON to stdout so runs of different builds can be compared.
+//
+// Usage: CoefficientBenchmark [points] [milliseconds per measurement]
+
+#include "FunctionParser.h"
+#include "PresetData.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Evaluation points spread over the preset domain
+struct Points {
+    std::vector<double> x, y;
+};
+
+Points makePoints(double Lx, double Ly, std::size_t count) {
+    Points points;
+    std::size_t side = static_cast<std::size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    for (std::size_t k = 0; k < count; ++k) {
+        std::size_t i = k % side, j = k / side;
+        points.x.push_back(Lx * (i + 0.5) / side);
+        points.y.push_back(Ly * (j + 0.5) / side);
+    }
+    return points;
+}
+
+// Repeat a pass over all points until the time budget is spent; returns evaluations per second
+template <class Pass>
+double evaluationsPerSecond(const Points& points, double milliseconds, Pass pass) {
+    pass(); // Warm-up
+
+    std::size_t passes = 0;
+    auto start = Clock::now();
+    std::chrono::duration<double, std::milli> elapsed(0.0);
+    do {
+        pass();
+        ++passes;
+        elapsed = Clock::now() - start;
+    } while (elapsed.count() < milliseconds);
+
+    return static_cast<double>(passes) * points.x.size() / (elapsed.count() * 1e-3);
+}
+
+volatile double g_sink = 0.0;
+
+template <class Function>
+double timePointwise(const Points& points, double milliseconds, const Function& function) {
+    return evaluationsPerSecond(points, milliseconds, [&]() {
+        double sum = 0.0;
+        for (std::size_t k = 0; k < points.x.size(); ++k) {
+            sum += function(points.x[k], points.y[k]);
+        }
+        g_sink = g_sink + sum;
+    });
+}
+
+// Hand-written equivalents of the preset strings. Strings FunctionParser rejects (they use '^')
+// are written with the intended meaning, so the lambda column shows the cost of a correct value.
+double timeLambda(const std::string& expr, const Points& points, double milliseconds) {
+    auto time = [&](auto function) { return timePointwise(points, milliseconds, function); };
+
+    if (expr == "0.0") return time([](double, double) { return 0.0; });
+    if (expr == "1.0") return time([](double, double) { return 1.0; });
+    if (expr == "0.1") return time([](double, double) { return 0.1; });
+    if (expr == "0.2") return time([](double, double) { return 0.2; });
+    if (expr == "0.2*x") return time([](double x, double) { return 0.2 * x; });
+    if (expr == "0.1*y") return time([](double, double y) { return 0.1 * y; });
+    if (expr == "0.01 + 0.005*x") return time([](double x, double) { return 0.01 + 0.005 * x; });
+    if (expr == "0.1 + 0.05*x*y") return time([](double x, double y) { return 0.1 + 0.05 * x * y; });
+    if (expr == "0.8 + 0.3*cos(pi*x)") return time([](double x, double) { return 0.8 + 0.3 * std::cos(M_PI * x); });
+    if (expr == "cos(pi*x/3)*cos(pi*y)") {
+        return time([](double x, double y) { return std::cos(M_PI * x / 3) * std::cos(M_PI * y); });
+    }
+    if (expr == "8*pi*pi*sin(2*pi*x)*sin(2*pi*y)") {
+        return time([](double x, double y) { return 8 * M_PI * M_PI * std::sin(2 * M_PI * x) * std::sin(2 * M_PI * y); });
+    }
+    if (expr == "1 + 0.5*sin(pi*x)*cos(pi*y)") {
+        return time([](double x, double y) { return 1 + 0.5 * std::sin(M_PI * x) * std::cos(M_PI * y); });
+    }
+    if (expr == "exp(-10*((x-2)^2 + (y-0.5)^2))") {
+        return time([](double x, double y) { return std::exp(-10 * ((x - 2) * (x - 2) + (y - 0.5) * (y - 0.5))); });
+    }
+    if (expr == "10*exp(-5*((x-1)^2 + (y-1)^2)) + 2*pi^2*cos(pi*x)*cos(pi*y)") {
+        return time([](double x, double y) {
+            return 10 * std::exp(-5 * ((x - 1) * (x - 1) + (y - 1) * (y - 1))) +
+                   2 * M_PI * M_PI * std::cos(M_PI * x) * std::cos(M_PI * y);
+        });
+    }
+    if (expr == "sin(pi*x/2)*sin(pi*y) + 0.5*pi^2*cos(pi*x/2)*cos(pi*y)") {
+        return time([](double x, double y) {
+            return std::sin(M_PI * x / 2) * std::sin(M_PI * y) + 0.5 * M_PI * M_PI * std::cos(M_PI * x / 2) * std::cos(M_PI * y);
+        });
+    }
+    return -1.0; // No equivalent written
+}
+
+// Preset strings are ASCII apart from the descriptions
+std::string narrow(const wchar_t* text) {
+    std::string result;
+    for (; *text; ++text) {
+        result += (*text < 128) ? static_cast<char>(*text) : '?';
+    }
+    return result;
+}
+
+std::string jsonString(const std::string& text) {
+    std::string result = "\"";
+    for (char ch : text) {
+        if (ch == '"' || ch == '\\') result += '\\';
+        result += ch;
+    }
+    return result + "\"";
+}
+
+std::string jsonNumber(double value) {
+    if (value < 0.0) return "null";
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.6g", value);
+    return buffer;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t pointCount = argc > 1 ? static_cast<std::size_t>(std::atol(argv[1])) : 4096;
+    double milliseconds = argc > 2 ? std::atof(argv[2]) : 50.0;
+    if (pointCount == 0) pointCount = 1;
+
+    const char* coefficientNames[] = { "a11", "a12", "a22", "b1", "b2", "c", "f" };
+
+    std::printf("{\n");
+    std::printf("  \"benchmark\": \"coefficient-evaluation\",\n");
+    std::printf("  \"points\": %zu,\n", pointCount);
+    std::printf("  \"unit\": \"evaluations/s\",\n");
+    std::printf("  \"results\": [");
+
+    bool first = true;
+    for (int p = 0; p < NUM_PRESETS; ++p) {
+        const PresetData& preset = PRESETS[p];
+        const wchar_t* expressions[] = { preset.a11, preset.a12, preset.a22, preset.b1, preset.b2, preset.c, preset.f };
+        Points points = makePoints(std::wcstod(preset.lx, nullptr), std::wcstod(preset.ly, nullptr), pointCount);
+        std::vector<double> out(pointCount);
+
+        for (int k = 0; k < 7; ++k) {
+            std::string expr = narrow(expressions[k]);
+            std::shared_ptr<const CompiledExpression> compiled = FunctionParser::compile(expr);
+            CoefficientFunction parsed = FunctionParser::parseFunction(expr);
+
+            double interpreter = timePointwise(points, milliseconds, [&](double x, double y) {
+                return FunctionParser::safeEval(expr, x, y);
+            });
+            double parseFunction = timePointwise(points, milliseconds, parsed);
+            double compiledPoint = timePointwise(points, milliseconds, [&](double x, double y) {
+                return compiled->evaluate(x, y);
+            });
+            double compiledBatch = evaluationsPerSecond(points, milliseconds, [&]() {
+                compiled->evaluate(points.x.data(), points.y.data(), out.data(), pointCount);
+                g_sink = g_sink + out[pointCount / 2];
+            });
+            double lambda = timeLambda(expr, points, milliseconds);
+
+            std::printf("%s\n    {\"preset\": %s, \"coefficient\": \"%s\", \"expression\": %s, \"valid\": %s,\n",
+                        first ? "" : ",", jsonString(narrow(preset.name)).c_str(), coefficientNames[k],
+                        jsonString(expr).c_str(), compiled->isValid() ? "true" : "false");
+            std::printf("     \"interpreter\": %s, \"parseFunction\": %s, \"compiled\": %s, \"compiledBatch\": %s, \"lambda\": %s}",
+                        jsonNumber(interpreter).c_str(), jsonNumber(parseFunction).c_str(),
+                        jsonNumber(compiledPoint).c_str(), jsonNumber(compiledBatch).c_str(), jsonNumber(lambda).c_str());
+            std::fflush(stdout);
+            first = false;
+        }
+    }
+
+    std::printf("\n  ]\n}\n");
+    return 0;
+}
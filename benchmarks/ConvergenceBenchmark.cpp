@@ -0,0 +1,168 @@
+// Convergence benchmark: time-to-accuracy of linear (P1) triangles, bilinear (Q1) quadrilaterals
+// and quadratic (P2) triangles on the manufactured problem -lap u = f on the unit square with
+// u = 0 on the boundary and exact solution u = x (1 - x) y (1 - y) e^(x + y). Unlike a sampled
+// sine product, this is no eigenvector of the grid operators, so the iterative solves do real
+// work. All three use SparseFEMSolver.
+//
+// Usage: ConvergenceBenchmark [levels] [coarsest N]
+
+#include "MeshGenerator.h"
+#include "SparseFEMSolver.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double exact(double x, double y) { return x * (1.0 - x) * y * (1.0 - y) * std::exp(x + y); }
+
+// -lap u for the exact solution
+double load(double x, double y) {
+    return x * y * std::exp(x + y) * ((x + 3.0) * (1.0 - y) + (1.0 - x) * (y + 3.0));
+}
+
+// Degree 4 rule (see SparseFEMSolver) for the L2 error
+const double kPoints[6][3] = {
+    { 0.445948490915965, 0.445948490915965, 0.108103018168070 },
+    { 0.445948490915965, 0.108103018168070, 0.445948490915965 },
+    { 0.108103018168070, 0.445948490915965, 0.445948490915965 },
+    { 0.091576213509771, 0.091576213509771, 0.816847572980459 },
+    { 0.091576213509771, 0.816847572980459, 0.091576213509771 },
+    { 0.816847572980459, 0.091576213509771, 0.091576213509771 },
+};
+const double kWeights[6] = { 0.223381589678011, 0.223381589678011, 0.223381589678011,
+                             0.109951743655322, 0.109951743655322, 0.109951743655322 };
+
+// L2 error of a linear (nodesPerElement 3) or quadratic (6) solution
+double l2Error(const AlignedDoubleVector& x, const AlignedDoubleVector& y, const MeshIndexVector& connectivity,
+               int nodesPerElement, const std::vector<double>& u) {
+    double sum = 0.0;
+    for (std::size_t e = 0; e < connectivity.size() / nodesPerElement; ++e) {
+        const MeshIndex* t = &connectivity[nodesPerElement * e];
+        double area = 0.5 * std::abs((x[t[1]] - x[t[0]]) * (y[t[2]] - y[t[0]]) - (x[t[2]] - x[t[0]]) * (y[t[1]] - y[t[0]]));
+        for (int q = 0; q < 6; ++q) {
+            const double* l = kPoints[q];
+            double uh = 0.0;
+            for (int k = 0; k < 3; ++k) {
+                if (nodesPerElement == 3) {
+                    uh += l[k] * u[t[k]];
+                } else {
+                    uh += l[k] * (2.0 * l[k] - 1.0) * u[t[k]] + 4.0 * l[(k + 1) % 3] * l[(k + 2) % 3] * u[t[3 + k]];
+                }
+            }
+            double px = l[0] * x[t[0]] + l[1] * x[t[1]] + l[2] * x[t[2]];
+            double py = l[0] * y[t[0]] + l[1] * y[t[1]] + l[2] * y[t[2]];
+            double diff = uh - exact(px, py);
+            sum += kWeights[q] * area * diff * diff;
+        }
+    }
+    return std::sqrt(sum);
+}
+
+// L2 error of a bilinear solution on the cells of an N x N grid of the unit square, with the
+// 3 x 3 Gauss rule
+double l2ErrorBilinear(int N, const std::vector<double>& u) {
+    const double points[3] = { 0.5 - 0.5 * std::sqrt(0.6), 0.5, 0.5 + 0.5 * std::sqrt(0.6) };
+    const double weights[3] = { 5.0 / 18.0, 8.0 / 18.0, 5.0 / 18.0 };
+    const double h = 1.0 / (N - 1);
+    double sum = 0.0;
+    for (int i = 0; i < N - 1; ++i) {
+        for (int j = 0; j < N - 1; ++j) {
+            const std::size_t n1 = static_cast<std::size_t>(i) * N + j;
+            const double corners[4] = { u[n1], u[n1 + 1], u[n1 + N], u[n1 + N + 1] };
+            for (int qy = 0; qy < 3; ++qy) {
+                for (int qx = 0; qx < 3; ++qx) {
+                    double s = points[qx], t = points[qy];
+                    double uh = (1 - s) * (1 - t) * corners[0] + s * (1 - t) * corners[1] +
+                                (1 - s) * t * corners[2] + s * t * corners[3];
+                    double diff = uh - exact((j + s) * h, (i + t) * h);
+                    sum += weights[qx] * weights[qy] * h * h * diff * diff;
+                }
+            }
+        }
+    }
+    return std::sqrt(sum);
+}
+
+struct Run {
+    std::size_t dofs;
+    double error;
+    double milliseconds;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int levels = argc > 1 ? std::atoi(argv[1]) : 6;
+    int coarsest = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    SparseFEMSolver solver(
+        [](double, double) { return 1.0; }, nullptr, [](double, double) { return 1.0; },
+        nullptr, nullptr, nullptr,
+        load);
+    solver.setTolerance(1e-12, 100000);
+    std::map<std::string, BoundaryConditionData> boundaryConditions;
+    BoundaryConditionData zero;
+    zero.type = "dirichlet";
+    for (const char* side : { "west", "east", "south", "north" }) boundaryConditions[side] = zero;
+
+    const char* names[3] = { "P1", "Q1", "P2" };
+    std::printf("%5s %6s %10s %12s %8s %12s %10s\n", "type", "N", "dofs", "L2 error", "rate", "time (ms)", "iterations");
+    std::vector<Run> runs[3];
+    for (int scheme = 0; scheme < 3; ++scheme) {
+        int N = coarsest;
+        for (int level = 0; level < levels; ++level, N = 2 * N - 1) {
+            MeshGenerator generator(1.0, 1.0, N, N);
+            Run run;
+            auto start = Clock::now();
+            if (scheme == 0) {
+                Mesh mesh = generator.generate();
+                std::vector<double> u = solver.solve(mesh, boundaryConditions);
+                run.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                run.dofs = mesh.nodeCount();
+                run.error = l2Error(mesh.x, mesh.y, mesh.connectivity, 3, u);
+            } else if (scheme == 1) {
+                StructuredMeshView grid = generator.view();
+                std::vector<double> u = solver.solve(grid, boundaryConditions);
+                run.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                run.dofs = grid.nodeCount();
+                run.error = l2ErrorBilinear(N, u);
+            } else {
+                QuadraticMesh mesh = generator.generateQuadratic();
+                std::vector<double> u = solver.solve(mesh, boundaryConditions);
+                run.milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                run.dofs = mesh.nodeCount();
+                run.error = l2Error(mesh.x, mesh.y, mesh.connectivity, 6, u);
+            }
+            double rate = runs[scheme].empty() ? 0.0 : std::log2(runs[scheme].back().error / run.error);
+            runs[scheme].push_back(run);
+            std::printf("%5s %6d %10zu %12.4e %8.2f %12.2f %10d\n", names[scheme], N, run.dofs, run.error,
+                        rate, run.milliseconds, solver.getReport().iterations);
+        }
+    }
+
+    // Cheapest run of each type that reaches a given accuracy
+    std::printf("\n%12s %22s %22s %22s\n", "L2 target", "P1 dofs / ms", "Q1 dofs / ms", "P2 dofs / ms");
+    for (double target : { 1e-2, 1e-3, 1e-4, 1e-5 }) {
+        std::string cells[3];
+        for (int scheme = 0; scheme < 3; ++scheme) {
+            cells[scheme] = "-";
+            for (const Run& run : runs[scheme]) {
+                if (run.error <= target) {
+                    char cell[64];
+                    std::snprintf(cell, sizeof(cell), "%zu / %.2f", run.dofs, run.milliseconds);
+                    cells[scheme] = cell;
+                    break;
+                }
+            }
+        }
+        std::printf("%12.0e %22s %22s %22s\n", target, cells[0].c_str(), cells[1].c_str(), cells[2].c_str());
+    }
+    return 0;
+}
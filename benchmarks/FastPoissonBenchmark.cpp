@@ -0,0 +1,89 @@
+// Fast Poisson benchmark: solve time of FastPoissonSolver against conjugate gradients on the
+// assembled matrix (SparseFEMSolver) and on the stencil operator (StencilSolver) for the
+// Poisson and Helmholtz presets on growing grids, with Dirichlet sides and with mixed
+// Dirichlet and Neumann sides. Grid sizes 2^k + 1 give power-of-two transforms; the others go
+// through the mixed-radix or Bluestein transforms. The "route" column is the choice of
+// FastPoissonSolver::isFasterThanIteration between the transforms and stencil CG.
+//
+// Usage: FastPoissonBenchmark [levels] [coarsest N]
+
+#include "FastPoissonSolver.h"
+#include "MeshGenerator.h"
+#include "SparseFEMSolver.h"
+#include "StencilSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <class Body>
+double millisecondsOnce(Body body) {
+    auto start = Clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double maxDifference(const std::vector<double>& a, const std::vector<double>& b) {
+    double difference = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i) difference = std::max(difference, std::abs(a[i] - b[i]));
+    return difference;
+}
+
+void runCase(const char* name, double c, bool mixed, int levels, int coarsest) {
+    auto constant = [](double value) -> CoefficientFunction { return [value](double, double) { return value; }; };
+    auto load = [](double x, double y) { return std::exp(-10.0 * ((x - 0.5) * (x - 0.5) + (y - 0.5) * (y - 0.5))); };
+    std::map<std::string, BoundaryConditionData> boundaryConditions;
+    BoundaryConditionData dirichlet, neumann;
+    dirichlet.type = "dirichlet";
+    neumann.type = "neumann";
+    neumann.value = 0.1;
+    boundaryConditions["west"] = boundaryConditions["south"] = dirichlet;
+    boundaryConditions["east"] = boundaryConditions["north"] = mixed ? neumann : dirichlet;
+
+    SparseFEMSolver sparseSolver(constant(1.0), nullptr, constant(1.0), nullptr, nullptr, constant(c), load);
+    StencilSolver stencilSolver(constant(1.0), nullptr, constant(1.0), nullptr, nullptr, constant(c), load);
+    FastPoissonSolver fastSolver(FastPoissonSolver::Coefficients{ 1.0, 1.0, c }, load);
+
+    std::printf("\n%s, %s sides\n", name, mixed ? "Dirichlet and Neumann" : "Dirichlet");
+    std::printf("%6s %10s %12s %12s %12s %9s %6s %12s %11s\n", "N", "nodes", "CSR CG", "stencil CG", "FFT", "speedup",
+                "route", "CG / FFT it", "|u - u_CG|");
+    int N = coarsest;
+    for (int level = 0; level < levels; ++level, N = 2 * N - 1) {
+        for (int size : { N, N + 6 }) {
+            MeshGenerator generator(1.0, 1.0, size, size);
+            Mesh mesh = generator.generate();
+            StructuredMeshView grid = generator.view();
+            std::vector<double> csr, stencil, fast;
+            double csrTime = millisecondsOnce([&]() { csr = sparseSolver.solve(mesh, boundaryConditions); });
+            double stencilTime = millisecondsOnce([&]() { stencil = stencilSolver.solve(grid, boundaryConditions); });
+            double fastTime = millisecondsOnce([&]() { fast = fastSolver.solve(grid, boundaryConditions); });
+            bool transforms = FastPoissonSolver::isFasterThanIteration(grid, FastPoissonSolver::Coefficients{ 1.0, 1.0, c },
+                                                                       boundaryConditions);
+            std::printf("%6d %10zu %12.2f %12.2f %12.2f %8.1fx %6s %7d / %-3d %11.2e\n", size, grid.nodeCount(), csrTime,
+                        stencilTime, fastTime, std::min(csrTime, stencilTime) / fastTime, transforms ? "FFT" : "CG",
+                        stencilSolver.getReport().iterations, fastSolver.getReport().iterations,
+                        maxDifference(fast, stencil));
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int levels = argc > 1 ? std::atoi(argv[1]) : 5;
+    int coarsest = argc > 2 ? std::atoi(argv[2]) : 33;
+
+    runCase("poisson", 0.0, false, levels, coarsest);
+    runCase("poisson", 0.0, true, levels, coarsest);
+    runCase("helmholtz", 1.0, false, levels, coarsest);
+    runCase("helmholtz", 1.0, true, levels, coarsest);
+    return 0;
+}
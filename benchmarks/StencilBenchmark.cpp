@@ -0,0 +1,131 @@
+// Stencil benchmark: the kernels of StencilOperator against the same operator in compressed
+// sparse row form (SparseFEMSolver on the generated mesh): operator application, residual,
+// damped Jacobi sweeps and a full conjugate gradient solve, for a variable diffusion
+// coefficient (per-node stencils) and for the Poisson preset (constant interior stencil).
+//
+// Usage: StencilBenchmark [N] [repetitions]
+
+#include "MeshGenerator.h"
+#include "SparseFEMSolver.h"
+#include "StencilSolver.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <class Body>
+double millisecondsPerRun(int repetitions, Body body) {
+    body(); // Warm-up
+    auto start = Clock::now();
+    for (int r = 0; r < repetitions; ++r) body();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repetitions;
+}
+
+template <class Body>
+double millisecondsOnce(Body body) {
+    auto start = Clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+void printRow(const char* name, double csr, double stencil) {
+    std::printf("%-22s %12.3f %12.3f %9.2fx\n", name, csr, stencil, csr / stencil);
+}
+
+void runCase(const char* name, const MeshGenerator& generator, int repetitions, CoefficientFunction diffusion) {
+    auto load = [](double x, double y) { return std::exp(-10.0 * ((x - 0.5) * (x - 0.5) + (y - 0.5) * (y - 0.5))); };
+    std::map<std::string, BoundaryConditionData> boundaryConditions;
+    BoundaryConditionData zero;
+    zero.type = "dirichlet";
+    for (const char* side : { "west", "east", "south", "north" }) boundaryConditions[side] = zero;
+
+    MeshGenerator meshGenerator = generator;
+    Mesh mesh = meshGenerator.generate();
+    StructuredMeshView grid = generator.view();
+    SparseFEMSolver sparseSolver(diffusion, nullptr, diffusion, nullptr, nullptr, nullptr, load);
+    StencilSolver stencilSolver(diffusion, nullptr, diffusion, nullptr, nullptr, nullptr, load);
+
+    // The same system in both forms, with the boundary conditions applied
+    std::pair<SparseMatrix, std::vector<double>> csr;
+    std::pair<StencilOperator, std::vector<double>> stencil;
+    double csrAssembly = millisecondsOnce([&]() { csr = sparseSolver.assemble(mesh); });
+    double stencilAssembly = millisecondsOnce([&]() { stencil = stencilSolver.assemble(grid); });
+    SparseMatrix& K = csr.first;
+    std::vector<double>& F = csr.second;
+    StencilOperator& A = stencil.first;
+    std::vector<double>& G = stencil.second;
+    std::vector<double> H(G.size(), 0.0);
+    auto dirichletNodes = stencilSolver.applyBoundaryConditions(grid, boundaryConditions, H);
+    K.applyDirichlet(dirichletNodes, F);
+    A.applyDirichlet(dirichletNodes, G);
+    bool constantInterior = A.detectConstantInterior();
+
+    const std::size_t n = grid.nodeCount();
+    std::vector<double> x(n), y(n), z(n);
+    for (std::size_t i = 0; i < n; ++i) x[i] = std::sin(0.001 * static_cast<double>(i));
+    K.multiply(x, y);
+    A.multiply(x, z);
+    double difference = 0.0, largest = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        difference = std::max(difference, std::abs(y[i] - z[i]));
+        largest = std::max(largest, std::abs(y[i]));
+    }
+
+    std::printf("\n%s: %s stencils, |A x (CSR) - A x (stencil)| / |A x| = %.2e\n", name,
+                constantInterior ? "constant interior" : "per-node", difference / largest);
+    std::printf("%-22s %12s %12s %10s\n", "kernel [ms]", "CSR", "stencil", "speedup");
+    printRow("assembly", csrAssembly, stencilAssembly);
+    printRow("A x", millisecondsPerRun(repetitions, [&]() { K.multiply(x, y); }),
+             millisecondsPerRun(repetitions, [&]() { A.multiply(x, z); }));
+    printRow("b - A x", millisecondsPerRun(repetitions, [&]() {
+                 K.multiply(x, y);
+                 for (std::size_t i = 0; i < n; ++i) y[i] = F[i] - y[i];
+             }),
+             millisecondsPerRun(repetitions, [&]() { A.residual(G, x, z); }));
+
+    // Smoothing, per sweep of a run of kSweeps
+    const int kSweeps = 10;
+    std::vector<double> inverseDiagonal = K.diagonal();
+    for (double& d : inverseDiagonal) d = 1.0 / d;
+    std::vector<double> u(n, 0.0), v(n, 0.0);
+    printRow("Jacobi sweep", millisecondsPerRun(repetitions, [&]() {
+                 for (int sweep = 0; sweep < kSweeps; ++sweep) {
+                     K.multiply(u, y);
+                     for (std::size_t i = 0; i < n; ++i) u[i] += 2.0 / 3.0 * (F[i] - y[i]) * inverseDiagonal[i];
+                 }
+             }) / kSweeps,
+             millisecondsPerRun(repetitions, [&]() { A.smooth(G, v, kSweeps); }) / kSweeps);
+
+    // Full solves, including assembly and boundary conditions
+    double csrSolve = millisecondsOnce([&]() { sparseSolver.solve(mesh, boundaryConditions); });
+    double stencilSolve = millisecondsOnce([&]() { stencilSolver.solve(grid, boundaryConditions); });
+    printRow("solve", csrSolve, stencilSolve);
+    std::printf("CG iterations: CSR %d, stencil %d\n", sparseSolver.getReport().iterations,
+                stencilSolver.getReport().iterations);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    int N = argc > 1 ? std::atoi(argv[1]) : 257;
+    int repetitions = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    MeshGenerator generator(1.0, 1.0, N, N);
+    std::printf("Grid: %d x %d nodes, %d repetitions\n", N, N, repetitions);
+    std::printf("Bytes per node: CSR %.1f, per-node stencil %.1f\n",
+                (7.0 * (sizeof(double) + sizeof(MeshIndex)) + sizeof(std::size_t)),
+                static_cast<double>(StencilOperator::DirectionCount * sizeof(double)));
+
+    runCase("variable diffusion", generator, repetitions,
+            [](double x, double y) { return 1.0 + 0.5 * std::sin(3.0 * x) * std::cos(2.0 * y); });
+    runCase("poisson", generator, repetitions, [](double, double) { return 1.0; });
+    return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef ADAPTIVESOLVER_H
+#define ADAPTIVESOLVER_H
+
+#include "Types.h"
+#include "ErrorEstimator.h"
+#include "MeshRefiner.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+class EllipticFEMSolver;
+
+// Adaptive solve-estimate-mark-refine loop: the mesh is refined by newest vertex bisection
+// where the error indicators are large (Dörfler marking) until the global estimate reaches
+// the target. The solver and the estimator are configured by the caller with the same problem.
+class AdaptiveSolver {
+public:
+    struct Options {
+        double targetError = 1e-2;    // Stop once the global estimate is at or below this
+        double theta = 0.5;           // Dörfler marking parameter in (0, 1]
+        std::size_t maxNodes = 4000;  // Do not refine beyond this many nodes (the solver is dense)
+        int maxIterations = 30;
+    };
+
+    // One pass of the loop
+    struct Step {
+        std::size_t nodes = 0;
+        std::size_t elements = 0;
+        double estimate = 0.0;
+        std::size_t markedElements = 0; // Zero on the last step
+        double solveMilliseconds = 0.0;
+        double estimateMilliseconds = 0.0;
+    };
+
+    struct Result {
+        Mesh mesh;                    // Final mesh
+        std::vector<double> solution; // Solution on the final mesh
+        std::vector<Step> history;
+        bool converged = false;       // The target was reached within the limits
+
+        std::string describe() const;
+    };
+
+    AdaptiveSolver(EllipticFEMSolver& solver, const ErrorEstimator& estimator);
+    ~AdaptiveSolver() = default;
+
+    void setOptions(const Options& options) { options_ = options; }
+    const Options& getOptions() const { return options_; }
+
+    // Solve adaptively starting from the initial mesh (relabelled with labelLongestEdges)
+    Result solve(const Mesh& initialMesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+private:
+    EllipticFEMSolver& solver_;
+    const ErrorEstimator& estimator_;
+    MeshRefiner refiner_;
+    Options options_;
+};
+
+#endif // ADAPTIVESOLVER_H
@@ -0,0 +1,65 @@
+#ifndef ALIGNEDALLOCATOR_H
+#define ALIGNEDALLOCATOR_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Standard allocator whose storage starts on an Alignment-byte boundary (a cache line by default),
+// so arrays of coordinates can be read with aligned vector loads.
+// Elements added by resize() are default-initialized, i.e. left uninitialized for numbers: a
+// pre-sized array is first touched by the threads that fill it, which places its pages on their
+// memory nodes. Write every element after resizing.
+template <class T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two no smaller than alignof(T)");
+
+    using value_type = T;
+
+    template <class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if (n > static_cast<std::size_t>(-1) / sizeof(T)) {
+            throw std::bad_array_new_length();
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    // Default- instead of value-initialize (no zero fill)
+    template <class U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(p)) U;
+    }
+
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+// Cache-line aligned array of doubles
+using AlignedDoubleVector = std::vector<double, AlignedAllocator<double>>;
+
+#endif // ALIGNEDALLOCATOR_H
@@ -0,0 +1,269 @@
+#ifndef ASSEMBLYKERNELS_H
+#define ASSEMBLYKERNELS_H
+
+#include "Types.h"
+#include "CoefficientProviders.h"
+#include "StructuredMeshView.h"
+#include "MeshCache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// Element matrix and load vector of a linear triangle
+struct LocalSystem {
+    double K[3][3];
+    double F[3];
+};
+
+// Number of elements whose centroid coefficients are evaluated together
+constexpr std::size_t kAssemblyBlockSize = 256;
+
+// Local system of a linear triangle for coefficient values taken at the centroid.
+// Includes diffusion, convection and reaction contributions and the load vector.
+inline void computeLocalSystem(
+    double x1, double y1, double x2, double y2, double x3, double y3,
+    double a11_val, double a12_val, double a22_val,
+    double b1_val, double b2_val, double c_val, double f_val,
+    bool hasConvection, LocalSystem& local
+) {
+    double area = 0.5 * std::abs((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1));
+    double detJ = 2.0 * area;
+
+    // Gradients of shape functions (dN/dx, dN/dy)
+    const double dN_dx[3] = { (y2 - y3) / detJ, (y3 - y1) / detJ, (y1 - y2) / detJ };
+    const double dN_dy[3] = { (x3 - x2) / detJ, (x1 - x3) / detJ, (x2 - x1) / detJ };
+
+    double a12_twice = a12_val * 2.0; // Factor of 2 for the mixed term
+
+    // Convection: integral of Ni * (b . grad(Nj)) = (area / 3) * (b . grad(Nj)), negligible fields are skipped
+    bool convects = hasConvection && !(std::abs(b1_val) < 1e-9 && std::abs(b2_val) < 1e-9);
+    double convection[3] = { 0.0, 0.0, 0.0 };
+    if (convects) {
+        for (int j = 0; j < 3; ++j) {
+            convection[j] = (area / 3.0) * (b1_val * dN_dx[j] + b2_val * dN_dy[j]);
+        }
+    }
+
+    // Reaction: c * area / 12 * [2 1 1; 1 2 1; 1 1 2]
+    double factor = c_val * area / 12.0;
+
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            double diffusion = area * (a11_val * dN_dx[i] * dN_dx[j] +
+                                       a12_twice * dN_dx[i] * dN_dy[j] +
+                                       a12_twice * dN_dy[i] * dN_dx[j] +
+                                       a22_val * dN_dy[i] * dN_dy[j]);
+            double reaction = (c_val != 0.0) ? ((i == j) ? 2.0 * factor : factor) : 0.0;
+            local.K[i][j] = diffusion + convection[j] + reaction;
+        }
+        local.F[i] = f_val * area / 3.0;
+    }
+}
+
+// Assembly on a uniformly spaced grid for operator coefficients that are zero or constant
+// (see hasUniformOperator). Every lower triangle {n1, n2, n3} and every upper triangle
+// {n2, n4, n3} of a cell then has the same element matrix, and the load vector is the load
+// at the centroid times the same reference vector. Both reference systems are computed once,
+// so the element loop only evaluates the load and scatters.
+template <class Coefficients>
+void assembleUniformGrid(
+    const StructuredMeshView& mesh,
+    const Coefficients& coeffs,
+    std::vector<std::vector<double>>& K_global,
+    std::vector<double>& F_global
+) {
+    const MeshIndex Nx = mesh.getNx();
+    const std::size_t cellsPerRow = static_cast<std::size_t>(mesh.getNx() - 1);
+    const double dx = mesh.node(1).first;
+    const double dy = mesh.node(Nx).second;
+
+    // Reference systems of the first cell, with a unit load
+    const double origin = 0.0;
+    const double a11 = coeffs.a11(origin, origin), a12 = coeffs.a12(origin, origin), a22 = coeffs.a22(origin, origin);
+    const double b1 = coeffs.b1(origin, origin), b2 = coeffs.b2(origin, origin), c = coeffs.c(origin, origin);
+    const bool hasConvection = !(IsZeroCoefficient<decltype(coeffs.b1)>::value && IsZeroCoefficient<decltype(coeffs.b2)>::value);
+    LocalSystem reference[2];
+    computeLocalSystem(0.0, 0.0, dx, 0.0, 0.0, dy, a11, a12, a22, b1, b2, c, 1.0, hasConvection, reference[0]);
+    computeLocalSystem(dx, 0.0, dx, dy, 0.0, dy, a11, a12, a22, b1, b2, c, 1.0, hasConvection, reference[1]);
+
+    // Centroid loads in blocks, as in assembleElements
+    const std::size_t nElements = mesh.elementCount();
+    double xc[kAssemblyBlockSize], yc[kAssemblyBlockSize], f[kAssemblyBlockSize];
+    for (std::size_t blockStart = 0; blockStart < nElements; blockStart += kAssemblyBlockSize) {
+        const std::size_t blockSize = std::min(kAssemblyBlockSize, nElements - blockStart);
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const std::size_t e = blockStart + k;
+            const std::size_t cell = e / 2;
+            const double offset = e % 2 == 0 ? 1.0 : 2.0; // In thirds of the cell
+            xc[k] = (3.0 * static_cast<double>(cell % cellsPerRow) + offset) * dx / 3.0;
+            yc[k] = (3.0 * static_cast<double>(cell / cellsPerRow) + offset) * dy / 3.0;
+        }
+        evaluateCoefficient(coeffs.f, xc, yc, f, blockSize);
+
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const std::size_t e = blockStart + k;
+            const LocalSystem& local = reference[e % 2];
+            const Element element = mesh.element(e);
+            for (int i = 0; i < 3; ++i) {
+                std::vector<double>& row = K_global[element[i]];
+                for (int j = 0; j < 3; ++j) {
+                    row[element[j]] += local.K[i][j];
+                }
+                F_global[element[i]] += f[k] * local.F[i];
+            }
+        }
+    }
+}
+
+// Assemble the global system for compile-time known coefficient providers.
+// Coefficients are evaluated at the centroids of a block of elements at a time, so pointwise
+// providers are inlined into a tight loop and batched providers are called once per block.
+// MeshType is Mesh, StructuredMeshView or MappedMesh; uniform grids with a constant operator
+// take assembleUniformGrid.
+template <class MeshType, class Coefficients>
+void assembleElements(
+    const MeshType& mesh,
+    const Coefficients& coeffs,
+    std::vector<std::vector<double>>& K_global,
+    std::vector<double>& F_global
+) {
+    if constexpr (std::is_same<MeshType, StructuredMeshView>::value && hasUniformOperator<Coefficients>()) {
+        if (mesh.isUniform()) {
+            assembleUniformGrid(mesh, coeffs, K_global, F_global);
+            return;
+        }
+    }
+
+    using B1 = decltype(coeffs.b1);
+    using B2 = decltype(coeffs.b2);
+    constexpr bool hasConvection = !(IsZeroCoefficient<B1>::value && IsZeroCoefficient<B2>::value);
+
+    const std::size_t nElements = mesh.elementCount();
+    double xc[kAssemblyBlockSize], yc[kAssemblyBlockSize];
+    double a11[kAssemblyBlockSize], a12[kAssemblyBlockSize], a22[kAssemblyBlockSize];
+    double b1[kAssemblyBlockSize], b2[kAssemblyBlockSize];
+    double c[kAssemblyBlockSize], f[kAssemblyBlockSize];
+
+    for (std::size_t blockStart = 0; blockStart < nElements; blockStart += kAssemblyBlockSize) {
+        const std::size_t blockSize = std::min(kAssemblyBlockSize, nElements - blockStart);
+
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const Element& element = mesh.element(blockStart + k);
+            const Node& p1 = mesh.node(element[0]);
+            const Node& p2 = mesh.node(element[1]);
+            const Node& p3 = mesh.node(element[2]);
+            xc[k] = (p1.first + p2.first + p3.first) / 3.0;
+            yc[k] = (p1.second + p2.second + p3.second) / 3.0;
+        }
+
+        evaluateCoefficient(coeffs.a11, xc, yc, a11, blockSize);
+        evaluateCoefficient(coeffs.a12, xc, yc, a12, blockSize);
+        evaluateCoefficient(coeffs.a22, xc, yc, a22, blockSize);
+        if (hasConvection) {
+            evaluateCoefficient(coeffs.b1, xc, yc, b1, blockSize);
+            evaluateCoefficient(coeffs.b2, xc, yc, b2, blockSize);
+        }
+        evaluateCoefficient(coeffs.c, xc, yc, c, blockSize);
+        evaluateCoefficient(coeffs.f, xc, yc, f, blockSize);
+
+        LocalSystem local;
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const Element& element = mesh.element(blockStart + k);
+            const Node& p1 = mesh.node(element[0]);
+            const Node& p2 = mesh.node(element[1]);
+            const Node& p3 = mesh.node(element[2]);
+
+            computeLocalSystem(
+                p1.first, p1.second, p2.first, p2.second, p3.first, p3.second,
+                a11[k], a12[k], a22[k],
+                hasConvection ? b1[k] : 0.0, hasConvection ? b2[k] : 0.0, c[k], f[k],
+                hasConvection, local
+            );
+
+            // Assemble into global matrix
+            for (int i = 0; i < 3; ++i) {
+                std::vector<double>& row = K_global[element[i]];
+                for (int j = 0; j < 3; ++j) {
+                    row[element[j]] += local.K[i][j];
+                }
+                F_global[element[i]] += local.F[i];
+            }
+        }
+    }
+}
+
+// Type-erased handle to an assembly routine; the coefficient types are erased once per
+// assembly instead of once per coefficient evaluation.
+class SystemAssembler {
+public:
+    virtual ~SystemAssembler() = default;
+
+    virtual void assemble(
+        const Mesh& mesh,
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global
+    ) const = 0;
+
+    virtual void assemble(
+        const StructuredMeshView& mesh,
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global
+    ) const = 0;
+
+    virtual void assemble(
+        const MappedMesh& mesh,
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global
+    ) const = 0;
+
+    // Whether the operator coefficients are zero or constant, so that uniform grids are
+    // assembled from reference element matrices (see assembleUniformGrid)
+    virtual bool hasUniformOperator() const { return false; }
+};
+
+template <class Coefficients>
+class StaticSystemAssembler : public SystemAssembler {
+public:
+    explicit StaticSystemAssembler(Coefficients coeffs) : coeffs_(std::move(coeffs)) {}
+
+    void assemble(
+        const Mesh& mesh,
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global
+    ) const override {
+        assembleElements(mesh, coeffs_, K_global, F_global);
+    }
+
+    void assemble(
+        const StructuredMeshView& mesh,
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global
+    ) const override {
+        assembleElements(mesh, coeffs_, K_global, F_global);
+    }
+
+    void assemble(
+        const MappedMesh& mesh,
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global
+    ) const override {
+        assembleElements(mesh, coeffs_, K_global, F_global);
+    }
+
+    bool hasUniformOperator() const override { return ::hasUniformOperator<Coefficients>(); }
+
+    const Coefficients& getCoefficients() const { return coeffs_; }
+
+private:
+    Coefficients coeffs_;
+};
+
+template <class Coefficients>
+inline std::shared_ptr<const SystemAssembler> makeSystemAssembler(Coefficients coeffs) {
+    return std::make_shared<StaticSystemAssembler<Coefficients>>(std::move(coeffs));
+}
+
+#endif // ASSEMBLYKERNELS_H
\ No newline at end of file
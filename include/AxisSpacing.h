@@ -0,0 +1,48 @@
+#ifndef AXISSPACING_H
+#define AXISSPACING_H
+
+#include <string>
+#include <vector>
+
+// Distribution of the grid lines along one axis of a structured mesh. Graded spacings put
+// small intervals next to the chosen boundary (or both) to resolve boundary layers.
+struct AxisSpacing {
+    enum class Kind {
+        Uniform,   // Equal intervals
+        Geometric, // Each interval `ratio` times the previous one, away from the boundary
+        Shishkin,  // Piecewise uniform: half of the intervals in a layer of width
+                   // min(length / 2, sigma * epsilon / beta * ln(intervals))
+        Tanh       // Hyperbolic tangent stretching of strength `delta`
+    };
+
+    // Boundary the grid lines cluster at: the start (x = 0 or y = 0), the end, or both
+    enum class Cluster { Start, End, Both };
+
+    Kind kind = Kind::Uniform;
+    Cluster cluster = Cluster::Start;
+    double ratio = 1.1;    // Geometric
+    double epsilon = 0.01; // Shishkin: diffusion coefficient
+    double beta = 1.0;     // Shishkin: lower bound of the convection speed
+    double sigma = 2.0;    // Shishkin: layer width factor (2 for linear elements)
+    double delta = 3.0;    // Tanh
+
+    static AxisSpacing uniform() { return AxisSpacing(); }
+    static AxisSpacing geometric(double ratio, Cluster cluster);
+    static AxisSpacing shishkin(double epsilon, double beta, Cluster cluster, double sigma = 2.0);
+    static AxisSpacing tanh(double delta, Cluster cluster);
+
+    bool isUniform() const { return kind == Kind::Uniform; }
+
+    bool operator==(const AxisSpacing& other) const {
+        return kind == other.kind && cluster == other.cluster && ratio == other.ratio && epsilon == other.epsilon &&
+               beta == other.beta && sigma == other.sigma && delta == other.delta;
+    }
+    bool operator!=(const AxisSpacing& other) const { return !(*this == other); }
+
+    // Increasing coordinates of `nodes` grid lines from 0 to length (both exact)
+    std::vector<double> coordinates(double length, int nodes) const;
+
+    std::string describe() const;
+};
+
+#endif // AXISSPACING_H
@@ -0,0 +1,250 @@
+#ifndef BOUNDARYVALUECACHE_H
+#define BOUNDARYVALUECACHE_H
+
+#include "Types.h"
+#include "FunctionParser.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Cache of boundary values keyed by (mesh id, boundary name, expression source).
+// Each entry holds the expression evaluated at the boundary nodes, in boundary node order,
+// so repeated solves on the same mesh skip re-evaluating long perimeters.
+class BoundaryValueCache {
+public:
+    explicit BoundaryValueCache(std::size_t maxEntries = 64);
+    ~BoundaryValueCache() = default;
+
+    // Values of the expression at the given boundary nodes (evaluated on first request).
+    // Meshes without an id are evaluated but not cached.
+    // MeshType is Mesh, StructuredMeshView or MappedMesh.
+    template <class MeshType, class NodeRange>
+    std::shared_ptr<const std::vector<double>> getValues(
+        const MeshType& mesh,
+        const std::string& boundaryName,
+        const NodeRange& boundaryNodes,
+        const CompiledExpression& expression
+    ) {
+        if (mesh.id == 0) {
+            auto values = std::make_shared<std::vector<double>>();
+            evaluate(mesh, boundaryNodes, expression, *values);
+            return values;
+        }
+
+        Key key{ mesh.id, boundaryName, expression.source() };
+        if (auto cached = lookup(key)) {
+            return cached;
+        }
+
+        // Evaluate outside the lock; a concurrent miss on the same key only duplicates work
+        auto values = std::make_shared<std::vector<double>>();
+        evaluate(mesh, boundaryNodes, expression, *values);
+        store(key, values);
+        return values;
+    }
+
+    // Evaluate an expression at boundary nodes in one batched pass
+    template <class MeshType, class NodeRange>
+    static void evaluate(
+        const MeshType& mesh,
+        const NodeRange& boundaryNodes,
+        const CompiledExpression& expression,
+        std::vector<double>& values
+    ) {
+        const std::size_t n = boundaryNodes.size();
+        values.resize(n);
+
+        if (expression.isConstant()) {
+            std::fill(values.begin(), values.end(), expression.constantValue());
+            return;
+        }
+
+        // Gather the boundary coordinates into contiguous arrays for the batched evaluator
+        std::vector<double> xs(n), ys(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            const Node& node = mesh.node(boundaryNodes[k]);
+            xs[k] = node.first;
+            ys[k] = node.second;
+        }
+        expression.evaluate(xs.data(), ys.data(), values.data(), n);
+    }
+
+    // Drop all entries
+    void clear();
+
+    // Getters
+    std::size_t size() const;
+    std::size_t getHits() const { std::lock_guard<std::mutex> lock(mutex_); return hits_; }
+    std::size_t getMisses() const { std::lock_guard<std::mutex> lock(mutex_); return misses_; }
+
+private:
+    struct Key {
+        std::uint64_t meshId;
+        std::string boundary;
+        std::string expression;
+
+        bool operator<(const Key& other) const {
+            if (meshId != other.meshId) return meshId < other.meshId;
+            if (boundary != other.boundary) return boundary < other.boundary;
+            return expression < other.expression;
+        }
+    };
+
+    struct Entry {
+        std::shared_ptr<const std::vector<double>> values;
+        std::uint64_t lastUse;
+    };
+
+    // Cached values for the key, counting a hit or a miss
+    std::shared_ptr<const std::vector<double>> lookup(const Key& key);
+
+    // Insert values, evicting the least recently used entry when full
+    void store(const Key& key, std::shared_ptr<const std::vector<double>> values);
+
+    std::size_t maxEntries_;
+    std::map<Key, Entry> entries_;
+    std::uint64_t useCounter_ = 0;
+    std::size_t hits_ = 0, misses_ = 0;
+    mutable std::mutex mutex_;
+};
+
+// Values of a boundary condition at points, from the first source that is set (see BoundaryConditionData)
+inline void evaluateBoundaryCondition(
+    const BoundaryConditionData& bcData, const double* x, const double* y, double* out, std::size_t n
+) {
+    if (bcData.expression) {
+        bcData.expression->evaluate(x, y, out, n);
+    } else if (bcData.batch_func) {
+        bcData.batch_func(x, y, out, n);
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = bcData.value_func ? bcData.value_func(x[i], y[i]) : bcData.value;
+        }
+    }
+}
+
+// Values of a boundary condition at its boundary nodes, in boundary node order. Expression
+// values are looked up in the cache when one is given.
+template <class MeshType, class NodeRange>
+std::shared_ptr<const std::vector<double>> boundaryConditionValues(
+    const BoundaryConditionData& bcData,
+    const MeshType& mesh,
+    const std::string& boundaryName,
+    const NodeRange& boundaryNodes,
+    BoundaryValueCache* cache = nullptr
+) {
+    const std::size_t n = boundaryNodes.size();
+
+    if (bcData.expression) {
+        if (cache) {
+            return cache->getValues(mesh, boundaryName, boundaryNodes, *bcData.expression);
+        }
+        auto values = std::make_shared<std::vector<double>>();
+        BoundaryValueCache::evaluate(mesh, boundaryNodes, *bcData.expression, *values);
+        return values;
+    }
+
+    auto values = std::make_shared<std::vector<double>>(n, bcData.value);
+    if (bcData.batch_func) {
+        std::vector<double> xs(n), ys(n);
+        for (std::size_t k = 0; k < n; ++k) {
+            const Node& node = mesh.node(boundaryNodes[k]);
+            xs[k] = node.first;
+            ys[k] = node.second;
+        }
+        bcData.batch_func(xs.data(), ys.data(), values->data(), n);
+    } else if (bcData.value_func) {
+        for (std::size_t k = 0; k < n; ++k) {
+            const Node& node = mesh.node(boundaryNodes[k]);
+            (*values)[k] = bcData.value_func(node.first, node.second);
+        }
+    }
+    return values;
+}
+
+// A Dirichlet or Neumann condition resolved on a mesh: its boundary tag bit, its boundary (a
+// pointer into Mesh or a computed range of StructuredMeshView) and its values at the boundary
+// nodes. The values are held per boundary node in the ascending order of the boundary set, so
+// no array over all mesh nodes is needed.
+template <class MeshType>
+struct ResolvedBoundaryCondition {
+    using BoundaryHandle = decltype(std::declval<const MeshType&>().findBoundary(std::string()));
+
+    std::uint32_t mask;
+    bool dirichlet;
+    BoundaryHandle boundary;
+    std::shared_ptr<const std::vector<double>> values;
+};
+
+// Resolve every Dirichlet and Neumann condition once, in name order; conditions on boundaries
+// the mesh does not have are skipped
+template <class MeshType>
+std::vector<ResolvedBoundaryCondition<MeshType>> resolveBoundaryConditions(
+    const MeshType& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+    BoundaryValueCache* cache = nullptr
+) {
+    std::vector<ResolvedBoundaryCondition<MeshType>> resolved;
+    resolved.reserve(boundaryConditions.size());
+    for (const auto& pair : boundaryConditions) {
+        const BoundaryConditionData& bcData = pair.second;
+        bool dirichlet = bcData.type == "dirichlet";
+        if (!dirichlet && bcData.type != "neumann") continue;
+
+        int bit = mesh.boundaryTagBit(pair.first);
+        if (bit < 0) continue;
+        auto boundary = mesh.findBoundary(pair.first);
+        if (!boundary) continue;
+
+        auto values = boundaryConditionValues(bcData, mesh, pair.first, *boundary, cache);
+        resolved.push_back({ 1u << bit, dirichlet, std::move(boundary), std::move(values) });
+    }
+    return resolved;
+}
+
+// One pass over the node tags with a cursor into the values of every resolved condition.
+// visit(node, dirichlet, dirichletValue, neumannValues) is called in ascending node order for
+// every node on a boundary with a condition. At a node on several boundaries the conditions are
+// visited in name order: the last Dirichlet value wins, and Dirichlet takes precedence over
+// Neumann, so callers ignore neumannValues at Dirichlet nodes.
+template <class MeshType, class Visit>
+void forEachBoundaryConditionNode(
+    const MeshType& mesh,
+    const std::vector<ResolvedBoundaryCondition<MeshType>>& resolved,
+    Visit visit
+) {
+    std::uint32_t conditionMask = 0;
+    for (const auto& condition : resolved) conditionMask |= condition.mask;
+
+    std::vector<std::size_t> next(resolved.size(), 0);
+    std::vector<double> neumannValues;
+    const std::size_t n = mesh.nodeCount();
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint32_t tags = mesh.boundaryTag(i) & conditionMask;
+        if (tags == 0) continue;
+
+        bool dirichlet = false;
+        double dirichletValue = 0.0;
+        neumannValues.clear();
+        for (std::size_t c = 0; c < resolved.size(); ++c) {
+            const auto& condition = resolved[c];
+            if (!(tags & condition.mask) || next[c] >= condition.values->size()) continue;
+            double value = (*condition.values)[next[c]++];
+            if (condition.dirichlet) {
+                dirichlet = true;
+                dirichletValue = value;
+            } else {
+                neumannValues.push_back(value);
+            }
+        }
+        visit(static_cast<MeshIndex>(i), dirichlet, dirichletValue, neumannValues);
+    }
+}
+
+#endif // BOUNDARYVALUECACHE_H
\ No newline at end of file
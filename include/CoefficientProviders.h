@@ -0,0 +1,113 @@
+#ifndef COEFFICIENTPROVIDERS_H
+#define COEFFICIENTPROVIDERS_H
+
+#include "Types.h"
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+// Coefficient providers for the templated assembly path.
+// A provider is any copyable type callable as double(double x, double y) const; providers that
+// also expose evaluate(const double* x, const double* y, double* out, size_t n) const are used in
+// batched form. Lambdas and the types below can be mixed freely in a CoefficientSet.
+
+// Compile-time zero (lets the assembly drop the corresponding term entirely)
+struct ZeroCoefficient {
+    double operator()(double, double) const { return 0.0; }
+};
+
+// Value that is constant over the whole domain
+struct ConstantCoefficient {
+    double value;
+    double operator()(double, double) const { return value; }
+};
+
+// Type-erased pointwise fallback
+struct FunctionCoefficient {
+    CoefficientFunction func;
+    double operator()(double x, double y) const { return func(x, y); }
+};
+
+// Type-erased batched fallback (one indirect call per block of points)
+struct BatchFunctionCoefficient {
+    BatchCoefficientFunction func;
+    double operator()(double x, double y) const {
+        double value;
+        func(&x, &y, &value, 1);
+        return value;
+    }
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const { func(x, y, out, n); }
+};
+
+// Provider traits
+template <class T, class = void>
+struct IsBatchCoefficient : std::false_type {};
+
+template <class T>
+struct IsBatchCoefficient<T, std::void_t<decltype(std::declval<const T&>().evaluate(
+    static_cast<const double*>(nullptr), static_cast<const double*>(nullptr), static_cast<double*>(nullptr), std::size_t(0)))>>
+    : std::true_type {};
+
+template <class T>
+struct IsZeroCoefficient : std::is_same<T, ZeroCoefficient> {};
+
+// Zero or constant, known from the provider type
+template <class T>
+struct IsUniformCoefficient : std::integral_constant<bool,
+    IsZeroCoefficient<T>::value || std::is_same<T, ConstantCoefficient>::value> {};
+
+// Evaluate a provider at n points
+template <class Provider>
+inline void evaluateCoefficient(const Provider& provider, const double* x, const double* y, double* out, std::size_t n) {
+    if constexpr (IsZeroCoefficient<Provider>::value) {
+        std::fill(out, out + n, 0.0);
+    } else if constexpr (std::is_same<Provider, ConstantCoefficient>::value) {
+        std::fill(out, out + n, provider.value);
+    } else if constexpr (IsBatchCoefficient<Provider>::value) {
+        provider.evaluate(x, y, out, n);
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = provider(x[i], y[i]);
+        }
+    }
+}
+
+// Convert any provider to the type-erased pointwise form
+template <class Provider>
+inline CoefficientFunction toCoefficientFunction(const Provider& provider) {
+    return [provider](double x, double y) -> double { return provider(x, y); };
+}
+
+// The seven coefficients of -div(A grad u) + b.grad u + c u = f
+template <class A11, class A12, class A22, class B1, class B2, class C, class F>
+struct CoefficientSet {
+    A11 a11;
+    A12 a12;
+    A22 a22;
+    B1 b1;
+    B2 b2;
+    C c;
+    F f;
+};
+
+template <class A11, class A12, class A22, class B1, class B2, class C, class F>
+inline CoefficientSet<A11, A12, A22, B1, B2, C, F> makeCoefficientSet(A11 a11, A12 a12, A22 a22, B1 b1, B2 b2, C c, F f) {
+    return { std::move(a11), std::move(a12), std::move(a22), std::move(b1), std::move(b2), std::move(c), std::move(f) };
+}
+
+// Whether the operator coefficients (all but the load) of a set are zero or constant
+template <class Coefficients>
+constexpr bool hasUniformOperator() {
+    return IsUniformCoefficient<decltype(Coefficients::a11)>::value && IsUniformCoefficient<decltype(Coefficients::a12)>::value &&
+           IsUniformCoefficient<decltype(Coefficients::a22)>::value && IsUniformCoefficient<decltype(Coefficients::b1)>::value &&
+           IsUniformCoefficient<decltype(Coefficients::b2)>::value && IsUniformCoefficient<decltype(Coefficients::c)>::value;
+}
+
+// Fully type-erased set used when coefficients are only known at run time
+using DynamicCoefficientSet = CoefficientSet<
+    BatchFunctionCoefficient, BatchFunctionCoefficient, BatchFunctionCoefficient,
+    BatchFunctionCoefficient, BatchFunctionCoefficient,
+    BatchFunctionCoefficient, BatchFunctionCoefficient>;
+
+#endif // COEFFICIENTPROVIDERS_H
\ No newline at end of file
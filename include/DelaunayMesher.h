@@ -0,0 +1,72 @@
+#ifndef DELAUNAYMESHER_H
+#define DELAUNAYMESHER_H
+
+#include "Types.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Polygonal domain: one outer boundary loop and any number of hole loops. Every edge of a loop
+// (point k to point k + 1, the last one closing the loop) carries the name of the boundary it
+// belongs to; the names become the boundaries of the generated mesh.
+struct PolygonalDomain {
+    struct Loop {
+        std::vector<Node> points;
+        std::vector<std::string> edgeNames; // One per edge, or empty to use a single name
+    };
+
+    Loop outer;
+    std::vector<Loop> holes;
+
+    // Loop with one name for every edge
+    static Loop loop(const std::vector<Node>& points, const std::string& name);
+
+    // [0,Lx] x [0,Ly] with the west, east, south and north boundaries of MeshGenerator
+    static PolygonalDomain rectangle(double Lx, double Ly);
+    // [0,Lx] x [0,Ly] without the corner (cx,Lx] x (cy,Ly]; the re-entrant edges are "corner"
+    static PolygonalDomain lShape(double Lx, double Ly, double cx, double cy);
+
+    // Add a polygonal hole approximating a circle, with `segments` edges named `name`
+    void addCircularHole(double cx, double cy, double radius, int segments, const std::string& name = "hole");
+};
+
+// Constrained Delaunay triangulation of a PolygonalDomain with Ruppert quality refinement.
+// Points are inserted in Hilbert curve order by Bowyer-Watson, the boundary edges are recovered
+// by edge flips, triangles outside the domain and inside holes are removed, and then triangles
+// that are too large or have too small angles get their circumcenter inserted (boundary edges
+// encroached by a new point are split instead).
+class DelaunayMesher {
+public:
+    struct Options {
+        double minAngleDegrees = 20.0; // Quality bound, 0 to disable (above ~33 may not terminate)
+        double maxArea = 0.0;          // Largest triangle area, 0 for no limit
+        // Target edge length at a point; triangles with a longer edge are refined (null: none)
+        std::function<double(double, double)> sizeFunction;
+        std::size_t maxSteinerPoints = 10000000; // Refinement stops after this many new points
+    };
+
+    struct Statistics {
+        std::size_t inputPoints = 0;
+        std::size_t steinerPoints = 0; // Points added by refinement
+        std::size_t triangles = 0;
+        std::size_t flips = 0;         // Edge flips of the boundary recovery
+        double minAngleDegrees = 0.0;  // Smallest angle of the result
+        double milliseconds = 0.0;
+    };
+
+    DelaunayMesher();
+    explicit DelaunayMesher(const Options& options);
+    ~DelaunayMesher() = default;
+
+    Mesh generate(const PolygonalDomain& domain);
+
+    const Statistics& getStatistics() const { return statistics_; }
+
+private:
+    Options options_;
+    Statistics statistics_;
+};
+
+#endif // DELAUNAYMESHER_H
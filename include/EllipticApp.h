@@ -2,17 +2,24 @@
 #define ELLIPTICAPP_H
 
 #include "Types.h"
+#include "AssemblyKernels.h"
+#include "AxisSpacing.h"
+#include "FastPoissonSolver.h"
+#include "MeshCache.h"
 #include <string>
 #include <memory>
 #include <vector>
 #include <map>
 #include <functional>
+#include <optional>
 
 // Forward declarations
 class MeshGenerator;
 class EllipticFEMSolver;
 class Visualizer;
 class GUIApp;
+class BoundaryValueCache;
+struct QuantityOfInterest;
 
 class EllipticApp {
 public:
@@ -22,12 +29,27 @@ public:
     // Run the application (with or without GUI)
     int run(bool useGUI = true);
 
-    // Generate mesh
+    // Generate mesh (the current mesh is kept if it was generated with the same parameters)
     void generateMesh();
 
+    // Use a mesh read from a Gmsh .msh file or a mesh cache file instead of a generated one.
+    // Cache files stay memory-mapped: linear solves, plots and reports read the mapping.
+    void loadMesh(const std::string& filename);
+
+    // Write the current mesh to a mesh cache file for later runs (see MeshCache)
+    void saveMeshCache(const std::string& filename) const;
+
     // Solve the problem
     void solveProblem();
 
+    // Solve with adaptive refinement of the current mesh until the a posteriori error estimate
+    // is at most targetError; the refined mesh becomes the current mesh
+    void solveAdaptively(double targetError);
+
+    // Solve with goal-oriented refinement until the estimated error of the quantity is at most
+    // targetError; returns the quantity, and the refined mesh becomes the current mesh
+    double solveForQuantity(const QuantityOfInterest& quantity, double targetError);
+
     // Plot the solution
     void plotSolution();
 
@@ -40,10 +62,27 @@ public:
     // Set problem parameters
     void setDimensions(double Lx, double Ly) { Lx_ = Lx; Ly_ = Ly; }
     void setNodeCount(int Nx, int Ny) { Nx_ = Nx; Ny_ = Ny; }
+    // Grid line distribution of generated meshes, e.g. Shishkin spacing for a boundary layer
+    void setMeshSpacing(const AxisSpacing& xSpacing, const AxisSpacing& ySpacing) { xSpacing_ = xSpacing; ySpacing_ = ySpacing; }
     void setCoefficientFunctions(
         CoefficientFunction a11, CoefficientFunction a12, CoefficientFunction a22,
         CoefficientFunction b1, CoefficientFunction b2, CoefficientFunction c, CoefficientFunction f
     );
+    // Set coefficients known at compile time; assembly is instantiated for the provider types
+    template <class Coefficients>
+    void setStaticCoefficients(const Coefficients& coeffs) {
+        a11_func_ = toCoefficientFunction(coeffs.a11);
+        a12_func_ = toCoefficientFunction(coeffs.a12);
+        a22_func_ = toCoefficientFunction(coeffs.a22);
+        b1_func_ = toCoefficientFunction(coeffs.b1);
+        b2_func_ = toCoefficientFunction(coeffs.b2);
+        c_func_ = toCoefficientFunction(coeffs.c);
+        f_func_ = toCoefficientFunction(coeffs.f);
+        staticAssembler_ = makeSystemAssembler(coeffs);
+        constantOperator_ = FastPoissonSolver::fromStatic(coeffs);
+        batchCoefficients_.reset();
+        operatorIsSPD_ = false;
+    }
     void setBoundaryConditions(const std::map<std::string, BoundaryConditionData>& bc) {
         boundaryConditions_ = bc;
     }
@@ -65,7 +104,20 @@ public:
 
     // Get solution data for visualization
     const std::vector<double>& getSolution() const { return currentSolution_; }
-    const Mesh& getMesh() const { return *currentMesh_; }
+    // Mesh of the solution: the current mesh, or its subdivision into linear triangles at the
+    // P2 nodes after a quadratic solve. A memory-mapped mesh is copied on the first call.
+    const Mesh& getMesh() const { return *getSharedMesh(); }
+    // The solution mesh, shared rather than copied by holders of the solution
+    std::shared_ptr<const Mesh> getSharedMesh() const { return solutionMesh_ ? solutionMesh_ : explicitMesh(); }
+
+    // Element order of solveProblem: 1 for linear triangles, 2 for quadratic (P2) triangles
+    // solved with sparse assembly (see SparseFEMSolver)
+    void setElementOrder(int order);
+    int getElementOrder() const { return elementOrder_; }
+    // Solve order 1 with bilinear quadrilaterals on the grid cells instead of linear triangles.
+    // Needs a generated mesh; the solution lives on its nodes.
+    void setQuadrilateralElements(bool enabled) { quadrilateralElements_ = enabled; }
+    bool usesQuadrilateralElements() const { return quadrilateralElements_ && elementOrder_ == 1; }
 
 private:
     // Private members for the application
@@ -75,20 +127,71 @@ private:
     std::unique_ptr<GUIApp> guiApp_; // Optional GUI
 
     // Current solution
-    std::unique_ptr<Mesh> currentMesh_;
+    std::shared_ptr<const Mesh> currentMesh_;
     std::vector<double> currentSolution_;
+    std::shared_ptr<const Mesh> solutionMesh_; // Set by the solves, see getMesh
+    // Mesh cache file loaded by loadMesh, used in place of currentMesh_ (which is then empty)
+    std::optional<MappedMesh> mappedMesh_;
+    mutable std::shared_ptr<const Mesh> mappedMeshCopy_; // See explicitMesh
+    int elementOrder_ = 1;
+    bool quadrilateralElements_ = false;
+
+    // Generator parameters of the current mesh (empty for loaded meshes). While they are unchanged
+    // the mesh is reused, together with its adjacency and the solver data keyed by its id.
+    struct MeshKey {
+        double Lx, Ly;
+        int Nx, Ny;
+        AxisSpacing xSpacing, ySpacing;
+
+        bool operator==(const MeshKey& other) const {
+            return Lx == other.Lx && Ly == other.Ly && Nx == other.Nx && Ny == other.Ny &&
+                   xSpacing == other.xSpacing && ySpacing == other.ySpacing;
+        }
+    };
+    std::optional<MeshKey> currentMeshKey_;
+    // Grid view of the current mesh, created with it so that grid solves keep one id for the
+    // boundary value cache (empty for loaded and refined meshes)
+    std::optional<StructuredMeshView> currentGrid_;
 
     // Problem parameters
     double Lx_, Ly_;
     int Nx_, Ny_;
+    AxisSpacing xSpacing_, ySpacing_;
 
     // Coefficient functions
     CoefficientFunction a11_func_, a12_func_, a22_func_;
     CoefficientFunction b1_func_, b2_func_, c_func_, f_func_;
 
+    // Batched evaluation of the coefficients compiled in solveWithParameters, used by the
+    // assembly in place of point-by-point calls of the functions above
+    struct BatchCoefficients {
+        BatchCoefficientFunction a11, a12, a22, b1, b2, c, f;
+    };
+    std::optional<BatchCoefficients> batchCoefficients_;
+
+    // Assembly instantiated for statically known coefficients (null when they come from strings)
+    std::shared_ptr<const SystemAssembler> staticAssembler_;
+
+    // Set when a11, a22 and c are constant and a12, b1 and b2 zero, so that generated uniform
+    // meshes with Dirichlet and Neumann sides go to FastPoissonSolver
+    std::optional<FastPoissonSolver::Coefficients> constantOperator_;
+
+    // Set when OperatorAnalyzer proved the operator SPD, so the solver may use Cholesky
+    bool operatorIsSPD_;
+
     // Boundary conditions
     std::map<std::string, BoundaryConditionData> boundaryConditions_;
 
+    // Expression boundary values reused across solves on the same mesh
+    std::shared_ptr<BoundaryValueCache> boundaryCache_;
+
+    // Pass the current coefficients and solver choices on to femSolver_
+    void configureSolver();
+    bool hasMesh() const { return currentMesh_ || mappedMesh_; }
+    // The current mesh as a Mesh, for the paths that need one (quadratic elements, refinement,
+    // GUI renderers); a mapped mesh is copied once on first use
+    std::shared_ptr<const Mesh> explicitMesh() const;
+
     // Setup functions for different problem types
     void setupLaplaceProblem();
     void setupPoissonProblem();
@@ -2,12 +2,23 @@
 #define ELLIPTICFEMSOLVER_H
 
 #include "Types.h"
+#include "AssemblyKernels.h"
+#include "BoundaryValueCache.h"
+#include "StructuredMeshView.h"
+#include "MeshCache.h"
+#include "MeshRenumbering.h"
 #include <vector>
 #include <map>
 #include <memory>
 
 class EllipticFEMSolver {
 public:
+    // Dense direct solvers for the assembled system
+    enum class LinearSolver {
+        GaussianElimination, // Any nonsingular system
+        Cholesky             // Symmetric positive definite systems (see OperatorAnalyzer)
+    };
+
     EllipticFEMSolver(
         CoefficientFunction a11_func = nullptr,
         CoefficientFunction a12_func = nullptr,
@@ -19,12 +30,65 @@ public:
     );
     ~EllipticFEMSolver() = default;
 
+    // Replace coefficients with batched evaluators (e.g. tabulated grids); null entries are left unchanged
+    void setBatchCoefficients(
+        BatchCoefficientFunction a11_func, BatchCoefficientFunction a12_func, BatchCoefficientFunction a22_func,
+        BatchCoefficientFunction b1_func, BatchCoefficientFunction b2_func,
+        BatchCoefficientFunction c_func, BatchCoefficientFunction f_func
+    );
+
+    // Use a prebuilt (typically templated, see makeSystemAssembler) assembly routine instead of
+    // the coefficient functions; pass nullptr to go back to the coefficient functions
+    void setAssembler(std::shared_ptr<const SystemAssembler> assembler) { assembler_ = std::move(assembler); }
+
+    // Share a cache of expression boundary values across solves (optional)
+    void setBoundaryValueCache(std::shared_ptr<BoundaryValueCache> cache) { boundaryCache_ = std::move(cache); }
+
+    // Select the linear solver; Cholesky falls back to Gaussian elimination if a pivot is not positive
+    void setLinearSolver(LinearSolver solver) { linearSolver_ = solver; }
+    LinearSolver getLinearSolver() const { return linearSolver_; }
+
+    // Renumber the nodes of a Mesh before solving (results stay in the mesh's own order).
+    // Cholesky works within the matrix profile, so reverse Cuthill-McKee pays off there.
+    void setNodeOrdering(NodeOrdering ordering) {
+        if (ordering != nodeOrdering_) renumberedMesh_.reset();
+        nodeOrdering_ = ordering;
+    }
+    NodeOrdering getNodeOrdering() const { return nodeOrdering_; }
+    // Bandwidth and profile of the last renumbering
+    const RenumberingReport& getRenumberingReport() const { return renumberingReport_; }
+
+    // Wrap a pointwise coefficient as a batched one (null becomes the zero function)
+    static BatchCoefficientFunction toBatchFunction(CoefficientFunction func);
+
     // Solve the elliptic equation with given mesh and boundary conditions
     std::vector<double> solve(const Mesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+    std::vector<double> solve(const StructuredMeshView& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+    std::vector<double> solve(const MappedMesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+    // Solve the discrete adjoint problem: the transposed system matrix (before boundary
+    // conditions) with the given load, then the boundary conditions imposed as in solve()
+    std::vector<double> solveAdjoint(
+        const Mesh& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+        const std::vector<double>& load
+    );
+
+    // Residual K u - F of the system with the Neumann loads but without Dirichlet conditions:
+    // zero at the free nodes for a solution, the consistent boundary flux at Dirichlet nodes
+    std::vector<double> residual(
+        const Mesh& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+        const std::vector<double>& solution
+    );
 
     // Assemble global matrix and vector
     std::pair<std::vector<std::vector<double>>, std::vector<double>>
     assembleGlobalMatrix(const Mesh& mesh);
+    std::pair<std::vector<std::vector<double>>, std::vector<double>>
+    assembleGlobalMatrix(const StructuredMeshView& mesh);
+    std::pair<std::vector<std::vector<double>>, std::vector<double>>
+    assembleGlobalMatrix(const MappedMesh& mesh);
 
     // Apply boundary conditions to the global system
     void applyBoundaryConditions(
@@ -33,24 +97,82 @@ public:
         const Mesh& mesh,
         const std::map<std::string, BoundaryConditionData>& boundaryConditions
     );
+    void applyBoundaryConditions(
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global,
+        const StructuredMeshView& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    );
+    void applyBoundaryConditions(
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global,
+        const MappedMesh& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    );
 
 private:
-    // Local element matrices
-    std::vector<std::vector<double>> localEllipticMatrix(const std::vector<Node>& coords);
-    std::vector<std::vector<double>> localConvectionMatrix(const std::vector<Node>& coords);
-    std::vector<std::vector<double>> localReactionMatrix(const std::vector<Node>& coords);
-    std::vector<double> localLoadVector(const std::vector<Node>& coords);
+    // Implementations shared by the mesh types (Mesh, StructuredMeshView, MappedMesh)
+    template <class MeshType>
+    std::vector<double> solveOn(const MeshType& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+    template <class MeshType>
+    std::pair<std::vector<std::vector<double>>, std::vector<double>> assembleOn(const MeshType& mesh);
+
+    std::vector<double> solveAdjointOn(
+        const Mesh& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+        const std::vector<double>& load
+    );
+
+    // Renumbered copy of a mesh, reused while the same mesh is solved again
+    const Mesh& renumbered(const Mesh& mesh);
+
+    // Solve an assembled system with the selected linear solver
+    std::vector<double> solveSystem(
+        const std::vector<std::vector<double>>& K_global,
+        const std::vector<double>& F_global
+    );
+
+    template <class MeshType>
+    void applyBoundaryConditionsOn(
+        std::vector<std::vector<double>>& K_global,
+        std::vector<double>& F_global,
+        const MeshType& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    );
+
+    // Coefficient functions (always stored in batched form)
+    BatchCoefficientFunction a11_func_, a12_func_, a22_func_;
+    BatchCoefficientFunction b1_func_, b2_func_;
+    BatchCoefficientFunction c_func_, f_func_;
+
+    // Optional assembly routine that replaces the coefficient functions
+    std::shared_ptr<const SystemAssembler> assembler_;
 
-    // Coefficient functions
-    CoefficientFunction a11_func_, a12_func_, a22_func_;
-    CoefficientFunction b1_func_, b2_func_;
-    CoefficientFunction c_func_, f_func_;
+    // Optional cache for expression boundary values
+    std::shared_ptr<BoundaryValueCache> boundaryCache_;
+
+    LinearSolver linearSolver_ = LinearSolver::GaussianElimination;
+
+    // Node renumbering, with the renumbered copy of the last mesh solved
+    NodeOrdering nodeOrdering_ = NodeOrdering::Original;
+    std::shared_ptr<const Mesh> renumberedMesh_;
+    std::uint64_t renumberedSourceId_ = 0;
+    MeshPermutation permutation_;
+    RenumberingReport renumberingReport_;
 
     // Helper function for solving linear systems
     std::vector<double> solveLinearSystem(
         const std::vector<std::vector<double>>& A,
         const std::vector<double>& b
     );
+
+    // Cholesky factorization and substitution; returns false if the matrix is not positive definite
+    static bool solveCholesky(
+        const std::vector<std::vector<double>>& A,
+        const std::vector<double>& b,
+        std::vector<double>& x
+    );
 };
 
 #endif // ELLIPTICFEMSOLVER_H
\ No newline at end of file
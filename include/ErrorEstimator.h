@@ -0,0 +1,67 @@
+#ifndef ERRORESTIMATOR_H
+#define ERRORESTIMATOR_H
+
+#include "Types.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// Element error indicators of ErrorEstimator
+enum class ErrorIndicator {
+    Kelly,   // Jumps of the normal flux across the element edges
+    Residual // Flux jumps plus the element residual of the equation
+};
+
+// A posteriori error estimation for linear elements on -div(A grad u) + b.grad u + c u = f.
+// The residual indicator of element T is
+//   eta_T^2 = h_T^2 ||f - b.grad u_h - c u_h||_T^2 + 1/2 sum_interior h_e ||[n.A grad u_h]||_e^2
+//             + sum_Neumann h_e ||q - n.A grad u_h||_e^2
+// with the diffusion tensor taken at the centroid like the assembly, so div(A grad u_h) = 0 in T.
+// Edges on Dirichlet boundaries carry no term. On other boundary edges q is the flux density
+// matching the nodal Neumann loads of the solver (zero for free boundaries).
+class ErrorEstimator {
+public:
+    ErrorEstimator(
+        CoefficientFunction a11_func = nullptr,
+        CoefficientFunction a12_func = nullptr,
+        CoefficientFunction a22_func = nullptr,
+        CoefficientFunction b1_func = nullptr,
+        CoefficientFunction b2_func = nullptr,
+        CoefficientFunction c_func = nullptr,
+        CoefficientFunction f_func = nullptr
+    );
+    ~ErrorEstimator() = default;
+
+    // Replace coefficients with batched evaluators; null entries are left unchanged
+    void setBatchCoefficients(
+        BatchCoefficientFunction a11_func, BatchCoefficientFunction a12_func, BatchCoefficientFunction a22_func,
+        BatchCoefficientFunction b1_func, BatchCoefficientFunction b2_func,
+        BatchCoefficientFunction c_func, BatchCoefficientFunction f_func
+    );
+
+    void setIndicator(ErrorIndicator indicator) { indicator_ = indicator; }
+    ErrorIndicator getIndicator() const { return indicator_; }
+
+    // Squared indicator eta_T^2 of every element for a solution of the problem on the mesh
+    std::vector<double> estimate(
+        const Mesh& mesh,
+        const std::vector<double>& solution,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    ) const;
+
+    // Global estimate: the square root of the summed squared indicators
+    static double globalEstimate(const std::vector<double>& indicators);
+
+    // Dörfler (bulk) marking: the fewest elements, largest indicators first, whose squared
+    // indicators sum to at least theta times the total (0 < theta <= 1)
+    static std::vector<MeshIndex> markDorfler(const std::vector<double>& indicators, double theta);
+
+private:
+    BatchCoefficientFunction a11_func_, a12_func_, a22_func_;
+    BatchCoefficientFunction b1_func_, b2_func_;
+    BatchCoefficientFunction c_func_, f_func_;
+    ErrorIndicator indicator_ = ErrorIndicator::Residual;
+};
+
+#endif // ERRORESTIMATOR_H
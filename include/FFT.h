@@ -0,0 +1,55 @@
+#ifndef FFT_H
+#define FFT_H
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Discrete Fourier transform of a fixed length n,
+//     X[k] = sum_j x[j] exp(-2 pi i j k / n),
+// planned once and applied to any number of sequences. The length is split into its prime
+// factors for a mixed-radix Cooley-Tukey transform with precomputed twiddle factors. When a
+// large prime factor would make that slow, the transform is written as a convolution with a
+// chirp (Bluestein's algorithm) evaluated by power-of-two transforms of at least 2n - 1
+// points, so every length costs O(n log n). Transforms do not allocate when given a workspace,
+// and threads may share a plan as long as each passes its own.
+class FFT {
+public:
+    explicit FFT(std::size_t n);
+    ~FFT();
+
+    std::size_t size() const { return n_; }
+    // Complex values of scratch space that a transform needs
+    std::size_t workspaceSize() const { return workspaceSize_; }
+    // Estimated work of a transform per point, in complex multiply-adds
+    double costPerPoint() const { return costPerPoint_; }
+
+    // In-place forward transform of data[0, n), with scratch space workspace[0, workspaceSize())
+    void forward(std::complex<double>* data, std::complex<double>* workspace) const;
+    // In-place inverse transform, including the 1/n scaling
+    void inverse(std::complex<double>* data, std::complex<double>* workspace) const;
+    // The same with a workspace allocated for the call
+    void forward(std::complex<double>* data) const;
+    void inverse(std::complex<double>* data) const;
+
+private:
+    // Mixed-radix transform of in (read with the given stride) into out, for the factors from
+    // factor onwards; butterfly holds the largest radix
+    void mixedRadix(std::complex<double>* out, const std::complex<double>* in, std::size_t stride,
+                    std::size_t factor, std::complex<double>* butterfly) const;
+
+    std::size_t n_;
+    std::size_t workspaceSize_ = 0;
+    double costPerPoint_ = 0.0;
+    std::vector<std::size_t> factors_;            // Radices, smallest first
+    std::vector<std::complex<double>> twiddles_;  // exp(-2 pi i k / n), k < n
+
+    // Bluestein: chirp_[j] = exp(-pi i j^2 / n), the power-of-two transform of the convolution
+    // and its transform of the conjugate chirp filter
+    std::vector<std::complex<double>> chirp_;
+    std::unique_ptr<FFT> convolution_;
+    std::vector<std::complex<double>> filterSpectrum_;
+};
+
+#endif // FFT_H
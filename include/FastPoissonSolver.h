@@ -0,0 +1,93 @@
+#ifndef FASTPOISSONSOLVER_H
+#define FASTPOISSONSOLVER_H
+
+#include "Types.h"
+#include "CoefficientProviders.h"
+#include "SparseMatrix.h"
+#include "StructuredMeshView.h"
+#include <cstddef>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+class CompiledExpression;
+
+// Linear triangle solver for -(a11 u_x)_x - (a22 u_y)_y + c u = f with constant a11, a22 and c
+// on a uniform grid whose sides are Dirichlet or Neumann (sides without a condition count as
+// Neumann). The stiffness matrix is then a Kronecker sum of 1D second differences, which
+// discrete sine and cosine transforms diagonalize on each axis: the type of transform follows
+// the conditions at the two ends of the axis (sine for Dirichlet-Dirichlet, cosine for
+// Neumann-Neumann, quarter-wave sine or cosine for mixed ends), and each is evaluated by an FFT
+// of an extended sequence. Solving with the stiffness matrix plus a lumped reaction term costs
+// O(N log N). The consistent reaction matrix also couples diagonal neighbours, so the transform
+// solve is exact for c = 0 and otherwise preconditions conjugate gradients on the stencil
+// operator of StencilSolver, which then converge in a few iterations for any grid size.
+class FastPoissonSolver {
+public:
+    // The constant operator coefficients
+    struct Coefficients {
+        double a11 = 1.0;
+        double a22 = 1.0;
+        double c = 0.0;
+    };
+
+    // The coefficients of a set whose a11, a22 and c are constant and a12, b1 and b2 zero
+    template <class CoefficientSet>
+    static std::optional<Coefficients> fromStatic(const CoefficientSet& coeffs);
+    // The same for compiled coefficient expressions
+    static std::optional<Coefficients> fromExpressions(
+        const CompiledExpression& a11, const CompiledExpression& a12, const CompiledExpression& a22,
+        const CompiledExpression& b1, const CompiledExpression& b2, const CompiledExpression& c
+    );
+
+    FastPoissonSolver(const Coefficients& coefficients, CoefficientFunction f_func);
+    ~FastPoissonSolver() = default;
+
+    // Whether solve handles the problem: a uniform grid, a11 and a22 positive, c non-negative,
+    // only Dirichlet and Neumann conditions, and not Neumann-only with c = 0 (singular)
+    static bool supports(
+        const StructuredMeshView& grid, const Coefficients& coefficients,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    );
+    // Whether solve is expected to be faster than conjugate gradients on the stencil operator
+    // (StencilSolver) for a supported problem. Cell counts with large prime factors make the
+    // transforms cost up to about a hundred operations per point (see FFT::costPerPoint),
+    // while the iteration count of conjugate gradients grows with the grid side.
+    static bool isFasterThanIteration(
+        const StructuredMeshView& grid, const Coefficients& coefficients,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    );
+
+    // Relative residual and iteration limit of the preconditioned iteration
+    void setTolerance(double tolerance, int maxIterations = 100) { tolerance_ = tolerance; maxIterations_ = maxIterations; }
+
+    // Throws std::invalid_argument for unsupported problems and std::runtime_error if the
+    // iteration does not converge
+    std::vector<double> solve(const StructuredMeshView& grid, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+    // Iterations and residual of the last solve
+    const IterativeSolveReport& getReport() const { return report_; }
+
+private:
+    Coefficients coefficients_;
+    CoefficientFunction f_func_;
+
+    double tolerance_ = 1e-10;
+    int maxIterations_ = 100;
+    IterativeSolveReport report_;
+};
+
+template <class CoefficientSet>
+std::optional<FastPoissonSolver::Coefficients> FastPoissonSolver::fromStatic(const CoefficientSet& coeffs) {
+    if constexpr (hasUniformOperator<CoefficientSet>()) {
+        if (coeffs.a12(0.0, 0.0) != 0.0 || coeffs.b1(0.0, 0.0) != 0.0 || coeffs.b2(0.0, 0.0) != 0.0) {
+            return std::nullopt;
+        }
+        return Coefficients{ coeffs.a11(0.0, 0.0), coeffs.a22(0.0, 0.0), coeffs.c(0.0, 0.0) };
+    } else {
+        return std::nullopt;
+    }
+}
+
+#endif // FASTPOISSONSOLVER_H
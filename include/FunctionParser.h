@@ -5,6 +5,51 @@
 #include <string>
 #include <functional>
 #include <map>
+#include <memory>
+#include <vector>
+
+// Expression compiled once into a flat postfix program.
+// Evaluation follows FunctionParser semantics: an expression that fails to parse evaluates to 0
+// everywhere, and a point where evaluation fails (division by zero, sqrt of a negative) yields 0.
+class CompiledExpression {
+public:
+    enum class OpCode : unsigned char {
+        Constant, VarX, VarY,
+        Add, Sub, Mul, Div, Neg,
+        Sin, Cos, Tan, Exp, Log, Sqrt, Abs
+    };
+
+    struct Instruction {
+        OpCode op;
+        double value; // Used by Constant only
+    };
+
+    // Point evaluation
+    double evaluate(double x, double y) const;
+
+    // Batched evaluation: out[i] = value at (x[i], y[i]) for i in [0, n)
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const;
+
+    // Getters
+    const std::string& source() const { return source_; }
+    const std::vector<Instruction>& program() const { return program_; }
+    bool isValid() const { return valid_; }
+    bool isConstant() const { return program_.size() == 1 && program_[0].op == OpCode::Constant; }
+    double constantValue() const { return isConstant() ? program_[0].value : 0.0; }
+    bool dependsOnX() const { return usesX_; }
+    bool dependsOnY() const { return usesY_; }
+    int stackDepth() const { return stackDepth_; }
+
+private:
+    friend class FunctionParser;
+    friend class ExpressionCompiler;
+
+    std::string source_;
+    std::vector<Instruction> program_;
+    bool valid_ = false;
+    bool usesX_ = false, usesY_ = false;
+    int stackDepth_ = 0;
+};
 
 class FunctionParser {
 public:
@@ -14,6 +59,16 @@ public:
     // Parse and return a function from a string expression
     static CoefficientFunction parseFunction(const std::string& funcStr);
 
+    // Parse and return a batched function from a string expression
+    static BatchCoefficientFunction parseBatchFunction(const std::string& funcStr);
+
+    // Compile an expression once for repeated evaluation (never throws; see CompiledExpression)
+    static std::shared_ptr<const CompiledExpression> compile(const std::string& funcStr);
+
+    // Point and batched functions sharing an already compiled expression
+    static CoefficientFunction toFunction(std::shared_ptr<const CompiledExpression> compiled);
+    static BatchCoefficientFunction toBatchFunction(std::shared_ptr<const CompiledExpression> compiled);
+
     // Safe evaluation of mathematical expressions
     static double safeEval(const std::string& expression, double x, double y);
 
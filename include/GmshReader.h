@@ -0,0 +1,43 @@
+#ifndef GMSHREADER_H
+#define GMSHREADER_H
+
+#include "Types.h"
+#include <cstddef>
+#include <string>
+
+// Reader for Gmsh MSH 4.1 meshes, ASCII or binary. The file is memory-mapped; a quick
+// sequential pass finds the node and element blocks, and their contents are then parsed in
+// parallel chunks straight from the mapping.
+//
+// 3-node triangles become the mesh elements (reoriented counterclockwise) and z is ignored.
+// Physical groups of points and curves become mesh boundaries holding the nodes of their point
+// and line elements, named after $PhysicalNames or "physical<tag>" when unnamed. Nodes not used
+// by any triangle are dropped.
+class GmshReader {
+public:
+    struct Statistics {
+        bool binary = false;
+        std::size_t fileBytes = 0;
+        std::size_t nodes = 0;            // Nodes kept in the mesh
+        std::size_t triangles = 0;
+        std::size_t boundaryElements = 0; // Point and line elements read for the boundaries
+        std::size_t physicalGroups = 0;   // Groups mapped to boundaries
+        double milliseconds = 0.0;
+    };
+
+    GmshReader() = default;
+    ~GmshReader() = default;
+
+    // Read a mesh file (throws std::runtime_error for unreadable, malformed or unsupported files)
+    Mesh read(const std::string& filename);
+
+    // Parse a mesh held in memory; `source` names it in error messages
+    Mesh parse(const char* data, std::size_t size, const std::string& source = "<memory>");
+
+    const Statistics& getStatistics() const { return statistics_; }
+
+private:
+    Statistics statistics_;
+};
+
+#endif // GMSHREADER_H
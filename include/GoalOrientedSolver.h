@@ -0,0 +1,95 @@
+#ifndef GOALORIENTEDSOLVER_H
+#define GOALORIENTEDSOLVER_H
+
+#include "Types.h"
+#include "AdaptiveSolver.h"
+#include "ErrorEstimator.h"
+#include "MeshRefiner.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+class EllipticFEMSolver;
+
+// Linear output J(u) = integral of weight * u over the domain + outward flux
+// integral of n.A grad u over fluxBoundary (either part may be left out)
+struct QuantityOfInterest {
+    CoefficientFunction weight;   // Null for no domain part
+    std::string fluxBoundary;     // A Dirichlet boundary, empty for no flux part
+
+    // Mean of u over the rectangle [x0, x1] x [y0, y1]
+    static QuantityOfInterest regionAverage(double x0, double x1, double y0, double y1);
+    // Outward flux through a Dirichlet boundary
+    static QuantityOfInterest boundaryFlux(const std::string& boundary);
+};
+
+// Goal-oriented adaptivity by dual weighted residuals.
+// Each step solves the primal problem and the discrete adjoint problem for the quantity of
+// interest on the same mesh. The residual indicators of the primal solution are weighted by
+// the flux-jump indicators of the adjoint solution, so elements are refined only where their
+// residual affects the quantity; the sum of the weighted indicators, sum_T eta_T omega_T,
+// estimates the error of the quantity up to a constant. Flux quantities are evaluated from
+// the residual of the assembled system, which converges faster than differentiating the
+// solution.
+class GoalOrientedSolver {
+public:
+    using Options = AdaptiveSolver::Options; // targetError applies to the quantity of interest
+
+    struct Step {
+        std::size_t nodes = 0;
+        std::size_t elements = 0;
+        double value = 0.0;             // J(u_h)
+        double estimate = 0.0;          // Estimated error of the value, sum_T eta_T omega_T
+        std::size_t markedElements = 0; // Zero on the last step
+        double milliseconds = 0.0;
+    };
+
+    struct Result {
+        Mesh mesh;                    // Final mesh
+        std::vector<double> solution; // Primal and adjoint solutions on the final mesh
+        std::vector<double> adjoint;
+        double value = 0.0;           // J(u_h) on the final mesh
+        double estimate = 0.0;
+        std::vector<Step> history;
+        bool converged = false;       // The target was reached within the limits
+
+        std::string describe() const;
+    };
+
+    GoalOrientedSolver(EllipticFEMSolver& solver, const ErrorEstimator& estimator, const QuantityOfInterest& quantity);
+    ~GoalOrientedSolver() = default;
+
+    void setOptions(const Options& options) { options_ = options; }
+    const Options& getOptions() const { return options_; }
+
+    // Solve adaptively starting from the initial mesh (relabelled with labelLongestEdges)
+    Result solve(const Mesh& initialMesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+    // J(u_h) for a solution on the mesh
+    double evaluate(
+        const Mesh& mesh,
+        const std::vector<double>& solution,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    ) const;
+
+private:
+    // Load vector of the domain part: integrals of weight * phi_i
+    std::vector<double> weightLoad(const Mesh& mesh) const;
+
+    // Adjoint conditions: zero on the Dirichlet boundaries (one on the flux boundary), zero
+    // flux on the Neumann boundaries
+    std::map<std::string, BoundaryConditionData> adjointConditions(
+        const Mesh& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    ) const;
+
+    EllipticFEMSolver& solver_;
+    const ErrorEstimator& estimator_;
+    ErrorEstimator adjointEstimator_;
+    QuantityOfInterest quantity_;
+    MeshRefiner refiner_;
+    Options options_;
+};
+
+#endif // GOALORIENTEDSOLVER_H
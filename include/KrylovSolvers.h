@@ -0,0 +1,142 @@
+#ifndef KRYLOVSOLVERS_H
+#define KRYLOVSOLVERS_H
+
+#include "SparseMatrix.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Krylov solvers for any operator with size(), diagonal() and multiply(x, y) computing
+// y = A x (SparseMatrix, StencilOperator), Jacobi-preconditioned unless a preconditioner is
+// passed in.
+
+namespace krylov {
+
+inline double dot(const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < a.size(); ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+// Conjugate gradients with a symmetric positive definite preconditioner precondition(r, z)
+// computing z = M^-1 r; x holds the initial guess
+template <class Operator, class Preconditioner>
+IterativeSolveReport preconditionedConjugateGradient(
+    const Operator& A, const std::vector<double>& b, std::vector<double>& x,
+    const Preconditioner& precondition, double tolerance, int maxIterations, const char* method
+) {
+    const std::size_t n = A.size();
+    IterativeSolveReport report;
+    report.method = method;
+    x.resize(n, 0.0);
+
+    std::vector<double> r(n), z(n), p(n), q(n);
+    A.multiply(x, q);
+    for (std::size_t i = 0; i < n; ++i) r[i] = b[i] - q[i];
+    const double bNorm = std::sqrt(dot(b, b));
+    if (bNorm == 0.0) {
+        std::fill(x.begin(), x.end(), 0.0);
+        report.converged = true;
+        return report;
+    }
+
+    precondition(r, z);
+    p = z;
+    double rz = dot(r, z);
+    report.relativeResidual = std::sqrt(dot(r, r)) / bNorm;
+    while (report.relativeResidual > tolerance && report.iterations < maxIterations) {
+        A.multiply(p, q);
+        double alpha = rz / dot(p, q);
+        for (std::size_t i = 0; i < n; ++i) {
+            x[i] += alpha * p[i];
+            r[i] -= alpha * q[i];
+        }
+        precondition(r, z);
+        double rzNext = dot(r, z);
+        double beta = rzNext / rz;
+        rz = rzNext;
+        for (std::size_t i = 0; i < n; ++i) p[i] = z[i] + beta * p[i];
+        ++report.iterations;
+        report.relativeResidual = std::sqrt(dot(r, r)) / bNorm;
+    }
+    report.converged = report.relativeResidual <= tolerance;
+    return report;
+}
+
+// Conjugate gradients for symmetric positive definite operators; x holds the initial guess
+template <class Operator>
+IterativeSolveReport conjugateGradient(
+    const Operator& A, const std::vector<double>& b, std::vector<double>& x,
+    double tolerance, int maxIterations
+) {
+    std::vector<double> inverseDiagonal = A.diagonal();
+    for (double& d : inverseDiagonal) d = d != 0.0 ? 1.0 / d : 1.0;
+    auto jacobi = [&](const std::vector<double>& r, std::vector<double>& z) {
+        for (std::size_t i = 0; i < r.size(); ++i) z[i] = inverseDiagonal[i] * r[i];
+    };
+    return preconditionedConjugateGradient(A, b, x, jacobi, tolerance, maxIterations, "Conjugate gradients");
+}
+
+// BiCGSTAB for general nonsingular operators
+template <class Operator>
+IterativeSolveReport biCGStab(
+    const Operator& A, const std::vector<double>& b, std::vector<double>& x,
+    double tolerance, int maxIterations
+) {
+    const std::size_t n = A.size();
+    IterativeSolveReport report;
+    report.method = "BiCGSTAB";
+    x.resize(n, 0.0);
+
+    std::vector<double> inverseDiagonal = A.diagonal();
+    for (double& d : inverseDiagonal) d = d != 0.0 ? 1.0 / d : 1.0;
+
+    std::vector<double> r(n), rHat(n), p(n, 0.0), v(n, 0.0), s(n), t(n), pHat(n), sHat(n);
+    A.multiply(x, t);
+    for (std::size_t i = 0; i < n; ++i) r[i] = b[i] - t[i];
+    rHat = r;
+    const double bNorm = std::sqrt(dot(b, b));
+    if (bNorm == 0.0) {
+        std::fill(x.begin(), x.end(), 0.0);
+        report.converged = true;
+        return report;
+    }
+
+    double rho = 1.0, alpha = 1.0, omega = 1.0;
+    report.relativeResidual = std::sqrt(dot(r, r)) / bNorm;
+    while (report.relativeResidual > tolerance && report.iterations < maxIterations) {
+        double rhoNext = dot(rHat, r);
+        if (rhoNext == 0.0) break; // Breakdown; the report shows the residual reached
+        double beta = (rhoNext / rho) * (alpha / omega);
+        rho = rhoNext;
+        for (std::size_t i = 0; i < n; ++i) p[i] = r[i] + beta * (p[i] - omega * v[i]);
+        for (std::size_t i = 0; i < n; ++i) pHat[i] = inverseDiagonal[i] * p[i];
+        A.multiply(pHat, v);
+        alpha = rho / dot(rHat, v);
+        for (std::size_t i = 0; i < n; ++i) s[i] = r[i] - alpha * v[i];
+        ++report.iterations;
+
+        if (std::sqrt(dot(s, s)) / bNorm <= tolerance) {
+            for (std::size_t i = 0; i < n; ++i) x[i] += alpha * pHat[i];
+            r = s;
+            report.relativeResidual = std::sqrt(dot(r, r)) / bNorm;
+            break;
+        }
+        for (std::size_t i = 0; i < n; ++i) sHat[i] = inverseDiagonal[i] * s[i];
+        A.multiply(sHat, t);
+        double tt = dot(t, t);
+        omega = tt > 0.0 ? dot(t, s) / tt : 0.0;
+        for (std::size_t i = 0; i < n; ++i) {
+            x[i] += alpha * pHat[i] + omega * sHat[i];
+            r[i] = s[i] - omega * t[i];
+        }
+        report.relativeResidual = std::sqrt(dot(r, r)) / bNorm;
+        if (omega == 0.0) break;
+    }
+    report.converged = report.relativeResidual <= tolerance;
+    return report;
+}
+
+} // namespace krylov
+
+#endif // KRYLOVSOLVERS_H
@@ -0,0 +1,42 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file.
+// The mapping is released when the object is destroyed; the object is movable but not copyable.
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Map the file at the given path (throws std::runtime_error on failure)
+    void open(const std::string& path);
+
+    // Unmap the file
+    void close();
+
+    // Getters
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    bool isOpen() const { return opened_; }
+
+private:
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+    bool opened_ = false;
+
+#ifdef _WIN32
+    void* fileHandle_ = nullptr;
+    void* mappingHandle_ = nullptr;
+#endif
+};
+
+#endif // MAPPEDFILE_H
\ No newline at end of file
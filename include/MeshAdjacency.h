@@ -0,0 +1,89 @@
+#ifndef MESHADJACENCY_H
+#define MESHADJACENCY_H
+
+#include "Types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Contiguous run of indices inside a MeshAdjacency
+class IndexSpan {
+public:
+    IndexSpan(const MeshIndex* first, const MeshIndex* last) : first_(first), last_(last) {}
+
+    const MeshIndex* begin() const { return first_; }
+    const MeshIndex* end() const { return last_; }
+    std::size_t size() const { return static_cast<std::size_t>(last_ - first_); }
+    bool empty() const { return first_ == last_; }
+    MeshIndex operator[](std::size_t k) const { return first_[k]; }
+
+private:
+    const MeshIndex* first_;
+    const MeshIndex* last_;
+};
+
+// Node-to-element and node-to-node adjacency of a Mesh in compressed rows (CSR), built in
+// parallel. Obtain it through Mesh::adjacency(), which builds it on first use and keeps it
+// with the mesh.
+class MeshAdjacency {
+public:
+    explicit MeshAdjacency(const Mesh& mesh);
+    // Adopt arrays built earlier for the same mesh (e.g. read from a mesh cache file)
+    MeshAdjacency(const Mesh& mesh, std::vector<std::size_t> nodeElementOffsets, std::vector<MeshIndex> nodeElements,
+                  std::vector<std::size_t> nodeNeighborOffsets, std::vector<MeshIndex> nodeNeighbors);
+    ~MeshAdjacency() = default;
+
+    // Elements containing a node, ascending
+    IndexSpan elementsOf(MeshIndex node) const {
+        return IndexSpan(nodeElements_.data() + nodeElementOffsets_[node],
+                         nodeElements_.data() + nodeElementOffsets_[node + 1]);
+    }
+    // Nodes sharing an element with a node (without the node itself), ascending
+    IndexSpan neighborsOf(MeshIndex node) const {
+        return IndexSpan(nodeNeighbors_.data() + nodeNeighborOffsets_[node],
+                         nodeNeighbors_.data() + nodeNeighborOffsets_[node + 1]);
+    }
+    std::size_t degree(MeshIndex node) const {
+        return nodeNeighborOffsets_[node + 1] - nodeNeighborOffsets_[node];
+    }
+
+    // Raw CSR arrays: row i is [offsets[i], offsets[i + 1])
+    const std::vector<std::size_t>& nodeElementOffsets() const { return nodeElementOffsets_; }
+    const std::vector<MeshIndex>& nodeElements() const { return nodeElements_; }
+    const std::vector<std::size_t>& nodeNeighborOffsets() const { return nodeNeighborOffsets_; }
+    const std::vector<MeshIndex>& nodeNeighbors() const { return nodeNeighbors_; }
+
+    // Element neighbours across edges, computed on request: entry 3e + k is the element sharing
+    // the edge opposite corner k of element e, or -1 on the boundary
+    std::vector<MeshIndex> elementNeighbors(const Mesh& mesh) const;
+
+    // Whether this adjacency was built for the mesh in its current state
+    bool matches(const Mesh& mesh) const;
+
+    std::size_t nodeCount() const { return nodeCount_; }
+    std::size_t elementCount() const { return elementCount_; }
+
+    // Memory held by the CSR arrays, in bytes
+    std::size_t nodeElementBytes() const;
+    std::size_t nodeNeighborBytes() const;
+    std::size_t memoryBytes() const { return nodeElementBytes() + nodeNeighborBytes(); }
+
+    // Sizes, memory use and build time
+    std::string describe() const;
+
+private:
+    std::uint64_t meshId_;
+    std::size_t nodeCount_, elementCount_;
+    double buildMilliseconds_ = 0.0;
+
+    std::vector<std::size_t> nodeElementOffsets_;
+    std::vector<MeshIndex> nodeElements_;
+    std::vector<std::size_t> nodeNeighborOffsets_;
+    std::vector<MeshIndex> nodeNeighbors_;
+
+    void buildNodeElements(const Mesh& mesh);
+    void buildNodeNeighbors(const Mesh& mesh);
+};
+
+#endif // MESHADJACENCY_H
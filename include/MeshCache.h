@@ -0,0 +1,118 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+
+#include "Types.h"
+#include "MappedFile.h"
+#include "MeshAdjacency.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Read-only mesh backed by a memory-mapped mesh cache file (see MeshCache).
+// Coordinates, connectivity, boundary tags and sets, and the optional adjacency and element
+// geometry are used in place from the mapping: opening costs a header check, and processes
+// opening the same file share its pages. Copies share the mapping.
+class MappedMesh {
+public:
+    using BoundaryRange = IndexSpan;
+
+    MappedMesh() = default;
+
+    std::uint64_t id = 0; // Unique per opened file (copies share it), see BoundaryValueCache
+
+    // Uniform mesh accessors (see Mesh)
+    std::size_t nodeCount() const { return nodeCount_; }
+    std::size_t elementCount() const { return elementCount_; }
+    bool empty() const { return nodeCount_ == 0; }
+    Node node(std::size_t i) const { return Node(x_[i], y_[i]); }
+    Element element(std::size_t e) const {
+        const MeshIndex* nodes = connectivity_ + 3 * e;
+        return Element{ nodes[0], nodes[1], nodes[2] };
+    }
+    std::uint32_t boundaryTag(std::size_t i) const { return tags_ ? tags_[i] : 0u; }
+    int boundaryTagBit(const std::string& name) const;
+    std::optional<BoundaryRange> findBoundary(const std::string& name) const;
+    std::vector<std::string> boundaryNames() const;
+
+    // Raw arrays inside the mapping (boundaryTags() is null for meshes without boundaries)
+    const double* x() const { return x_; }
+    const double* y() const { return y_; }
+    const MeshIndex* connectivity() const { return connectivity_; }
+    const std::uint32_t* boundaryTags() const { return tags_; }
+
+    // Node-to-element and node-to-node adjacency, if the file holds it (see MeshAdjacency)
+    bool hasAdjacency() const { return nodeElementOffsets_ != nullptr; }
+    IndexSpan elementsOf(MeshIndex node) const {
+        return IndexSpan(nodeElements_ + nodeElementOffsets_[node], nodeElements_ + nodeElementOffsets_[node + 1]);
+    }
+    IndexSpan neighborsOf(MeshIndex node) const {
+        return IndexSpan(nodeNeighbors_ + nodeNeighborOffsets_[node], nodeNeighbors_ + nodeNeighborOffsets_[node + 1]);
+    }
+
+    // Element areas and centroids, if the file holds them
+    bool hasGeometry() const { return areas_ != nullptr; }
+    const double* elementAreas() const { return areas_; }
+    const double* elementCentroidX() const { return centroidX_; }
+    const double* elementCentroidY() const { return centroidY_; }
+
+    // Copy into an explicit mesh (with the cached adjacency attached, if any)
+    Mesh toMesh() const;
+
+    std::size_t fileBytes() const { return file_ ? file_->size() : 0; }
+
+private:
+    friend class MeshCache;
+
+    std::shared_ptr<const MappedFile> file_;
+    std::size_t nodeCount_ = 0, elementCount_ = 0;
+    const double* x_ = nullptr;
+    const double* y_ = nullptr;
+    const MeshIndex* connectivity_ = nullptr;
+    const std::uint32_t* tags_ = nullptr;
+
+    // Boundary bit b holds nodes [boundaryOffsets_[b], boundaryOffsets_[b + 1]) of boundaryNodes_
+    std::vector<std::string> boundaryTagNames_;
+    const std::uint64_t* boundaryOffsets_ = nullptr;
+    const MeshIndex* boundaryNodes_ = nullptr;
+
+    const std::uint64_t* nodeElementOffsets_ = nullptr;
+    const MeshIndex* nodeElements_ = nullptr;
+    const std::uint64_t* nodeNeighborOffsets_ = nullptr;
+    const MeshIndex* nodeNeighbors_ = nullptr;
+
+    const double* areas_ = nullptr;
+    const double* centroidX_ = nullptr;
+    const double* centroidY_ = nullptr;
+};
+
+// Versioned binary mesh cache file.
+// The file is a fixed header, a section table and 64-byte aligned sections holding the arrays
+// in native layout, so a reader maps it and points into it without parsing or copying. Files
+// are tied to the byte order and MeshIndex width that wrote them; files of another format
+// version, byte order or index width are rejected, and callers regenerate the cache.
+class MeshCache {
+public:
+    // Format version, raised on any incompatible layout change
+    static constexpr std::uint32_t kVersion = 1;
+
+    struct WriteOptions {
+        bool adjacency = true; // Store the mesh adjacency (built if the mesh has none yet)
+        bool geometry = false; // Store element areas and centroids
+    };
+
+    // Write a mesh cache file. The file is written under a temporary name and renamed into
+    // place, so concurrent readers see the old file or the complete new one.
+    static void write(const Mesh& mesh, const std::string& path, const WriteOptions& options);
+    static void write(const Mesh& mesh, const std::string& path) { write(mesh, path, WriteOptions()); }
+
+    // Map a mesh cache file (throws std::runtime_error for missing, damaged or incompatible files)
+    static MappedMesh open(const std::string& path);
+
+    // Whether the file starts like a mesh cache file of any version
+    static bool isCacheFile(const std::string& path);
+};
+
+#endif // MESHCACHE_H
@@ -2,6 +2,9 @@
 #define MESHGENERATOR_H
 
 #include "Types.h"
+#include "StructuredMeshView.h"
+#include "AxisSpacing.h"
+#include "QuadraticMesh.h"
 #include <vector>
 #include <map>
 #include <memory>
@@ -14,19 +17,30 @@ public:
     // Generate structured mesh
     Mesh generate();
 
+    // The same mesh with quadratic (P2) elements
+    QuadraticMesh generateQuadratic() { return QuadraticMesh::fromLinear(generate()); }
+
+    // Implicit view of the same mesh; nodes and elements are computed on demand
+    StructuredMeshView view() const { return StructuredMeshView(Lx_, Ly_, Nx_, Ny_, xSpacing_, ySpacing_); }
+
     // Setters
     void setDimensions(double Lx, double Ly) { Lx_ = Lx; Ly_ = Ly; }
     void setNodeCount(int Nx, int Ny) { Nx_ = Nx; Ny_ = Ny; }
+    // Grid line distribution along x and y (uniform by default)
+    void setSpacing(const AxisSpacing& xSpacing, const AxisSpacing& ySpacing) { xSpacing_ = xSpacing; ySpacing_ = ySpacing; }
 
     // Getters
     double getLx() const { return Lx_; }
     double getLy() const { return Ly_; }
     int getNx() const { return Nx_; }
     int getNy() const { return Ny_; }
+    const AxisSpacing& getXSpacing() const { return xSpacing_; }
+    const AxisSpacing& getYSpacing() const { return ySpacing_; }
 
 private:
     double Lx_, Ly_;  // Dimensions of the domain
     int Nx_, Ny_;     // Number of nodes in each direction
+    AxisSpacing xSpacing_, ySpacing_;
 };
 
 #endif // MESHGENERATOR_H
\ No newline at end of file
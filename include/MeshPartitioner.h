@@ -0,0 +1,64 @@
+#ifndef MESHPARTITIONER_H
+#define MESHPARTITIONER_H
+
+#include "Types.h"
+#include <cstddef>
+#include <map>
+#include <string>
+#include <vector>
+
+// Element partitioning methods for MeshPartitioner
+enum class PartitionMethod {
+    Multilevel,         // Recursive bisection of the element dual graph, multilevel with FM refinement
+    CoordinateBisection // Recursive bisection of the element centroids at the median of the longer
+                        // extent; fast and close to optimal for MeshGenerator grids
+};
+
+// One subdomain. Local node k is global node nodes[k].
+struct MeshSubdomain {
+    std::vector<MeshIndex> elements;       // Elements of the part, ascending
+    std::vector<MeshIndex> nodes;          // Nodes used by those elements, ascending
+    std::vector<MeshIndex> interfaceNodes; // Nodes also used by other parts (global, ascending)
+    // Halo map: neighbouring part -> local indices of the nodes shared with it, in ascending
+    // global order, so both sides of an exchange list the shared nodes in the same order
+    std::map<int, std::vector<MeshIndex>> halo;
+};
+
+// Result of MeshPartitioner::partition
+struct MeshPartition {
+    PartitionMethod method = PartitionMethod::Multilevel;
+    std::vector<int> elementPart;           // Part of every element
+    std::vector<int> nodeOwner;             // Lowest part using each node (-1 for unused nodes)
+    std::vector<MeshSubdomain> subdomains;
+
+    std::size_t edgeCut = 0;        // Element pairs sharing an edge that lie in different parts
+    std::size_t interfaceNodes = 0; // Nodes used by more than one part
+    double imbalance = 0.0;         // Largest part over the average part, in elements
+    double milliseconds = 0.0;
+
+    int partCount() const { return static_cast<int>(subdomains.size()); }
+    std::string describe() const;
+};
+
+// Splits the elements of a mesh into balanced parts with small interfaces
+class MeshPartitioner {
+public:
+    explicit MeshPartitioner(PartitionMethod method = PartitionMethod::Multilevel);
+    ~MeshPartitioner() = default;
+
+    // Partition into `parts` parts (1 <= parts <= element count)
+    MeshPartition partition(const Mesh& mesh, int parts) const;
+
+    // Allowed excess of a part over its target weight during bisection (0.03 = 3%)
+    void setTolerance(double tolerance) { tolerance_ = tolerance; }
+    double getTolerance() const { return tolerance_; }
+    PartitionMethod getMethod() const { return method_; }
+
+    static const char* toString(PartitionMethod method);
+
+private:
+    PartitionMethod method_;
+    double tolerance_ = 0.03;
+};
+
+#endif // MESHPARTITIONER_H
@@ -0,0 +1,48 @@
+#ifndef MESHREFINER_H
+#define MESHREFINER_H
+
+#include "Types.h"
+#include <cstddef>
+#include <vector>
+
+// Newest vertex bisection of triangular meshes.
+// The refinement edge of an element is the edge opposite its first node (the newest vertex).
+// Refining marks the refinement edges of the marked elements and then, until the marking is
+// closed, the refinement edge of every element with a marked edge; each element is bisected
+// at its refinement edge and its children again at their marked edges. The result is
+// conforming, keeps the orientation of the elements and follows the same convention, so it
+// can be refined again; the shape regularity of the initial mesh is preserved.
+// Nodes added on boundary edges carry the boundaries common to both ends of the edge.
+class MeshRefiner {
+public:
+    struct Statistics {
+        std::size_t markedElements = 0;
+        std::size_t refinedElements = 0; // Marked elements and those refined for conformity
+        std::size_t newNodes = 0;
+        std::size_t elements = 0;        // Elements of the refined mesh
+        double milliseconds = 0.0;
+    };
+
+    MeshRefiner() = default;
+    ~MeshRefiner() = default;
+
+    // Rotate every element so its longest edge is opposite its first node, keeping the
+    // orientation. Call once on an initial mesh; refined meshes already follow the convention.
+    static void labelLongestEdges(Mesh& mesh);
+
+    // Refine the marked elements and as many others as conformity requires
+    Mesh refine(const Mesh& mesh, const std::vector<MeshIndex>& marked);
+
+    // Refine with every edge marked: each element becomes four, halving the mesh size
+    Mesh refineUniformly(const Mesh& mesh);
+
+    const Statistics& getStatistics() const { return statistics_; }
+
+private:
+    // Refine the marked elements, or with every edge marked if marked is null
+    Mesh refineMarked(const Mesh& mesh, const std::vector<MeshIndex>* marked);
+
+    Statistics statistics_;
+};
+
+#endif // MESHREFINER_H
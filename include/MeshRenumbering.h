@@ -0,0 +1,66 @@
+#ifndef MESHRENUMBERING_H
+#define MESHRENUMBERING_H
+
+#include "Types.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Node orderings for MeshRenumberer
+enum class NodeOrdering {
+    Original,            // Keep the numbering of the mesh builder
+    ReverseCuthillMcKee, // Small matrix bandwidth and profile
+    Hilbert,             // Hilbert curve through the node coordinates (cache locality)
+    Morton               // Z-order curve, cheaper to compute than Hilbert
+};
+
+// Node and element permutations between an original mesh and its renumbered copy
+struct MeshPermutation {
+    std::vector<MeshIndex> nodeNewToOld;    // Renumbered node i was original node nodeNewToOld[i]
+    std::vector<MeshIndex> nodeOldToNew;
+    std::vector<MeshIndex> elementNewToOld;
+
+    bool empty() const { return nodeNewToOld.empty(); }
+
+    // Nodal values of the renumbered mesh in the original node order, and the reverse
+    std::vector<double> toOriginalOrder(const std::vector<double>& renumbered) const;
+    std::vector<double> toRenumberedOrder(const std::vector<double>& original) const;
+};
+
+// Bandwidth and profile of the node adjacency before and after renumbering
+struct RenumberingReport {
+    NodeOrdering ordering = NodeOrdering::Original;
+    std::size_t bandwidthBefore = 0, bandwidthAfter = 0;
+    std::size_t profileBefore = 0, profileAfter = 0;
+
+    std::string describe() const;
+};
+
+// Renumbers the nodes of a mesh for locality and reorders the elements by their lowest new node,
+// so assembly scatters into nearby rows. Boundary tags and sets follow their nodes.
+class MeshRenumberer {
+public:
+    explicit MeshRenumberer(NodeOrdering ordering = NodeOrdering::ReverseCuthillMcKee);
+    ~MeshRenumberer() = default;
+
+    // Renumbered copy of the mesh (with a new id); permutation and report are filled in
+    Mesh renumber(const Mesh& mesh, MeshPermutation& permutation, RenumberingReport& report) const;
+
+    MeshPermutation computePermutation(const Mesh& mesh) const;
+    static Mesh apply(const Mesh& mesh, const MeshPermutation& permutation);
+
+    // Largest |i - j| over nodes i, j sharing an element
+    static std::size_t bandwidth(const Mesh& mesh);
+    // Sum over rows i of i - (lowest node sharing an element with i)
+    static std::size_t profile(const Mesh& mesh);
+
+    static const char* toString(NodeOrdering ordering);
+
+private:
+    NodeOrdering ordering_;
+
+    static std::vector<MeshIndex> reverseCuthillMcKee(const Mesh& mesh);
+    static std::vector<MeshIndex> spaceFillingCurve(const Mesh& mesh, bool hilbert);
+};
+
+#endif // MESHRENUMBERING_H
@@ -0,0 +1,87 @@
+#ifndef OPERATORANALYZER_H
+#define OPERATORANALYZER_H
+
+#include "FunctionParser.h"
+#include <cmath>
+#include <limits>
+#include <string>
+
+// Closed interval of reals with outward rounding; nan marks a value that may be NaN somewhere
+struct Interval {
+    double lo = 0.0;
+    double hi = 0.0;
+    bool nan = false;
+
+    Interval() = default;
+    // A NaN value (e.g. a folded constant like log(0) * 0) becomes the whole line with nan set
+    Interval(double value) : lo(value), hi(value), nan(std::isnan(value)) {
+        if (nan) {
+            lo = -std::numeric_limits<double>::infinity();
+            hi = std::numeric_limits<double>::infinity();
+        }
+    }
+    Interval(double lower, double upper) : lo(lower), hi(upper) {}
+
+    static Interval entire() {
+        return Interval(-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity());
+    }
+
+    bool contains(double value) const { return !nan && lo <= value && value <= hi; }
+    bool isPoint() const { return !nan && lo == hi; }
+};
+
+Interval operator+(const Interval& a, const Interval& b);
+Interval operator-(const Interval& a, const Interval& b);
+Interval operator-(const Interval& a);
+Interval operator*(const Interval& a, const Interval& b);
+Interval sqr(const Interval& a);
+Interval hull(const Interval& a, const Interval& b);
+
+// Static check of the operator -div(A grad u) + b . grad u + c u on [0,Lx] x [0,Ly] using interval
+// arithmetic over compiled coefficient expressions. Boxes where a property cannot be decided are
+// bisected up to a fixed depth, so the answers are conservative: "provably" means for every point.
+class OperatorAnalyzer {
+public:
+    enum class OperatorClass {
+        SymmetricPositiveDefinite, // Elliptic, no convection, c >= 0 and the system is definite
+        Nonsymmetric,              // Elliptic, but the convection field may be nonzero
+        PossiblyIndefinite         // Ellipticity or c >= 0 could not be proven
+    };
+
+    struct Report {
+        OperatorClass classification = OperatorClass::PossiblyIndefinite;
+
+        // Bounds over the domain
+        Interval a11, a22;
+        Interval discriminant;  // Determinant of the assembled diffusion tensor
+        Interval c;
+        Interval convection;    // |b|
+
+        bool elliptic = false;  // a11 > 0 and discriminant > 0 everywhere
+        bool symmetric = false; // b vanishes (below the assembly threshold) everywhere
+        int boxes = 0;          // Number of boxes evaluated
+
+        std::string describe() const;
+    };
+
+    explicit OperatorAnalyzer(int maxDepth = 10);
+    ~OperatorAnalyzer() = default;
+
+    // Analyze the operator. Without a Dirichlet boundary a symmetric operator is definite only
+    // if c is provably positive somewhere.
+    Report analyze(
+        const CompiledExpression& a11, const CompiledExpression& a12, const CompiledExpression& a22,
+        const CompiledExpression& b1, const CompiledExpression& b2, const CompiledExpression& c,
+        double Lx, double Ly, bool hasDirichletBoundary
+    ) const;
+
+    // Enclosure of the values an expression takes (with FunctionParser semantics) over a box
+    static Interval evaluate(const CompiledExpression& expression, const Interval& x, const Interval& y);
+
+    static const char* toString(OperatorClass classification);
+
+private:
+    int maxDepth_;
+};
+
+#endif // OPERATORANALYZER_H
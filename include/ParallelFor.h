@@ -0,0 +1,63 @@
+#ifndef PARALLELFOR_H
+#define PARALLELFOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+// Number of worker threads to use for count items, at least minChunk items per thread
+inline std::size_t parallelChunkCount(std::size_t count, std::size_t minChunk = 4096) {
+    std::size_t threads = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    std::size_t chunks = (count + minChunk - 1) / std::max<std::size_t>(1, minChunk);
+    return std::max<std::size_t>(1, std::min(threads, chunks));
+}
+
+// Split [0, count) into `chunks` contiguous ranges and call body(chunk, begin, end) for each,
+// chunk 0 on the calling thread and the others on their own threads. Chunk c always covers the
+// same range, so per-chunk results can be combined deterministically. The first exception
+// thrown by a chunk is rethrown after all chunks have finished.
+template <class Body>
+void parallelChunks(std::size_t count, std::size_t chunks, Body body) {
+    chunks = std::max<std::size_t>(1, std::min(chunks, std::max<std::size_t>(1, count)));
+    auto range = [&](std::size_t chunk) { return count * chunk / chunks; };
+
+    if (chunks == 1) {
+        body(std::size_t(0), std::size_t(0), count);
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(chunks);
+    std::vector<std::thread> workers;
+    workers.reserve(chunks - 1);
+    for (std::size_t chunk = 1; chunk < chunks; ++chunk) {
+        workers.emplace_back([&, chunk]() {
+            try {
+                body(chunk, range(chunk), range(chunk + 1));
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        });
+    }
+    try {
+        body(std::size_t(0), range(0), range(1));
+    } catch (...) {
+        errors[0] = std::current_exception();
+    }
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+// Call body(begin, end) over contiguous ranges of [0, count) in parallel
+template <class Body>
+void parallelFor(std::size_t count, Body body, std::size_t minChunk = 4096) {
+    parallelChunks(count, parallelChunkCount(count, minChunk),
+                   [&](std::size_t, std::size_t begin, std::size_t end) { body(begin, end); });
+}
+
+#endif // PARALLELFOR_H
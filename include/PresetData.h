@@ -0,0 +1,18 @@
+#ifndef PRESETDATA_H
+#define PRESETDATA_H
+
+// Structure to hold preset data
+struct PresetData {
+    const wchar_t* name;
+    const wchar_t* description_en;
+    const wchar_t* description_ru;
+    const wchar_t* lx, * ly, * nx, * ny;
+    const wchar_t* a11, * a12, * a22, * b1, * b2, * c, * f;
+    const wchar_t* westValue, * eastValue, * southValue, * northValue;
+};
+
+// All presets, in the order of the preset combo box
+extern const PresetData PRESETS[];
+extern const int NUM_PRESETS;
+
+#endif // PRESETDATA_H
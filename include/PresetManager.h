@@ -7,15 +7,8 @@
 // Include GUIAppTypes.h for AppData structure
 #include "GUIAppTypes.h"
 
-// Structure to hold preset data
-struct PresetData {
-    const wchar_t* name;
-    const wchar_t* description_en;
-    const wchar_t* description_ru;
-    const wchar_t* lx, * ly, * nx, * ny;
-    const wchar_t* a11, * a12, * a22, * b1, * b2, * c, * f;
-    const wchar_t* westValue, * eastValue, * southValue, * northValue;
-};
+// Preset table (kept free of Win32 so console tools can use it)
+#include "PresetData.h"
 
 // Preset manager class to handle preset functionality
 class PresetManager {
@@ -0,0 +1,50 @@
+#ifndef QUADRATICMESH_H
+#define QUADRATICMESH_H
+
+#include "Types.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Mesh of 6-node quadratic (P2) triangles.
+// The first vertexCount nodes are the vertices of the linear mesh it was built from, in the
+// same order, followed by one node at the midpoint of every edge. Element e uses
+// connectivity[6e .. 6e + 5]: its vertices v0, v1, v2 and then the midpoints of the edges
+// opposite v0, v1 and v2. Boundary tags and sets cover the midpoint nodes as well.
+struct QuadraticMesh {
+    std::uint64_t id = 0;
+    AlignedDoubleVector x, y;
+    MeshIndexVector connectivity;
+    std::size_t vertexCount = 0;
+
+    std::vector<std::uint32_t> boundaryTags;
+    std::vector<std::string> boundaryTagNames;
+    std::vector<std::vector<MeshIndex>> boundarySets;
+
+    // Add edge midpoints to a linear mesh; boundary midpoints carry the boundaries common to
+    // both ends of their edge
+    static QuadraticMesh fromLinear(const Mesh& mesh);
+
+    // Linear mesh on the same nodes with every element split into four at its midpoints, for
+    // visualization and export of P2 solutions as their nodal values
+    Mesh subdivided() const;
+
+    // Uniform accessors (see Mesh)
+    using BoundaryRange = std::vector<MeshIndex>;
+
+    std::size_t nodeCount() const { return x.size(); }
+    std::size_t elementCount() const { return connectivity.size() / 6; }
+    bool empty() const { return x.empty(); }
+    Node node(std::size_t i) const { return Node(x[i], y[i]); }
+    std::uint32_t boundaryTag(std::size_t i) const {
+        return i < boundaryTags.size() ? boundaryTags[i] : 0u;
+    }
+    int boundaryTagBit(const std::string& name) const;
+    const BoundaryRange* findBoundary(const std::string& name) const {
+        int bit = boundaryTagBit(name);
+        return bit >= 0 ? &boundarySets[bit] : nullptr;
+    }
+};
+
+#endif // QUADRATICMESH_H
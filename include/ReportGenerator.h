@@ -13,9 +13,10 @@ public:
     ReportGenerator() = default;
     ~ReportGenerator() = default;
 
-    // Generate a detailed report of the solution
+    // Generate a detailed report of the solution (MeshType is Mesh, StructuredMeshView or MappedMesh)
+    template <class MeshType>
     void generateReport(
-        const Mesh& mesh,
+        const MeshType& mesh,
         const std::vector<double>& solution,
         const std::map<std::string, std::string>& equationCoefficients,
         const std::map<std::string, BoundaryConditionData>& boundaryConditions,
@@ -23,22 +24,25 @@ public:
     );
 
     // Export raw solution data
+    template <class MeshType>
     void exportSolutionData(
-        const Mesh& mesh,
+        const MeshType& mesh,
         const std::vector<double>& solution,
         const std::string& filename = "solution_data.txt"
     );
 
     // Export mesh data
+    template <class MeshType>
     void exportMeshData(
-        const Mesh& mesh,
+        const MeshType& mesh,
         const std::string& filename = "mesh_data.txt"
     );
 
 private:
     // Helper functions to format report sections
     std::string generateSolutionStatistics(const std::vector<double>& solution);
-    std::string generateMeshInformation(const Mesh& mesh);
+    template <class MeshType>
+    std::string generateMeshInformation(const MeshType& mesh);
     std::string generateEquationDetails(const std::map<std::string, std::string>& coefficients);
     std::string generateBoundaryConditionsDetails(const std::map<std::string, BoundaryConditionData>& boundaryConditions);
     std::string generateProcessSteps();
@@ -6,6 +6,7 @@
 #include "GUIAppTypes.h"  // For AppData
 #include <vector>
 #include <string>
+#include <memory>
 
 // Forward declarations
 class FemSolver;
@@ -51,7 +52,7 @@ private:
     FemSolver* m_solver;      // Pointer to the solver instance
     AppData* m_appData;       // Pointer to the app data
     std::vector<double> m_solution;  // Solution data
-    Mesh m_mesh;              // Mesh data
+    std::shared_ptr<const Mesh> m_mesh; // Mesh data, shared with the app
     std::string m_status;     // Solution status
 };
 
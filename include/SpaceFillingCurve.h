@@ -0,0 +1,41 @@
+#ifndef SPACEFILLINGCURVE_H
+#define SPACEFILLINGCURVE_H
+
+#include <cstdint>
+#include <utility>
+
+// Position of (x, y) along a Hilbert curve filling a 2^16 x 2^16 grid
+inline std::uint64_t hilbertIndex(std::uint32_t x, std::uint32_t y) {
+    std::uint64_t index = 0;
+    for (std::uint32_t s = 1u << 15; s > 0; s >>= 1) {
+        std::uint32_t rx = (x & s) ? 1u : 0u;
+        std::uint32_t ry = (y & s) ? 1u : 0u;
+        index += static_cast<std::uint64_t>(s) * s * ((3u * rx) ^ ry);
+        // Rotate the quadrant so the curve stays continuous
+        if (ry == 0) {
+            if (rx == 1) {
+                x = s - 1 - (x & (s - 1));
+                y = s - 1 - (y & (s - 1));
+            }
+            std::swap(x, y);
+        }
+        x &= s - 1;
+        y &= s - 1;
+    }
+    return index;
+}
+
+// Interleaved bits of x and y (Z-order) on the same 2^16 x 2^16 grid
+inline std::uint64_t mortonIndex(std::uint32_t x, std::uint32_t y) {
+    auto spread = [](std::uint64_t v) {
+        v &= 0xFFFF;
+        v = (v | (v << 8)) & 0x00FF00FFull;
+        v = (v | (v << 4)) & 0x0F0F0F0Full;
+        v = (v | (v << 2)) & 0x33333333ull;
+        v = (v | (v << 1)) & 0x55555555ull;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1);
+}
+
+#endif // SPACEFILLINGCURVE_H
@@ -0,0 +1,81 @@
+#ifndef SPARSEFEMSOLVER_H
+#define SPARSEFEMSOLVER_H
+
+#include "Types.h"
+#include "QuadraticMesh.h"
+#include "SparseMatrix.h"
+#include "StructuredMeshView.h"
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Finite element solver for -div(A grad u) + b.grad u + c u = f with sparse assembly and
+// iterative solution (conjugate gradients when the system is symmetric, BiCGSTAB otherwise).
+// Linear triangles use the element matrices of EllipticFEMSolver, so both solvers agree on a
+// Mesh. Quadratic (P2) triangles evaluate the coefficients at the points of a degree 4
+// quadrature rule, which integrates the P2 mass matrix exactly. Bilinear (Q1) quadrilaterals on
+// the cells of a structured grid use the 2 x 2 Gauss rule with sum-factorized element kernels.
+// Dirichlet values are imposed at the nodes, with the precedence of EllipticFEMSolver at nodes
+// on several boundaries. Neumann values are nodal loads for linear triangles, like in
+// EllipticFEMSolver, and flux densities integrated along the boundary edges for P2 and Q1 elements.
+class SparseFEMSolver {
+public:
+    SparseFEMSolver(
+        CoefficientFunction a11_func = nullptr,
+        CoefficientFunction a12_func = nullptr,
+        CoefficientFunction a22_func = nullptr,
+        CoefficientFunction b1_func = nullptr,
+        CoefficientFunction b2_func = nullptr,
+        CoefficientFunction c_func = nullptr,
+        CoefficientFunction f_func = nullptr
+    );
+    ~SparseFEMSolver() = default;
+
+    // Replace coefficients with batched evaluators; null entries are left unchanged
+    void setBatchCoefficients(
+        BatchCoefficientFunction a11_func, BatchCoefficientFunction a12_func, BatchCoefficientFunction a22_func,
+        BatchCoefficientFunction b1_func, BatchCoefficientFunction b2_func,
+        BatchCoefficientFunction c_func, BatchCoefficientFunction f_func
+    );
+
+    // Relative residual and iteration limit of the iterative solve
+    void setTolerance(double tolerance, int maxIterations = 10000) { tolerance_ = tolerance; maxIterations_ = maxIterations; }
+
+    // Solve with linear elements on a Mesh or quadratic elements on a QuadraticMesh
+    std::vector<double> solve(const Mesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+    std::vector<double> solve(const QuadraticMesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+    // Solve with bilinear quadrilaterals on the grid cells (not the triangles of the view). The
+    // nodes are numbered like the grid, so the solution also lives on the generated mesh.
+    std::vector<double> solve(const StructuredMeshView& grid, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+    // System before boundary conditions
+    std::pair<SparseMatrix, std::vector<double>> assemble(const Mesh& mesh) const;
+    std::pair<SparseMatrix, std::vector<double>> assemble(const QuadraticMesh& mesh) const;
+    std::pair<SparseMatrix, std::vector<double>> assemble(const StructuredMeshView& grid) const;
+
+    // Iterations and residual of the last solve
+    const IterativeSolveReport& getReport() const { return report_; }
+
+private:
+    template <class MeshType>
+    std::vector<double> solveOn(const MeshType& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+    // Dirichlet nodes and Neumann loads of a mesh
+    template <class MeshType>
+    std::vector<std::pair<MeshIndex, double>> applyBoundaryConditions(
+        const MeshType& mesh,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+        std::vector<double>& F_global
+    ) const;
+
+    BatchCoefficientFunction a11_func_, a12_func_, a22_func_;
+    BatchCoefficientFunction b1_func_, b2_func_;
+    BatchCoefficientFunction c_func_, f_func_;
+
+    double tolerance_ = 1e-10;
+    int maxIterations_ = 10000;
+    IterativeSolveReport report_;
+};
+
+#endif // SPARSEFEMSOLVER_H
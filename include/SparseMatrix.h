@@ -0,0 +1,77 @@
+#ifndef SPARSEMATRIX_H
+#define SPARSEMATRIX_H
+
+#include "Types.h"
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Square sparse matrix in compressed sparse row form with a fixed pattern.
+// Columns are sorted within each row; entries outside the pattern cannot be set.
+class SparseMatrix {
+public:
+    SparseMatrix() = default;
+
+    // Pattern of a finite element system: an entry for every pair of nodes sharing an element
+    static SparseMatrix fromElements(
+        std::size_t size, const MeshIndex* connectivity, std::size_t elementCount, int nodesPerElement
+    );
+
+    std::size_t size() const { return rowOffsets_.empty() ? 0 : rowOffsets_.size() - 1; }
+    std::size_t nonZeros() const { return values_.size(); }
+
+    // Add to an entry of the pattern
+    void add(MeshIndex row, MeshIndex column, double value) { values_[find(row, column)] += value; }
+    // Entry value, zero outside the pattern
+    double at(MeshIndex row, MeshIndex column) const;
+
+    // y = A x
+    void multiply(const std::vector<double>& x, std::vector<double>& y) const;
+
+    std::vector<double> diagonal() const;
+
+    // Replace the rows and columns of Dirichlet nodes by the identity, moving the known values
+    // to the right-hand side of the other rows (keeps a symmetric matrix symmetric)
+    void applyDirichlet(const std::vector<std::pair<MeshIndex, double>>& nodes, std::vector<double>& rhs);
+
+    // Whether the matrix equals its transpose up to a relative tolerance
+    bool isSymmetric(double tolerance = 1e-12) const;
+
+    const std::vector<std::size_t>& rowOffsets() const { return rowOffsets_; }
+    const std::vector<MeshIndex>& columns() const { return columns_; }
+    const std::vector<double>& values() const { return values_; }
+
+private:
+    // Position of an entry of the pattern (throws std::out_of_range outside it)
+    std::size_t find(MeshIndex row, MeshIndex column) const;
+
+    std::vector<std::size_t> rowOffsets_;
+    std::vector<MeshIndex> columns_;
+    std::vector<double> values_;
+};
+
+// Outcome of an iterative solve
+struct IterativeSolveReport {
+    const char* method = "";
+    int iterations = 0;
+    double relativeResidual = 0.0; // ||b - A x|| / ||b||
+    bool converged = false;
+
+    std::string describe() const;
+};
+
+// Jacobi-preconditioned conjugate gradients for symmetric positive definite matrices.
+// x holds the initial guess and receives the solution.
+IterativeSolveReport solveConjugateGradient(
+    const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x,
+    double tolerance = 1e-10, int maxIterations = 10000
+);
+
+// Jacobi-preconditioned BiCGSTAB for general nonsingular matrices
+IterativeSolveReport solveBiCGStab(
+    const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x,
+    double tolerance = 1e-10, int maxIterations = 10000
+);
+
+#endif // SPARSEMATRIX_H
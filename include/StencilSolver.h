@@ -0,0 +1,126 @@
+#ifndef STENCILSOLVER_H
+#define STENCILSOLVER_H
+
+#include "Types.h"
+#include "SparseMatrix.h"
+#include "StructuredMeshView.h"
+#include <array>
+#include <cstddef>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Linear finite element operator of a structured grid stored as per-node stencil weights
+// instead of an assembled matrix. The triangles {n1, n2, n3} and {n2, n4, n3} of every cell
+// couple node k to its west, east, south and north neighbours and along the cell diagonal to
+// k - Nx + 1 (south-east) and k + Nx - 1 (north-west), so each row has at most 7 entries.
+// Weights are kept per direction in separate aligned arrays, and the kernels sweep the grid
+// row by row: interior rows run without index checks or column lookups. When the interior
+// stencil is the same at every node (constant coefficients on a uniform grid), it can be kept
+// once, and the interior kernels then only stream the vectors.
+class StencilOperator {
+public:
+    enum Direction { Center, West, East, South, North, SouthEast, NorthWest, DirectionCount };
+
+    StencilOperator() = default;
+    // Zero weights on an Nx x Ny grid
+    StencilOperator(int Nx, int Ny);
+
+    std::size_t size() const { return static_cast<std::size_t>(Nx_) * Ny_; }
+    int getNx() const { return Nx_; }
+    int getNy() const { return Ny_; }
+
+    // Node offset of a direction
+    std::ptrdiff_t offset(Direction direction) const;
+    // Direction of a step of rows and columns (throws std::invalid_argument outside the stencil)
+    static Direction direction(int rowStep, int columnStep);
+
+    double weight(Direction direction, std::size_t node) const { return weights_[direction][node]; }
+    void addWeight(Direction direction, std::size_t node, double value) {
+        weights_[direction][node] += value;
+        constantInterior_ = false;
+    }
+
+    // Use one stencil for the nodes at least two rows and columns from the boundary if their
+    // weights agree up to a relative tolerance; returns whether they do. Changing weights
+    // afterwards goes back to the per-node weights.
+    bool detectConstantInterior(double tolerance = 1e-12);
+    bool hasConstantInterior() const { return constantInterior_; }
+
+    // y = A x
+    void multiply(const std::vector<double>& x, std::vector<double>& y) const;
+    // r = b - A x
+    void residual(const std::vector<double>& b, const std::vector<double>& x, std::vector<double>& r) const;
+    // Damped Jacobi sweeps x <- x + omega D^-1 (b - A x)
+    void smooth(const std::vector<double>& b, std::vector<double>& x, int sweeps, double omega = 2.0 / 3.0) const;
+
+    std::vector<double> diagonal() const;
+
+    // Replace the rows and columns of Dirichlet nodes by the identity, moving the known values
+    // to the right-hand side of the other rows (see SparseMatrix::applyDirichlet)
+    void applyDirichlet(const std::vector<std::pair<MeshIndex, double>>& nodes, std::vector<double>& rhs);
+
+    // Whether the operator equals its transpose up to a relative tolerance
+    bool isSymmetric(double tolerance = 1e-12) const;
+
+    // The same operator as a compressed sparse row matrix
+    SparseMatrix toSparseMatrix() const;
+
+private:
+    // out = A x, or b - A x for Residual, on the nodes of grid rows [rowBegin, rowEnd)
+    template <bool Residual>
+    void applyRows(std::size_t rowBegin, std::size_t rowEnd, const double* x, const double* b, double* out) const;
+
+    int Nx_ = 0, Ny_ = 0;
+    std::array<AlignedDoubleVector, DirectionCount> weights_;
+    bool constantInterior_ = false;
+    std::array<double, DirectionCount> interiorWeights_{}; // The stencil of the constant interior
+};
+
+// Linear triangle solver for structured grids on stencil operators: the element matrices of
+// EllipticFEMSolver with centroid coefficients are scattered into the stencil weights, and the
+// system is solved with the Krylov methods of SparseFEMSolver. Dirichlet and Neumann values are
+// imposed like in EllipticFEMSolver, with Neumann values as nodal loads.
+class StencilSolver {
+public:
+    StencilSolver(
+        CoefficientFunction a11_func = nullptr,
+        CoefficientFunction a12_func = nullptr,
+        CoefficientFunction a22_func = nullptr,
+        CoefficientFunction b1_func = nullptr,
+        CoefficientFunction b2_func = nullptr,
+        CoefficientFunction c_func = nullptr,
+        CoefficientFunction f_func = nullptr
+    );
+    ~StencilSolver() = default;
+
+    // Relative residual and iteration limit of the iterative solve
+    void setTolerance(double tolerance, int maxIterations = 10000) { tolerance_ = tolerance; maxIterations_ = maxIterations; }
+
+    std::vector<double> solve(const StructuredMeshView& grid, const std::map<std::string, BoundaryConditionData>& boundaryConditions);
+
+    // Operator and load before boundary conditions
+    std::pair<StencilOperator, std::vector<double>> assemble(const StructuredMeshView& grid) const;
+
+    // Dirichlet nodes of the grid; adds the Neumann loads to F_global
+    std::vector<std::pair<MeshIndex, double>> applyBoundaryConditions(
+        const StructuredMeshView& grid,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+        std::vector<double>& F_global
+    ) const;
+
+    // Iterations and residual of the last solve
+    const IterativeSolveReport& getReport() const { return report_; }
+
+private:
+    BatchCoefficientFunction a11_func_, a12_func_, a22_func_;
+    BatchCoefficientFunction b1_func_, b2_func_;
+    BatchCoefficientFunction c_func_, f_func_;
+
+    double tolerance_ = 1e-10;
+    int maxIterations_ = 10000;
+    IterativeSolveReport report_;
+};
+
+#endif // STENCILSOLVER_H
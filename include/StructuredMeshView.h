@@ -0,0 +1,128 @@
+#ifndef STRUCTUREDMESHVIEW_H
+#define STRUCTUREDMESHVIEW_H
+
+#include "Types.h"
+#include "AxisSpacing.h"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Node indices first, first + stride, ..., first + (count - 1) * stride
+class StridedNodeRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = MeshIndex;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const MeshIndex*;
+        using reference = MeshIndex;
+
+        iterator(MeshIndex value, MeshIndex stride) : value_(value), stride_(stride) {}
+        MeshIndex operator*() const { return value_; }
+        iterator& operator++() { value_ += stride_; return *this; }
+        iterator operator++(int) { iterator old = *this; value_ += stride_; return old; }
+        bool operator==(const iterator& other) const { return value_ == other.value_; }
+        bool operator!=(const iterator& other) const { return value_ != other.value_; }
+
+    private:
+        MeshIndex value_;
+        MeshIndex stride_;
+    };
+
+    StridedNodeRange(MeshIndex first, MeshIndex stride, MeshIndex count) : first_(first), stride_(stride), count_(count) {}
+
+    std::size_t size() const { return static_cast<std::size_t>(count_); }
+    bool empty() const { return count_ == 0; }
+    MeshIndex operator[](std::size_t k) const { return first_ + static_cast<MeshIndex>(k) * stride_; }
+    iterator begin() const { return iterator(first_, stride_); }
+    iterator end() const { return iterator(first_ + count_ * stride_, stride_); }
+
+private:
+    MeshIndex first_;
+    MeshIndex stride_;
+    MeshIndex count_;
+};
+
+// Structured triangulation of [0,Lx] x [0,Ly] that stores no node or element arrays (graded
+// axes keep only their Nx + Ny grid line coordinates).
+// Coordinates, connectivity and boundaries are computed on demand with the same numbering
+// and arithmetic as MeshGenerator::generate, so the two are interchangeable in the solver.
+class StructuredMeshView {
+public:
+    using BoundaryRange = StridedNodeRange;
+
+    StructuredMeshView(double Lx, double Ly, int Nx, int Ny,
+                       const AxisSpacing& xSpacing = AxisSpacing(), const AxisSpacing& ySpacing = AxisSpacing());
+
+    std::uint64_t id; // Unique per view (copies share it), see BoundaryValueCache
+
+    // Uniform mesh accessors (see Mesh)
+    std::size_t nodeCount() const { return static_cast<std::size_t>(Nx_) * Ny_; }
+    std::size_t elementCount() const { return 2 * static_cast<std::size_t>(Nx_ - 1) * (Ny_ - 1); }
+
+    Node node(std::size_t i) const {
+        MeshIndex row = static_cast<MeshIndex>(i / Nx_);
+        MeshIndex col = static_cast<MeshIndex>(i % Nx_);
+        if (graded_) {
+            return Node((*xs_)[col], (*ys_)[row]);
+        }
+        return Node(col * dx_, row * dy_);
+    }
+
+    // Each grid cell is split into {n1, n2, n3} and {n2, n4, n3}
+    Element element(std::size_t e) const {
+        std::size_t cell = e / 2;
+        MeshIndex i = static_cast<MeshIndex>(cell / (Nx_ - 1));
+        MeshIndex j = static_cast<MeshIndex>(cell % (Nx_ - 1));
+        MeshIndex n1 = i * Nx_ + j;
+        MeshIndex n2 = n1 + 1;
+        MeshIndex n3 = n1 + Nx_;
+        if (e % 2 == 0) {
+            return Element{ n1, n2, n3 };
+        }
+        return Element{ n2, n3 + 1, n3 };
+    }
+
+    // Boundary sides of node i, computed from its grid position (see BoundaryTags)
+    std::uint32_t boundaryTag(std::size_t i) const {
+        std::size_t row = i / Nx_;
+        std::size_t col = i % Nx_;
+        std::uint32_t tag = 0;
+        if (col == 0) tag |= BoundaryTags::West;
+        if (col == static_cast<std::size_t>(Nx_ - 1)) tag |= BoundaryTags::East;
+        if (row == 0) tag |= BoundaryTags::South;
+        if (row == static_cast<std::size_t>(Ny_ - 1)) tag |= BoundaryTags::North;
+        return tag;
+    }
+    int boundaryTagBit(const std::string& name) const;
+
+    std::optional<BoundaryRange> findBoundary(const std::string& name) const;
+    std::vector<std::string> boundaryNames() const;
+
+    // Build the equivalent explicit mesh
+    Mesh materialize() const;
+
+    // Getters
+    double getLx() const { return Lx_; }
+    double getLy() const { return Ly_; }
+    int getNx() const { return Nx_; }
+    int getNy() const { return Ny_; }
+    // Whether both axes are uniformly spaced
+    bool isUniform() const { return !graded_; }
+
+private:
+    double Lx_, Ly_;
+    int Nx_, Ny_;
+    double dx_, dy_;
+
+    // Grid line coordinates of graded axes (shared by copies)
+    bool graded_ = false;
+    std::shared_ptr<const std::vector<double>> xs_, ys_;
+};
+
+#endif // STRUCTUREDMESHVIEW_H
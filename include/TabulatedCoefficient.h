@@ -0,0 +1,97 @@
+#ifndef TABULATEDCOEFFICIENT_H
+#define TABULATEDCOEFFICIENT_H
+
+#include "Types.h"
+#include "MappedFile.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Interpolation scheme used between grid samples
+enum class GridInterpolation {
+    Bilinear,
+    Bicubic   // Catmull-Rom cubic convolution, exact for quadratics
+};
+
+// Coefficient field sampled on a regular Nx x Ny grid over [xMin, xMax] x [yMin, yMax].
+// Values are stored row by row (y outer, x inner), the same order MeshGenerator numbers nodes.
+// Points outside the grid are clamped to the nearest edge.
+class TabulatedCoefficient {
+public:
+    // Binary files at least this large stay memory-mapped instead of being copied
+    static constexpr std::size_t kMapThresholdBytes = 16u << 20;
+
+    TabulatedCoefficient(int nx, int ny, double xMin, double xMax, double yMin, double yMax,
+                         std::vector<double> values,
+                         GridInterpolation interpolation = GridInterpolation::Bilinear);
+    ~TabulatedCoefficient() = default;
+
+    // Load a comma/whitespace separated grid: one line per y-row, one column per x-sample.
+    // Lines starting with '#' are ignored.
+    static std::shared_ptr<TabulatedCoefficient> loadCSV(
+        const std::string& filename,
+        double xMin, double xMax, double yMin, double yMax,
+        GridInterpolation interpolation = GridInterpolation::Bilinear);
+
+    // Load a binary grid written by saveBinary (memory-mapped when large)
+    static std::shared_ptr<TabulatedCoefficient> loadBinary(
+        const std::string& filename,
+        GridInterpolation interpolation = GridInterpolation::Bilinear);
+
+    // Load either format, chosen by the ".csv"/".txt" extension
+    static std::shared_ptr<TabulatedCoefficient> load(
+        const std::string& filename,
+        double xMin, double xMax, double yMin, double yMax,
+        GridInterpolation interpolation = GridInterpolation::Bilinear);
+
+    // Write the grid in the binary format
+    void saveBinary(const std::string& filename) const;
+
+    // Point evaluation
+    double operator()(double x, double y) const;
+
+    // Batched evaluation: out[i] = value at (x[i], y[i]) for i in [0, n)
+    void evaluate(const double* x, const double* y, double* out, std::size_t n) const;
+
+    // Adapters for the solver interfaces; the returned functions keep the grid alive
+    static CoefficientFunction toFunction(std::shared_ptr<const TabulatedCoefficient> grid);
+    static BatchCoefficientFunction toBatchFunction(std::shared_ptr<const TabulatedCoefficient> grid);
+
+    // Setters
+    void setInterpolation(GridInterpolation interpolation) { interpolation_ = interpolation; }
+
+    // Getters
+    int getNx() const { return nx_; }
+    int getNy() const { return ny_; }
+    double getXMin() const { return xMin_; }
+    double getXMax() const { return xMax_; }
+    double getYMin() const { return yMin_; }
+    double getYMax() const { return yMax_; }
+    GridInterpolation getInterpolation() const { return interpolation_; }
+    bool isMemoryMapped() const { return mapped_.isOpen(); }
+    double sample(int i, int j) const { return values_[static_cast<std::size_t>(j) * nx_ + i]; }
+
+private:
+    TabulatedCoefficient() = default;
+
+    void initializeGeometry();
+
+    // Locate the cell containing t along one axis; returns the cell index and the local coordinate in [0, 1]
+    static void locate(double t, double tMin, double invStep, int n, int& cell, double& local);
+
+    double bilinear(double x, double y) const;
+    double bicubic(double x, double y) const;
+
+    int nx_ = 0, ny_ = 0;
+    double xMin_ = 0.0, xMax_ = 1.0, yMin_ = 0.0, yMax_ = 1.0;
+    double invDx_ = 0.0, invDy_ = 0.0;
+    GridInterpolation interpolation_ = GridInterpolation::Bilinear;
+
+    // Values either point into the owned vector or into the mapped file
+    const double* values_ = nullptr;
+    std::vector<double> storage_;
+    MappedFile mapped_;
+};
+
+#endif // TABULATEDCOEFFICIENT_H
\ No newline at end of file
@@ -7,6 +7,15 @@
 #include <functional>
 #include <memory>
 #include <array>
+#include <cstddef>
+#include <iterator>
+#include <cstdint>
+#include <atomic>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+
+#include "AlignedAllocator.h"
 
 #define _USE_MATH_DEFINES
 #include <cmath>
@@ -15,23 +24,236 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+// Node and element index type. 32-bit by default to keep connectivity compact; configure with
+// -DFEMSOLVER_INDEX64=ON (defines FEMSOLVER_INDEX64) for meshes beyond 2^31 - 1 nodes or elements.
+#ifdef FEMSOLVER_INDEX64
+using MeshIndex = std::int64_t;
+#else
+using MeshIndex = std::int32_t;
+#endif
+
+// Whether count nodes or elements can be numbered with MeshIndex
+inline bool fitsMeshIndex(std::size_t count) {
+    return count <= static_cast<std::size_t>(std::numeric_limits<MeshIndex>::max());
+}
+
+// Cache-line aligned index array (see AlignedAllocator), used for mesh connectivity
+using MeshIndexVector = std::vector<MeshIndex, AlignedAllocator<MeshIndex>>;
+
 // Type definitions
 using Node = std::pair<double, double>;
-using Element = std::array<int, 3>; // Triangle element with 3 nodes
+using Element = std::array<MeshIndex, 3>; // Triangle element with 3 nodes
 using CoefficientFunction = std::function<double(double, double)>;
+// Batched form: fills out[i] = f(x[i], y[i]) for i in [0, n)
+using BatchCoefficientFunction = std::function<void(const double*, const double*, double*, std::size_t)>;
+
+class CompiledExpression;
+class MeshAdjacency;
 
-// Boundary condition structure
+// Boundary condition structure.
+// The boundary value is taken from the first source that is set: expression, batch_func,
+// value_func, and otherwise the constant value.
 struct BoundaryConditionData {
     std::string type; // "dirichlet" or "neumann"
     CoefficientFunction value_func;
-    double value;
+    BatchCoefficientFunction batch_func;
+    std::shared_ptr<const CompiledExpression> expression; // Values are cacheable per mesh and boundary
+    double value = 0.0;
 };
 
-// Mesh structure
+// Unique identifier for a newly built mesh (0 is reserved for "unknown")
+inline std::uint64_t newMeshId() {
+    static std::atomic<std::uint64_t> counter{ 0 };
+    return ++counter;
+}
+
+// Boundary tags.
+// Every node carries a bitmask of the boundaries it lies on. Bits 0-3 are the sides of the
+// rectangular domain, further named boundaries are given the next free bit.
+namespace BoundaryTags {
+    constexpr std::uint32_t West = 1u << 0;  // x = 0
+    constexpr std::uint32_t East = 1u << 1;  // x = Lx
+    constexpr std::uint32_t South = 1u << 2; // y = 0
+    constexpr std::uint32_t North = 1u << 3; // y = Ly
+    constexpr int FirstUserBit = 4;
+    constexpr int MaxTags = 32;
+
+    // Bit of a built-in side, -1 for any other name
+    inline int builtinBit(const std::string& name) {
+        if (name == "west") return 0;
+        if (name == "east") return 1;
+        if (name == "south") return 2;
+        if (name == "north") return 3;
+        return -1;
+    }
+}
+
+// Read-only random-access range whose item i is computed by (source.*Get)(i), used for the
+// compatibility accessors of Mesh
+template <class Source, class Value, Value (Source::*Get)(std::size_t) const>
+class ComputedRange {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Value*;
+        using reference = Value;
+
+        iterator(const Source* source, std::size_t index) : source_(source), index_(index) {}
+        Value operator*() const { return (source_->*Get)(index_); }
+        iterator& operator++() { ++index_; return *this; }
+        iterator operator++(int) { iterator old = *this; ++index_; return old; }
+        bool operator==(const iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const Source* source_;
+        std::size_t index_;
+    };
+
+    ComputedRange(const Source& source, std::size_t size) : source_(&source), size_(size) {}
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    Value operator[](std::size_t i) const { return (source_->*Get)(i); }
+    Value front() const { return (*this)[0]; }
+    Value back() const { return (*this)[size_ - 1]; }
+    iterator begin() const { return iterator(source_, 0); }
+    iterator end() const { return iterator(source_, size_); }
+
+private:
+    const Source* source_;
+    std::size_t size_;
+};
+
+// Mesh structure.
+// Coordinates are stored as separate cache-line aligned x and y arrays and the connectivity as one
+// flat array of 3 node indices per element, so kernels can stream over them contiguously.
 struct Mesh {
-    std::vector<Node> nodes;
-    std::vector<Element> elements;
-    std::map<std::string, std::vector<int>> boundaries; // west, east, south, north
+    std::uint64_t id = 0; // Set by mesh builders; copies share the id, in-place edits must reset it
+    AlignedDoubleVector x, y;       // Node coordinates
+    MeshIndexVector connectivity;   // Element e uses nodes connectivity[3e], [3e + 1], [3e + 2]
+
+    // Boundaries, written through addBoundary so the three arrays stay consistent
+    std::vector<std::uint32_t> boundaryTags;      // Per node bitmask, bit b = boundaryTagNames[b]
+    std::vector<std::string> boundaryTagNames;    // Indexed by bit, empty for unused bits
+    std::vector<std::vector<MeshIndex>> boundarySets; // Indexed by bit, sorted node indices
+
+    // Node adjacency built by adjacency(); copies share it
+    mutable std::shared_ptr<const MeshAdjacency> adjacencyCache;
+
+    // Building
+    void reserve(std::size_t nodeCount, std::size_t elementCount) {
+        x.reserve(nodeCount);
+        y.reserve(nodeCount);
+        connectivity.reserve(3 * elementCount);
+    }
+    void addNode(double xCoord, double yCoord) {
+        x.push_back(xCoord);
+        y.push_back(yCoord);
+    }
+    void addElement(const Element& element) {
+        connectivity.insert(connectivity.end(), element.begin(), element.end());
+    }
+
+    // Tag nodes as lying on the named boundary (added to its set if the name already exists).
+    // Returns the bit of the boundary.
+    int addBoundary(const std::string& name, const std::vector<MeshIndex>& nodes) {
+        int bit = boundaryTagBit(name);
+        if (bit < 0) {
+            bit = BoundaryTags::builtinBit(name);
+            if (bit < 0) {
+                bit = BoundaryTags::FirstUserBit;
+                while (bit < static_cast<int>(boundaryTagNames.size()) && !boundaryTagNames[bit].empty()) {
+                    ++bit;
+                }
+                if (bit >= BoundaryTags::MaxTags) {
+                    throw std::runtime_error("Too many boundaries: at most 32 boundary tags are supported");
+                }
+            }
+            if (bit >= static_cast<int>(boundaryTagNames.size())) {
+                boundaryTagNames.resize(bit + 1);
+                boundarySets.resize(bit + 1);
+            }
+            boundaryTagNames[bit] = name;
+        }
+
+        boundaryTags.resize(nodeCount(), 0u);
+        std::vector<MeshIndex>& set = boundarySets[bit];
+        for (MeshIndex node : nodes) {
+            if (node < 0 || static_cast<std::size_t>(node) >= nodeCount()) {
+                throw std::out_of_range("Boundary node index out of range: " + name);
+            }
+            boundaryTags[node] |= 1u << bit;
+            set.push_back(node);
+        }
+        std::sort(set.begin(), set.end());
+        set.erase(std::unique(set.begin(), set.end()), set.end());
+        return bit;
+    }
+
+    // Uniform accessors shared with StructuredMeshView, for code templated on the mesh type
+    using BoundaryRange = std::vector<MeshIndex>;
+
+    std::size_t nodeCount() const { return x.size(); }
+    std::size_t elementCount() const { return connectivity.size() / 3; }
+    bool empty() const { return x.empty(); }
+    Node node(std::size_t i) const { return Node(x[i], y[i]); }
+    Element element(std::size_t e) const {
+        const MeshIndex* nodes = &connectivity[3 * e];
+        return Element{ nodes[0], nodes[1], nodes[2] };
+    }
+
+    // Compatibility accessors in the shape of the former node pair, element and boundary map
+    // members: mesh.nodes()[i].first, mesh.elements()[e][0], range-for over either, and the
+    // named boundaries (built on each call). They are meant for outside callers; loops over the
+    // mesh read x, y and connectivity directly.
+    using NodeRange = ComputedRange<Mesh, Node, &Mesh::node>;
+    using ElementRange = ComputedRange<Mesh, Element, &Mesh::element>;
+    NodeRange nodes() const { return NodeRange(*this, nodeCount()); }
+    ElementRange elements() const { return ElementRange(*this, elementCount()); }
+    std::map<std::string, std::vector<MeshIndex>> boundaries() const {
+        std::map<std::string, std::vector<MeshIndex>> result;
+        for (std::size_t bit = 0; bit < boundaryTagNames.size(); ++bit) {
+            if (!boundaryTagNames[bit].empty()) result[boundaryTagNames[bit]] = boundarySets[bit];
+        }
+        return result;
+    }
+
+    std::uint32_t boundaryTag(std::size_t i) const {
+        return i < boundaryTags.size() ? boundaryTags[i] : 0u;
+    }
+
+    // Bit of the named boundary, -1 if the mesh has no such boundary
+    int boundaryTagBit(const std::string& name) const {
+        for (std::size_t bit = 0; bit < boundaryTagNames.size(); ++bit) {
+            if (!boundaryTagNames[bit].empty() && boundaryTagNames[bit] == name) {
+                return static_cast<int>(bit);
+            }
+        }
+        return -1;
+    }
+
+    const BoundaryRange* findBoundary(const std::string& name) const {
+        int bit = boundaryTagBit(name);
+        return bit >= 0 ? &boundarySets[bit] : nullptr;
+    }
+
+    // Node-to-element and node-to-node adjacency (see MeshAdjacency), built on first use and
+    // rebuilt when the id or the sizes of the mesh change
+    std::shared_ptr<const MeshAdjacency> adjacency() const;
+
+    // Names in alphabetical order
+    std::vector<std::string> boundaryNames() const {
+        std::vector<std::string> names;
+        for (const std::string& name : boundaryTagNames) {
+            if (!name.empty()) names.push_back(name);
+        }
+        std::sort(names.begin(), names.end());
+        return names;
+    }
 };
 
 #endif // TYPES_H
\ No newline at end of file
@@ -2,11 +2,13 @@
 #define VISUALIZER_H
 
 #include "Types.h"
+#include "MeshCache.h"
 #include "ReportGenerator.h"  // Include full header since we use unique_ptr
 #include <string>
 #include <memory>
 #include <vector>
 #include <map>
+#include <optional>
 
 class Visualizer {
 public:
@@ -15,6 +17,8 @@ public:
 
     // Plot the solution
     void plotSolution(const Mesh& mesh, const std::vector<double>& solution, const std::string& title = "Solution");
+    // The same for a memory-mapped mesh, which is kept mapped rather than copied
+    void plotSolution(const MappedMesh& mesh, const std::vector<double>& solution, const std::string& title = "Solution");
 
     // Export visualization to file
     void exportPlot(const std::string& filename);
@@ -27,10 +31,18 @@ public:
         const std::map<std::string, BoundaryConditionData>& boundaryConditions,
         const std::string& filename = "fem_report.txt"
     );
+    void generateReport(
+        const MappedMesh& mesh,
+        const std::vector<double>& solution,
+        const std::map<std::string, std::string>& equationCoefficients,
+        const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+        const std::string& filename = "fem_report.txt"
+    );
 
 private:
     // Internal data for visualization
     Mesh mesh_;
+    std::optional<MappedMesh> mappedMesh_; // Plotted mesh when set, in place of mesh_
     std::vector<double> solution_;
     std::string title_;
 
@@ -0,0 +1,82 @@
+#include "AdaptiveSolver.h"
+#include "EllipticFEMSolver.h"
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+double millisecondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+AdaptiveSolver::AdaptiveSolver(EllipticFEMSolver& solver, const ErrorEstimator& estimator)
+    : solver_(solver), estimator_(estimator) {}
+
+AdaptiveSolver::Result AdaptiveSolver::solve(
+    const Mesh& initialMesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    if (!(options_.targetError > 0.0)) {
+        throw std::invalid_argument("Adaptive solve needs a positive target error");
+    }
+    if (!(options_.theta > 0.0 && options_.theta <= 1.0)) {
+        throw std::invalid_argument("Dorfler marking parameter must lie in (0, 1]");
+    }
+
+    Result result;
+    result.mesh = initialMesh;
+    MeshRefiner::labelLongestEdges(result.mesh);
+
+    for (int iteration = 0; iteration < options_.maxIterations; ++iteration) {
+        Step step;
+        step.nodes = result.mesh.nodeCount();
+        step.elements = result.mesh.elementCount();
+
+        auto start = std::chrono::steady_clock::now();
+        result.solution = solver_.solve(result.mesh, boundaryConditions);
+        step.solveMilliseconds = millisecondsSince(start);
+
+        start = std::chrono::steady_clock::now();
+        std::vector<double> indicators = estimator_.estimate(result.mesh, result.solution, boundaryConditions);
+        step.estimate = ErrorEstimator::globalEstimate(indicators);
+        step.estimateMilliseconds = millisecondsSince(start);
+
+        if (step.estimate <= options_.targetError) {
+            result.history.push_back(step);
+            result.converged = true;
+            break;
+        }
+        // The mesh is only replaced when it is solved on again, so it always matches the solution
+        if (iteration + 1 == options_.maxIterations) {
+            result.history.push_back(step);
+            break;
+        }
+
+        std::vector<MeshIndex> marked = ErrorEstimator::markDorfler(indicators, options_.theta);
+        Mesh refined = refiner_.refine(result.mesh, marked);
+        if (refined.nodeCount() > options_.maxNodes) {
+            result.history.push_back(step);
+            break;
+        }
+        step.markedElements = marked.size();
+        result.history.push_back(step);
+        result.mesh = std::move(refined);
+    }
+    return result;
+}
+
+std::string AdaptiveSolver::Result::describe() const {
+    std::ostringstream out;
+    out << "Adaptive solve: " << history.size() << " steps, "
+        << (converged ? "target reached" : "target not reached") << "\n";
+    for (std::size_t i = 0; i < history.size(); ++i) {
+        const Step& step = history[i];
+        out << "  " << i << ": " << step.nodes << " nodes, " << step.elements << " elements, estimate "
+            << step.estimate << ", marked " << step.markedElements << " (solve " << step.solveMilliseconds
+            << " ms, estimate " << step.estimateMilliseconds << " ms)\n";
+    }
+    return out.str();
+}
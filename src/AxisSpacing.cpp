@@ -0,0 +1,161 @@
+#include "AxisSpacing.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Coordinates of intervals + 1 grid lines on [0, length], clustered at 0.
+// axisIntervals is the interval count of the whole axis (the Shishkin layer width uses it).
+void clusteredAtStart(const AxisSpacing& spacing, double length, int intervals, int axisIntervals, double* out) {
+    const int M = intervals;
+    switch (spacing.kind) {
+    case AxisSpacing::Kind::Geometric: {
+        double r = spacing.ratio;
+        double total = std::pow(r, M) - 1.0;
+        for (int k = 0; k <= M; ++k) {
+            out[k] = std::abs(r - 1.0) < 1e-12 ? length * k / M : length * (std::pow(r, k) - 1.0) / total;
+        }
+        break;
+    }
+    case AxisSpacing::Kind::Shishkin: {
+        // M / 2 intervals inside the layer [0, tau], the rest outside
+        double tau = std::min(0.5 * length,
+                              spacing.sigma * spacing.epsilon / spacing.beta * std::log(static_cast<double>(axisIntervals)));
+        int inner = M / 2;
+        for (int k = 0; k <= inner; ++k) {
+            out[k] = inner > 0 ? tau * k / inner : 0.0;
+        }
+        for (int k = inner + 1; k <= M; ++k) {
+            out[k] = tau + (length - tau) * (k - inner) / (M - inner);
+        }
+        break;
+    }
+    case AxisSpacing::Kind::Tanh: {
+        double scale = std::tanh(spacing.delta);
+        for (int k = 0; k <= M; ++k) {
+            double xi = static_cast<double>(k) / M;
+            out[k] = length * (1.0 + std::tanh(spacing.delta * (xi - 1.0)) / scale);
+        }
+        break;
+    }
+    default: {
+        // Same arithmetic as the uniform generator always used (the last line may differ from
+        // length by rounding)
+        double h = length / M;
+        for (int k = 0; k <= M; ++k) {
+            out[k] = k * h;
+        }
+        return;
+    }
+    }
+    out[0] = 0.0;
+    out[M] = length;
+}
+
+const char* kindName(AxisSpacing::Kind kind) {
+    switch (kind) {
+    case AxisSpacing::Kind::Geometric: return "geometric";
+    case AxisSpacing::Kind::Shishkin: return "Shishkin";
+    case AxisSpacing::Kind::Tanh: return "tanh";
+    default: return "uniform";
+    }
+}
+
+const char* clusterName(AxisSpacing::Cluster cluster) {
+    switch (cluster) {
+    case AxisSpacing::Cluster::End: return "end";
+    case AxisSpacing::Cluster::Both: return "both ends";
+    default: return "start";
+    }
+}
+
+} // namespace
+
+AxisSpacing AxisSpacing::geometric(double ratio, Cluster cluster) {
+    if (!(ratio > 0.0)) {
+        throw std::invalid_argument("Geometric spacing needs a positive ratio");
+    }
+    AxisSpacing spacing;
+    spacing.kind = Kind::Geometric;
+    spacing.cluster = cluster;
+    spacing.ratio = ratio;
+    return spacing;
+}
+
+AxisSpacing AxisSpacing::shishkin(double epsilon, double beta, Cluster cluster, double sigma) {
+    if (!(epsilon > 0.0) || !(beta > 0.0) || !(sigma > 0.0)) {
+        throw std::invalid_argument("Shishkin spacing needs positive epsilon, beta and sigma");
+    }
+    AxisSpacing spacing;
+    spacing.kind = Kind::Shishkin;
+    spacing.cluster = cluster;
+    spacing.epsilon = epsilon;
+    spacing.beta = beta;
+    spacing.sigma = sigma;
+    return spacing;
+}
+
+AxisSpacing AxisSpacing::tanh(double delta, Cluster cluster) {
+    if (!(delta > 0.0)) {
+        throw std::invalid_argument("Tanh spacing needs a positive delta");
+    }
+    AxisSpacing spacing;
+    spacing.kind = Kind::Tanh;
+    spacing.cluster = cluster;
+    spacing.delta = delta;
+    return spacing;
+}
+
+std::vector<double> AxisSpacing::coordinates(double length, int nodes) const {
+    if (!(length > 0.0) || nodes < 2) {
+        throw std::invalid_argument("Axis spacing needs a positive length and at least 2 nodes");
+    }
+    const int M = nodes - 1;
+    std::vector<double> coords(nodes);
+
+    if (M == 1) {
+        coords[0] = 0.0;
+        coords[1] = length;
+    } else if (isUniform() || cluster == Cluster::Start) {
+        clusteredAtStart(*this, length, M, M, coords.data());
+    } else if (cluster == Cluster::End) {
+        // Mirror of the start-clustered distribution
+        std::vector<double> start(nodes);
+        clusteredAtStart(*this, length, M, M, start.data());
+        for (int k = 0; k <= M; ++k) {
+            coords[k] = length - start[M - k];
+        }
+        coords[0] = 0.0;
+    } else {
+        // Each half clustered at its outer end, meeting in the middle of the axis
+        int left = M / 2;
+        int right = M - left;
+        double half = 0.5 * length;
+        std::vector<double> start(right + 1);
+        clusteredAtStart(*this, half, left, M, coords.data());
+        clusteredAtStart(*this, half, right, M, start.data());
+        for (int k = 0; k <= right; ++k) {
+            coords[M - k] = length - start[k];
+        }
+        coords[left] = half;
+        coords[M] = length;
+    }
+    return coords;
+}
+
+std::string AxisSpacing::describe() const {
+    std::ostringstream out;
+    out << kindName(kind);
+    switch (kind) {
+    case Kind::Geometric: out << " (ratio " << ratio << ", clustered at " << clusterName(cluster) << ")"; break;
+    case Kind::Shishkin:
+        out << " (epsilon " << epsilon << ", beta " << beta << ", sigma " << sigma
+            << ", clustered at " << clusterName(cluster) << ")";
+        break;
+    case Kind::Tanh: out << " (delta " << delta << ", clustered at " << clusterName(cluster) << ")"; break;
+    default: break;
+    }
+    return out.str();
+}
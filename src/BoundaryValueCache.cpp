@@ -0,0 +1,41 @@
+#include "BoundaryValueCache.h"
+#include <algorithm>
+
+BoundaryValueCache::BoundaryValueCache(std::size_t maxEntries)
+    : maxEntries_(maxEntries > 0 ? maxEntries : 1) {
+}
+
+std::shared_ptr<const std::vector<double>> BoundaryValueCache::lookup(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+        ++misses_;
+        return nullptr;
+    }
+    it->second.lastUse = ++useCounter_;
+    ++hits_;
+    return it->second.values;
+}
+
+void BoundaryValueCache::store(const Key& key, std::shared_ptr<const std::vector<double>> values) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (entries_.size() >= maxEntries_ && entries_.find(key) == entries_.end()) {
+        // Evict the least recently used entry
+        auto oldest = std::min_element(entries_.begin(), entries_.end(),
+            [](const std::pair<const Key, Entry>& a, const std::pair<const Key, Entry>& b) {
+                return a.second.lastUse < b.second.lastUse;
+            });
+        entries_.erase(oldest);
+    }
+    entries_[key] = Entry{ std::move(values), ++useCounter_ };
+}
+
+void BoundaryValueCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+}
+
+std::size_t BoundaryValueCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
\ No newline at end of file
@@ -0,0 +1,1004 @@
+#include "DelaunayMesher.h"
+#include "SpaceFillingCurve.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+// ---------------------------------------------------------------------------------------------
+// Geometric predicates. orient2d is exact (floating-point filter, then an exact expansion sum of
+// the products); incircle is filtered and reports 0 when the sign is uncertain, which the
+// triangulation treats as "not inside".
+// ---------------------------------------------------------------------------------------------
+
+inline void twoSum(double a, double b, double& sum, double& error) {
+    sum = a + b;
+    double bVirtual = sum - a;
+    double aVirtual = sum - bVirtual;
+    error = (a - aVirtual) + (b - bVirtual);
+}
+
+double exactOrient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    // a x b + b x c + c x a, every product split exactly into a head and a tail
+    const double products[6] = { ax * by, -(ay * bx), bx * cy, -(by * cx), cx * ay, -(cy * ax) };
+    const double factors[6][2] = { { ax, by }, { -ay, bx }, { bx, cy }, { -by, cx }, { cx, ay }, { -cy, ax } };
+
+    double expansion[13];
+    int length = 0;
+    auto grow = [&](double value) {
+        for (int k = 0; k < length; ++k) {
+            double error;
+            twoSum(value, expansion[k], value, error);
+            expansion[k] = error;
+        }
+        expansion[length++] = value;
+    };
+    for (int k = 0; k < 6; ++k) {
+        grow(products[k]);
+        grow(std::fma(factors[k][0], factors[k][1], -products[k]));
+    }
+    for (int k = length - 1; k >= 0; --k) {
+        if (expansion[k] != 0.0) return expansion[k];
+    }
+    return 0.0;
+}
+
+// Positive if a, b, c are in counterclockwise order, zero if collinear
+inline double orient2d(double ax, double ay, double bx, double by, double cx, double cy) {
+    double left = (ax - cx) * (by - cy);
+    double right = (ay - cy) * (bx - cx);
+    double det = left - right;
+    double bound = 3.3306690738754716e-16 * (std::abs(left) + std::abs(right));
+    if (det > bound || -det > bound) return det;
+    return exactOrient2d(ax, ay, bx, by, cx, cy);
+}
+
+// Positive if d lies inside the circle through the counterclockwise triangle a, b, c
+inline double incircle(double ax, double ay, double bx, double by, double cx, double cy, double dx, double dy) {
+    double adx = ax - dx, ady = ay - dy;
+    double bdx = bx - dx, bdy = by - dy;
+    double cdx = cx - dx, cdy = cy - dy;
+    double alift = adx * adx + ady * ady;
+    double blift = bdx * bdx + bdy * bdy;
+    double clift = cdx * cdx + cdy * cdy;
+    double bc = bdx * cdy - bdy * cdx;
+    double ca = cdx * ady - cdy * adx;
+    double ab = adx * bdy - ady * bdx;
+    double det = alift * bc + blift * ca + clift * ab;
+    double permanent = (std::abs(bdx * cdy) + std::abs(bdy * cdx)) * alift +
+                       (std::abs(cdx * ady) + std::abs(cdy * adx)) * blift +
+                       (std::abs(adx * bdy) + std::abs(ady * bdx)) * clift;
+    double bound = 1.1102230246251577e-15 * permanent;
+    return (det > bound || -det > bound) ? det : 0.0;
+}
+
+inline std::uint64_t edgeKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(a)) << 32) | static_cast<std::uint32_t>(b);
+}
+
+// ---------------------------------------------------------------------------------------------
+// Triangulation with neighbour links. Triangle t has counterclockwise vertices v[0..2]; edge i is
+// the edge opposite v[i] (from v[i + 1] to v[i + 2]), n[i] the triangle across it (-1 if none)
+// and bit i of `constrained` marks it as a boundary segment.
+// ---------------------------------------------------------------------------------------------
+
+struct Triangle {
+    int v[3];
+    int n[3];
+    unsigned char constrained;
+};
+
+inline int next3(int i) { return i == 2 ? 0 : i + 1; }
+inline int prev3(int i) { return i == 0 ? 2 : i - 1; }
+
+class Triangulation {
+public:
+    std::vector<double> x, y;
+    std::vector<Triangle> tris;
+    std::vector<int> vertexTri;  // Some live triangle containing each vertex
+    std::size_t flips = 0;
+
+    int addVertex(double px, double py) {
+        x.push_back(px);
+        y.push_back(py);
+        vertexTri.push_back(-1);
+        vertexSlot_.push_back(-1);
+        return static_cast<int>(x.size()) - 1;
+    }
+
+    bool alive(int t) const { return tris[t].v[0] >= 0; }
+
+    double orient(int a, int b, int c) const { return orient2d(x[a], y[a], x[b], y[b], x[c], y[c]); }
+    double orient(int a, int b, double px, double py) const { return orient2d(x[a], y[a], x[b], y[b], px, py); }
+
+    // Whether (px, py) is inside the circumcircle of triangle t
+    bool inCircumcircle(int t, double px, double py) const {
+        const int* v = tris[t].v;
+        return incircle(x[v[0]], y[v[0]], x[v[1]], y[v[1]], x[v[2]], y[v[2]], px, py) > 0.0;
+    }
+
+    int newTriangle(int a, int b, int c) {
+        int t;
+        if (!free_.empty()) {
+            t = free_.back();
+            free_.pop_back();
+        } else {
+            t = static_cast<int>(tris.size());
+            tris.emplace_back();
+            cavityStamp_.push_back(0);
+        }
+        Triangle& T = tris[t];
+        T.v[0] = a; T.v[1] = b; T.v[2] = c;
+        T.n[0] = T.n[1] = T.n[2] = -1;
+        T.constrained = 0;
+        vertexTri[a] = vertexTri[b] = vertexTri[c] = t;
+        last_ = t;
+        return t;
+    }
+
+    void killTriangle(int t) {
+        tris[t].v[0] = -1;
+        free_.push_back(t);
+    }
+
+    // Replace the link of triangle t that points to `from` with `to`
+    void relink(int t, int from, int to) {
+        if (t < 0) return;
+        Triangle& T = tris[t];
+        for (int i = 0; i < 3; ++i) {
+            if (T.n[i] == from) { T.n[i] = to; return; }
+        }
+    }
+
+    int edgeIndex(int t, int a, int b) const {
+        const int* v = tris[t].v;
+        for (int i = 0; i < 3; ++i) {
+            int p = v[next3(i)], q = v[prev3(i)];
+            if ((p == a && q == b) || (p == b && q == a)) return i;
+        }
+        return -1;
+    }
+
+    // Find a triangle with edge (a, b); returns false if the edge does not exist
+    bool findEdge(int a, int b, int& t, int& i) const {
+        int start = vertexTri[a];
+        if (start < 0) return false;
+        // Rotate around a in one direction, then in the other if a lies on the mesh boundary
+        for (int direction = 0; direction < 2; ++direction) {
+            int current = start;
+            std::size_t guard = 0;
+            do {
+                int k = vertexIndex(current, a);
+                int e = edgeIndex(current, a, b);
+                if (e >= 0) { t = current; i = e; return true; }
+                current = direction == 0 ? tris[current].n[prev3(k)] : tris[current].n[next3(k)];
+                if (++guard > tris.size()) break;
+            } while (current >= 0 && current != start);
+            if (current == start) break;
+        }
+        return false;
+    }
+
+    int vertexIndex(int t, int a) const {
+        const int* v = tris[t].v;
+        return v[0] == a ? 0 : (v[1] == a ? 1 : 2);
+    }
+
+    // Walk to the triangle containing (px, py). Returns -1 if the walk leaves the mesh or is
+    // blocked by a constrained edge when stopAtConstraints is set; (blockedTri, blockedEdge)
+    // is then the edge it could not cross. onEdge is set to the edge the point lies on, onVertex
+    // to the vertex it coincides with (-1 otherwise).
+    int locate(double px, double py, int start, bool stopAtConstraints,
+               int& onEdge, int& onVertex, int& blockedTri, int& blockedEdge) {
+        int t = (start >= 0 && alive(start)) ? start : last_;
+        if (t < 0 || !alive(t)) t = anyTriangle();
+        onEdge = onVertex = blockedTri = blockedEdge = -1;
+        std::size_t guard = 0, limit = 4 * tris.size() + 64;
+        while (t >= 0) {
+            const Triangle& T = tris[t];
+            int move = -1, zeros = 0, zeroEdge = -1, nonZero = -1;
+            int r = static_cast<int>(nextRandom() % 3);
+            for (int k = 0; k < 3; ++k) {
+                int i = (r + k) % 3;
+                double o = orient(T.v[next3(i)], T.v[prev3(i)], px, py);
+                if (o < 0.0) { move = i; break; }
+                if (o == 0.0) { ++zeros; zeroEdge = i; } else { nonZero = i; }
+            }
+            if (move < 0) {
+                if (zeros == 2) onVertex = T.v[nonZero];
+                else if (zeros == 1) onEdge = zeroEdge;
+                return t;
+            }
+            if (T.n[move] < 0 || (stopAtConstraints && (T.constrained & (1 << move)))) {
+                blockedTri = t;
+                blockedEdge = move;
+                return -1;
+            }
+            t = T.n[move];
+            if (++guard > limit) return scanLocate(px, py, onEdge, onVertex);
+        }
+        return -1;
+    }
+
+    // Bowyer-Watson cavity of point (px, py): the triangles reachable from the seeds, without
+    // crossing constrained edges (other than the edge a-b being split), whose circumcircle
+    // contains the point, reduced until every boundary edge sees the point.
+    const std::vector<int>& cavity(double px, double py, const int* seeds, int seedCount, int splitA, int splitB) {
+        ++stamp_;
+        cavity_.clear();
+        for (int s = 0; s < seedCount; ++s) {
+            if (seeds[s] >= 0 && cavityStamp_[seeds[s]] != stamp_) {
+                cavityStamp_[seeds[s]] = stamp_;
+                cavity_.push_back(seeds[s]);
+            }
+        }
+        for (std::size_t head = 0; head < cavity_.size(); ++head) {
+            const Triangle& T = tris[cavity_[head]];
+            for (int i = 0; i < 3; ++i) {
+                int u = T.n[i];
+                if (u < 0 || cavityStamp_[u] == stamp_) continue;
+                if ((T.constrained & (1 << i)) && !isSplitEdge(T, i, splitA, splitB)) continue;
+                if (inCircumcircle(u, px, py)) {
+                    cavityStamp_[u] = stamp_;
+                    cavity_.push_back(u);
+                }
+            }
+        }
+
+        // Drop triangles whose outer edges do not see the point (near-degenerate cases)
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (std::size_t k = 0; k < cavity_.size() && !changed; ++k) {
+                int t = cavity_[k];
+                if (std::find(seeds, seeds + seedCount, t) != seeds + seedCount) continue;
+                const Triangle& T = tris[t];
+                for (int i = 0; i < 3; ++i) {
+                    if (T.n[i] >= 0 && cavityStamp_[T.n[i]] == stamp_) continue;
+                    if (orient(T.v[next3(i)], T.v[prev3(i)], px, py) <= 0.0) {
+                        changed = true;
+                        break;
+                    }
+                }
+                if (changed) {
+                    // Remove t and keep only the part still connected to the seeds
+                    cavityStamp_[t] = 0;
+                    std::vector<int> kept(cavity_);
+                    kept.erase(std::remove(kept.begin(), kept.end(), t), kept.end());
+                    ++stamp_;
+                    for (int member : kept) cavityStamp_[member] = -stamp_;
+                    cavity_.clear();
+                    for (int s = 0; s < seedCount; ++s) {
+                        if (seeds[s] >= 0 && cavityStamp_[seeds[s]] == -stamp_) {
+                            cavityStamp_[seeds[s]] = stamp_;
+                            cavity_.push_back(seeds[s]);
+                        }
+                    }
+                    for (std::size_t head = 0; head < cavity_.size(); ++head) {
+                        const Triangle& C = tris[cavity_[head]];
+                        for (int e = 0; e < 3; ++e) {
+                            int u = C.n[e];
+                            if (u >= 0 && cavityStamp_[u] == -stamp_) {
+                                cavityStamp_[u] = stamp_;
+                                cavity_.push_back(u);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return cavity_;
+    }
+
+    bool inCavity(int t) const { return t >= 0 && cavityStamp_[t] == stamp_; }
+
+    // Replace the current cavity by triangles fanning out from vertex p. Returns the new
+    // triangles; edges p-a and p-b become constrained when a-b was split.
+    const std::vector<int>& fillCavity(int p, int splitA, int splitB) {
+        created_.clear();
+        for (int t : cavity_) {
+            const Triangle T = tris[t];
+            for (int i = 0; i < 3; ++i) {
+                int u = T.n[i];
+                if (u >= 0 && cavityStamp_[u] == stamp_) continue;
+                int a = T.v[next3(i)], b = T.v[prev3(i)];
+                // The split edge on the mesh boundary leaves no triangle behind
+                if (u < 0 && isSplitEdge(T, i, splitA, splitB)) continue;
+
+                int nt = newTriangle(a, b, p);
+                Triangle& N = tris[nt];
+                N.n[2] = u;
+                if (T.constrained & (1 << i)) N.constrained |= 4;
+                relink(u, t, nt);
+                vertexSlot_[a] = nt;
+                created_.push_back(nt);
+            }
+        }
+
+        // Link the fan: triangle (a, b, p) borders (b, c, p) across b-p
+        for (int nt : created_) {
+            Triangle& N = tris[nt];
+            int m = vertexSlot_[N.v[1]];
+            if (m >= 0) {
+                N.n[0] = m;
+                tris[m].n[1] = nt;
+            }
+        }
+        for (int nt : created_) {
+            vertexSlot_[tris[nt].v[0]] = -1;
+            Triangle& N = tris[nt];
+            if (splitA >= 0) {
+                if (N.v[1] == splitA || N.v[1] == splitB) N.constrained |= 1; // Edge b-p
+                if (N.v[0] == splitA || N.v[0] == splitB) N.constrained |= 2; // Edge p-a
+            }
+        }
+
+        for (int t : cavity_) {
+            killTriangle(t);
+        }
+        for (int nt : created_) {
+            const Triangle& N = tris[nt];
+            vertexTri[N.v[0]] = vertexTri[N.v[1]] = vertexTri[N.v[2]] = nt;
+        }
+        if (!created_.empty()) last_ = created_.front();
+        return created_;
+    }
+
+    // Flip edge i of triangle t with the triangle across it
+    void flip(int t, int i) {
+        int u = tris[t].n[i];
+        Triangle T = tris[t];
+        Triangle U = tris[u];
+        int p = T.v[i], q = T.v[next3(i)], r = T.v[prev3(i)];
+        int j = edgeIndex(u, q, r);
+        int s = U.v[j];
+
+        // Neighbours and constraint flags of the outer edges
+        int tPQ = T.n[prev3(i)], tRP = T.n[next3(i)];
+        bool cPQ = T.constrained & (1 << prev3(i)), cRP = T.constrained & (1 << next3(i));
+        int kq = vertexIndex(u, q), kr = vertexIndex(u, r);
+        int uQS = U.n[kr], uSR = U.n[kq];
+        bool cQS = U.constrained & (1 << kr), cSR = U.constrained & (1 << kq);
+
+        // t becomes (p, q, s), u becomes (p, s, r)
+        Triangle& A = tris[t];
+        A.v[0] = p; A.v[1] = q; A.v[2] = s;
+        A.n[0] = uQS; A.n[1] = u; A.n[2] = tPQ;
+        A.constrained = static_cast<unsigned char>((cQS ? 1 : 0) | (cPQ ? 4 : 0));
+        Triangle& B = tris[u];
+        B.v[0] = p; B.v[1] = s; B.v[2] = r;
+        B.n[0] = uSR; B.n[1] = tRP; B.n[2] = t;
+        B.constrained = static_cast<unsigned char>((cSR ? 1 : 0) | (cRP ? 2 : 0));
+
+        relink(uQS, u, t);
+        relink(tRP, t, u);
+        vertexTri[p] = vertexTri[q] = vertexTri[s] = t;
+        vertexTri[r] = u;
+        ++flips;
+    }
+
+    int anyTriangle() const {
+        for (std::size_t t = 0; t < tris.size(); ++t) {
+            if (tris[t].v[0] >= 0) return static_cast<int>(t);
+        }
+        return -1;
+    }
+
+private:
+    std::vector<int> free_;
+    std::vector<int> cavityStamp_;
+    std::vector<int> cavity_;
+    std::vector<int> created_;
+    std::vector<int> vertexSlot_;
+    int stamp_ = 0;
+    int last_ = -1;
+    std::uint64_t random_ = 0x9E3779B97F4A7C15ull;
+
+    std::uint64_t nextRandom() {
+        random_ ^= random_ << 13;
+        random_ ^= random_ >> 7;
+        random_ ^= random_ << 17;
+        return random_;
+    }
+
+    bool isSplitEdge(const Triangle& T, int i, int a, int b) const {
+        if (a < 0) return false;
+        int p = T.v[next3(i)], q = T.v[prev3(i)];
+        return (p == a && q == b) || (p == b && q == a);
+    }
+
+    int scanLocate(double px, double py, int& onEdge, int& onVertex) {
+        for (std::size_t k = 0; k < tris.size(); ++k) {
+            const Triangle& T = tris[k];
+            if (T.v[0] < 0) continue;
+            int zeros = 0, zeroEdge = -1, nonZero = -1;
+            bool inside = true;
+            for (int i = 0; i < 3 && inside; ++i) {
+                double o = orient(T.v[next3(i)], T.v[prev3(i)], px, py);
+                if (o < 0.0) inside = false;
+                else if (o == 0.0) { ++zeros; zeroEdge = i; } else nonZero = i;
+            }
+            if (inside) {
+                if (zeros == 2) onVertex = T.v[nonZero];
+                else if (zeros == 1) onEdge = zeroEdge;
+                return static_cast<int>(k);
+            }
+        }
+        return -1;
+    }
+};
+
+// Squared length of the edge between two vertices
+inline double lengthSquared(const Triangulation& tri, int a, int b) {
+    double dx = tri.x[a] - tri.x[b], dy = tri.y[a] - tri.y[b];
+    return dx * dx + dy * dy;
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------------------------
+// PolygonalDomain
+// ---------------------------------------------------------------------------------------------
+
+PolygonalDomain::Loop PolygonalDomain::loop(const std::vector<Node>& points, const std::string& name) {
+    Loop result;
+    result.points = points;
+    result.edgeNames.assign(points.size(), name);
+    return result;
+}
+
+PolygonalDomain PolygonalDomain::rectangle(double Lx, double Ly) {
+    if (Lx <= 0 || Ly <= 0) {
+        throw std::invalid_argument("Invalid domain: Lx, Ly must be positive");
+    }
+    PolygonalDomain domain;
+    domain.outer.points = { { 0.0, 0.0 }, { Lx, 0.0 }, { Lx, Ly }, { 0.0, Ly } };
+    domain.outer.edgeNames = { "south", "east", "north", "west" };
+    return domain;
+}
+
+PolygonalDomain PolygonalDomain::lShape(double Lx, double Ly, double cx, double cy) {
+    if (Lx <= 0 || Ly <= 0 || cx <= 0 || cx >= Lx || cy <= 0 || cy >= Ly) {
+        throw std::invalid_argument("Invalid L-shaped domain: the corner must lie inside (0,Lx) x (0,Ly)");
+    }
+    PolygonalDomain domain;
+    domain.outer.points = { { 0.0, 0.0 }, { Lx, 0.0 }, { Lx, cy }, { cx, cy }, { cx, Ly }, { 0.0, Ly } };
+    domain.outer.edgeNames = { "south", "east", "corner", "corner", "north", "west" };
+    return domain;
+}
+
+void PolygonalDomain::addCircularHole(double cx, double cy, double radius, int segments, const std::string& name) {
+    if (radius <= 0 || segments < 3) {
+        throw std::invalid_argument("Invalid hole: radius must be positive and segments >= 3");
+    }
+    std::vector<Node> points;
+    for (int k = 0; k < segments; ++k) {
+        double angle = 2.0 * M_PI * k / segments;
+        points.emplace_back(cx + radius * std::cos(angle), cy + radius * std::sin(angle));
+    }
+    holes.push_back(loop(points, name));
+}
+
+// ---------------------------------------------------------------------------------------------
+// DelaunayMesher
+// ---------------------------------------------------------------------------------------------
+
+DelaunayMesher::DelaunayMesher() = default;
+
+DelaunayMesher::DelaunayMesher(const Options& options) : options_(options) {}
+
+Mesh DelaunayMesher::generate(const PolygonalDomain& domain) {
+    auto startTime = std::chrono::steady_clock::now();
+    statistics_ = Statistics();
+
+    // Gather the input points and segments of all loops
+    std::vector<const PolygonalDomain::Loop*> loops{ &domain.outer };
+    for (const auto& hole : domain.holes) loops.push_back(&hole);
+
+    std::vector<Node> points;
+    std::vector<std::string> names;
+    struct InputSegment { int a, b, name; };
+    std::vector<InputSegment> inputSegments;
+
+    for (std::size_t l = 0; l < loops.size(); ++l) {
+        const PolygonalDomain::Loop& loop = *loops[l];
+        const std::size_t count = loop.points.size();
+        if (count < 3) {
+            throw std::invalid_argument("Every boundary loop needs at least 3 points");
+        }
+        if (!loop.edgeNames.empty() && loop.edgeNames.size() != count) {
+            throw std::invalid_argument("Boundary loop needs one name per edge");
+        }
+        int first = static_cast<int>(points.size());
+        for (std::size_t k = 0; k < count; ++k) {
+            if (!std::isfinite(loop.points[k].first) || !std::isfinite(loop.points[k].second)) {
+                throw std::invalid_argument("Boundary point is not finite");
+            }
+            points.push_back(loop.points[k]);
+
+            std::string name = loop.edgeNames.empty() ? (l == 0 ? "boundary" : "hole" + std::to_string(l)) : loop.edgeNames[k];
+            auto it = std::find(names.begin(), names.end(), name);
+            int nameId = static_cast<int>(it - names.begin());
+            if (it == names.end()) names.push_back(name);
+            inputSegments.push_back({ first + static_cast<int>(k), first + static_cast<int>((k + 1) % count), nameId });
+        }
+    }
+    statistics_.inputPoints = points.size();
+
+    // Bounding box and super triangle
+    double xMin = points[0].first, xMax = xMin, yMin = points[0].second, yMax = yMin;
+    for (const Node& p : points) {
+        xMin = std::min(xMin, p.first); xMax = std::max(xMax, p.first);
+        yMin = std::min(yMin, p.second); yMax = std::max(yMax, p.second);
+    }
+    double extent = std::max(xMax - xMin, yMax - yMin);
+    if (!(extent > 0.0)) {
+        throw std::invalid_argument("Degenerate domain");
+    }
+    double cx = 0.5 * (xMin + xMax), cy = 0.5 * (yMin + yMax);
+
+    Triangulation tri;
+    tri.x.reserve(points.size() + 3);
+    tri.y.reserve(points.size() + 3);
+    int s0 = tri.addVertex(cx - 20.0 * extent, cy - 10.0 * extent);
+    int s1 = tri.addVertex(cx + 20.0 * extent, cy - 10.0 * extent);
+    int s2 = tri.addVertex(cx, cy + 20.0 * extent);
+    tri.newTriangle(s0, s1, s2);
+    const int superVertices = 3;
+
+    // Insert the points in Hilbert curve order, so each walk starts next to its target
+    std::vector<int> order(points.size());
+    {
+        std::vector<std::uint64_t> keys(points.size());
+        double scale = 65535.0 / extent;
+        for (std::size_t k = 0; k < points.size(); ++k) {
+            auto gx = static_cast<std::uint32_t>((points[k].first - xMin) * scale);
+            auto gy = static_cast<std::uint32_t>((points[k].second - yMin) * scale);
+            keys[k] = hilbertIndex(std::min(gx, 65535u), std::min(gy, 65535u));
+            order[k] = static_cast<int>(k);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+    }
+
+    std::vector<int> vertexOf(points.size(), -1);
+    int hint = 0;
+    for (int k : order) {
+        double px = points[k].first, py = points[k].second;
+        int onEdge, onVertex, blockedTri, blockedEdge;
+        int t = tri.locate(px, py, hint, false, onEdge, onVertex, blockedTri, blockedEdge);
+        if (t < 0) {
+            throw std::runtime_error("Delaunay mesher: point location failed");
+        }
+        if (onVertex >= 0) {
+            vertexOf[k] = onVertex; // Duplicate point
+            continue;
+        }
+        int seeds[2] = { t, onEdge >= 0 ? tri.tris[t].n[onEdge] : -1 };
+        tri.cavity(px, py, seeds, 2, -1, -1);
+        int p = tri.addVertex(px, py);
+        const std::vector<int>& created = tri.fillCavity(p, -1, -1);
+        vertexOf[k] = p;
+        hint = created.empty() ? -1 : created.front();
+    }
+
+    // Recover the boundary segments by flipping the edges that cross them
+    // Subsegment -> boundary name and the endpoints of the input segment it is part of
+    struct Subsegment { int name; int originA, originB; };
+    std::unordered_map<std::uint64_t, Subsegment> segments;
+    std::vector<std::array<int, 3>> pending;         // (a, b, name)
+    for (const InputSegment& s : inputSegments) {
+        if (vertexOf[s.a] != vertexOf[s.b]) pending.push_back({ vertexOf[s.a], vertexOf[s.b], s.name });
+    }
+    std::vector<std::pair<int, int>> crossing, created;
+    while (!pending.empty()) {
+        auto [a, b, name] = pending.back();
+        pending.pop_back();
+
+        int t, i;
+        if (tri.findEdge(a, b, t, i)) {
+            tri.tris[t].constrained |= static_cast<unsigned char>(1 << i);
+            int u = tri.tris[t].n[i];
+            if (u >= 0) tri.tris[u].constrained |= static_cast<unsigned char>(1 << tri.edgeIndex(u, a, b));
+            segments[edgeKey(a, b)] = { name, a, b };
+            continue;
+        }
+
+        // Find the triangle around a whose opposite edge the segment leaves through, and walk
+        // along the segment collecting the crossed edges as (left, right) of a -> b
+        crossing.clear();
+        int collinear = -1;
+        int current = tri.vertexTri[a];
+        int left = -1, right = -1;
+        for (std::size_t guard = 0; guard <= tri.tris.size(); ++guard) {
+            int k = tri.vertexIndex(current, a);
+            int q = tri.tris[current].v[next3(k)], r = tri.tris[current].v[prev3(k)];
+            double oq = tri.orient(a, b, q), orr = tri.orient(a, b, r);
+            auto ahead = [&](int v) {
+                return (tri.x[v] - tri.x[a]) * (tri.x[b] - tri.x[a]) + (tri.y[v] - tri.y[a]) * (tri.y[b] - tri.y[a]) > 0.0;
+            };
+            if (oq == 0.0 && ahead(q)) { collinear = q; break; }
+            if (orr == 0.0 && ahead(r)) { collinear = r; break; }
+            if (oq < 0.0 && orr > 0.0) { right = q; left = r; break; }
+            current = tri.tris[current].n[prev3(k)];
+        }
+        if (collinear < 0 && left < 0) {
+            throw std::runtime_error("Delaunay mesher: could not recover a boundary segment");
+        }
+        while (collinear < 0) {
+            crossing.emplace_back(left, right);
+            int e = tri.edgeIndex(current, left, right);
+            int u = tri.tris[current].n[e];
+            if (tri.tris[current].constrained & (1 << e)) {
+                throw std::invalid_argument("Boundary segments intersect");
+            }
+            int s = tri.tris[u].v[tri.edgeIndex(u, left, right)];
+            if (s == b) break;
+            double o = tri.orient(a, b, s);
+            if (o == 0.0) { collinear = s; break; }
+            if (o > 0.0) left = s; else right = s;
+            current = u;
+        }
+        if (collinear >= 0) {
+            // A vertex lies on the segment: recover the two parts instead
+            pending.push_back({ collinear, b, name });
+            pending.push_back({ a, collinear, name });
+            continue;
+        }
+
+        // Flip crossing edges (Sloan); edges of non-convex quadrilaterals are retried later
+        created.clear();
+        std::size_t idle = 0;
+        std::size_t head = 0;
+        while (head < crossing.size()) {
+            auto [u0, v0] = crossing[head++];
+            int ct, ci;
+            if (!tri.findEdge(u0, v0, ct, ci)) continue;
+            int nt = tri.tris[ct].n[ci];
+            int p = tri.tris[ct].v[ci];
+            int s = tri.tris[nt].v[tri.edgeIndex(nt, u0, v0)];
+            if (tri.orient(p, s, u0) * tri.orient(p, s, v0) >= 0.0) {
+                crossing.emplace_back(u0, v0);
+                if (++idle > 2 * (crossing.size() - head) + 16) {
+                    throw std::runtime_error("Delaunay mesher: boundary recovery did not converge");
+                }
+                continue;
+            }
+            idle = 0;
+            tri.flip(ct, ci);
+            bool pSide = tri.orient(a, b, p) > 0.0, sSide = tri.orient(a, b, s) > 0.0;
+            if ((p == a || p == b || s == a || s == b) || tri.orient(a, b, p) == 0.0 || tri.orient(a, b, s) == 0.0 ||
+                pSide == sSide) {
+                created.emplace_back(p, s);
+            } else {
+                crossing.emplace_back(p, s);
+            }
+        }
+        if (!tri.findEdge(a, b, t, i)) {
+            throw std::runtime_error("Delaunay mesher: boundary recovery failed");
+        }
+        tri.tris[t].constrained |= static_cast<unsigned char>(1 << i);
+        int u = tri.tris[t].n[i];
+        if (u >= 0) tri.tris[u].constrained |= static_cast<unsigned char>(1 << tri.edgeIndex(u, a, b));
+        segments[edgeKey(a, b)] = { name, a, b };
+
+        // Restore the Delaunay property of the new edges (the segment itself stays)
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (auto& edge : created) {
+                int et, ei;
+                if (!tri.findEdge(edge.first, edge.second, et, ei)) continue;
+                if (tri.tris[et].constrained & (1 << ei)) continue;
+                int en = tri.tris[et].n[ei];
+                if (en < 0) continue;
+                int p = tri.tris[et].v[ei];
+                int s = tri.tris[en].v[tri.edgeIndex(en, edge.first, edge.second)];
+                if (tri.inCircumcircle(et, tri.x[s], tri.y[s])) {
+                    tri.flip(et, ei);
+                    edge = { p, s };
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // Remove the triangles outside the domain and inside holes: flood fill from the super
+    // triangle, counting the boundary segments crossed; the domain has odd parity
+    std::vector<int> parity(tri.tris.size(), -1);
+    std::vector<int> layer, nextLayer;
+    for (std::size_t t = 0; t < tri.tris.size(); ++t) {
+        if (!tri.alive(static_cast<int>(t))) continue;
+        const int* v = tri.tris[t].v;
+        if (v[0] < superVertices || v[1] < superVertices || v[2] < superVertices) {
+            parity[t] = 0;
+            layer.push_back(static_cast<int>(t));
+        }
+    }
+    for (int level = 0; !layer.empty(); ++level) {
+        nextLayer.clear();
+        for (std::size_t head = 0; head < layer.size(); ++head) {
+            const Triangle& T = tri.tris[layer[head]];
+            for (int i = 0; i < 3; ++i) {
+                int u = T.n[i];
+                if (u < 0 || parity[u] >= 0) continue;
+                if (T.constrained & (1 << i)) {
+                    nextLayer.push_back(u);
+                } else {
+                    parity[u] = level;
+                    layer.push_back(u);
+                }
+            }
+        }
+        layer.clear();
+        for (int u : nextLayer) {
+            if (parity[u] < 0) {
+                parity[u] = level + 1;
+                layer.push_back(u);
+            }
+        }
+    }
+    for (std::size_t t = 0; t < tri.tris.size(); ++t) {
+        if (tri.alive(static_cast<int>(t)) && parity[t] % 2 == 0) {
+            Triangle& T = tri.tris[t];
+            for (int i = 0; i < 3; ++i) {
+                if (T.n[i] >= 0) tri.relink(T.n[i], static_cast<int>(t), -1);
+            }
+            tri.killTriangle(static_cast<int>(t));
+        }
+    }
+    for (std::size_t t = 0; t < tri.tris.size(); ++t) {
+        if (!tri.alive(static_cast<int>(t))) continue;
+        const int* v = tri.tris[t].v;
+        for (int k = 0; k < 3; ++k) tri.vertexTri[v[k]] = static_cast<int>(t);
+    }
+
+    // Ruppert refinement
+    const bool refine = options_.minAngleDegrees > 0.0 || options_.maxArea > 0.0 || options_.sizeFunction;
+    if (refine) {
+        const double minAngle = std::min(options_.minAngleDegrees, 60.0) * M_PI / 180.0;
+        const double maxRatio = minAngle > 0.0 ? 1.0 / (2.0 * std::sin(minAngle)) : std::numeric_limits<double>::infinity();
+        const int firstSteiner = static_cast<int>(tri.x.size());
+
+        auto isInput = [&](int v) { return v < firstSteiner; };
+        // Input segment each Steiner point was placed on (-1 for circumcenters)
+        std::vector<std::array<int, 2>> steinerSegment;
+        auto segmentOf = [&](int v) {
+            return isInput(v) ? std::array<int, 2>{ { -1, -1 } } : steinerSegment[v - firstSteiner];
+        };
+
+        // Whether the shortest edge p-q joins two segments at the same distance from the input
+        // vertex they share: splitting such a triangle near a small input angle never ends
+        // (the equidistant points come from the concentric shell splits below)
+        auto acrossSmallAngle = [&](int p, int q) {
+            std::array<int, 2> sp = segmentOf(p), sq = segmentOf(q);
+            if (sp[0] < 0 || sq[0] < 0) return false;
+            int apex = -1;
+            for (int a : sp) {
+                if (a == sq[0] || a == sq[1]) apex = a;
+            }
+            if (apex < 0 || (sp[0] == sq[0] && sp[1] == sq[1]) || (sp[0] == sq[1] && sp[1] == sq[0])) return false;
+            double dp = lengthSquared(tri, apex, p), dq = lengthSquared(tri, apex, q);
+            return std::abs(dp - dq) <= 1e-6 * std::max(dp, dq);
+        };
+
+        // Vertex strictly inside the diametral circle of a-b
+        auto encroaches = [&](int a, int b, double px, double py) {
+            return (tri.x[a] - px) * (tri.x[b] - px) + (tri.y[a] - py) * (tri.y[b] - py) < 0.0;
+        };
+        auto isEncroached = [&](int a, int b) {
+            int t, i;
+            if (!tri.findEdge(a, b, t, i)) return false;
+            int apex = tri.tris[t].v[i];
+            if (encroaches(a, b, tri.x[apex], tri.y[apex])) return true;
+            int u = tri.tris[t].n[i];
+            if (u < 0) return false;
+            int other = tri.tris[u].v[tri.edgeIndex(u, a, b)];
+            return encroaches(a, b, tri.x[other], tri.y[other]);
+        };
+
+        auto isBad = [&](int t) {
+            const int* v = tri.tris[t].v;
+            double l0 = lengthSquared(tri, v[1], v[2]);
+            double l1 = lengthSquared(tri, v[2], v[0]);
+            double l2 = lengthSquared(tri, v[0], v[1]);
+            double area = 0.5 * tri.orient(v[0], v[1], v[2]);
+            if (!(area > 0.0)) return false;
+            if (options_.maxArea > 0.0 && area > options_.maxArea) return true;
+            double shortest = std::min({ l0, l1, l2 });
+            int s = shortest == l0 ? 0 : (shortest == l1 ? 1 : 2);
+            if (minAngle > 0.0 && !acrossSmallAngle(v[next3(s)], v[prev3(s)])) {
+                // Circumradius over shortest edge, squared: R^2 = l0 l1 l2 / (16 area^2)
+                double ratio2 = l0 * l1 * l2 / (16.0 * area * area) / shortest;
+                if (ratio2 > maxRatio * maxRatio) return true;
+            }
+            if (options_.sizeFunction) {
+                double mx = (tri.x[v[0]] + tri.x[v[1]] + tri.x[v[2]]) / 3.0;
+                double my = (tri.y[v[0]] + tri.y[v[1]] + tri.y[v[2]]) / 3.0;
+                double h = options_.sizeFunction(mx, my);
+                if (h > 0.0 && std::max({ l0, l1, l2 }) > h * h) return true;
+            }
+            return false;
+        };
+
+        struct Candidate { int t; int v0, v1, v2; };
+        std::vector<Candidate> badQueue;
+        std::vector<std::pair<int, int>> segmentQueue;
+        auto pushTriangle = [&](int t) {
+            const int* v = tri.tris[t].v;
+            badQueue.push_back({ t, v[0], v[1], v[2] });
+        };
+        auto pushConstrainedEdges = [&](int t) {
+            const Triangle& T = tri.tris[t];
+            for (int i = 0; i < 3; ++i) {
+                if (T.constrained & (1 << i)) segmentQueue.emplace_back(T.v[next3(i)], T.v[prev3(i)]);
+            }
+        };
+
+        for (const auto& segment : segments) {
+            segmentQueue.emplace_back(static_cast<int>(segment.first >> 32), static_cast<int>(segment.first & 0xFFFFFFFFu));
+        }
+        for (std::size_t t = 0; t < tri.tris.size(); ++t) {
+            if (tri.alive(static_cast<int>(t))) pushTriangle(static_cast<int>(t));
+        }
+
+        auto splitSegment = [&](int a, int b) {
+            int t, i;
+            if (!tri.findEdge(a, b, t, i)) return false;
+            // Midpoint, or a power-of-two distance from an input vertex (concentric shells) so
+            // that splits near small input angles stop
+            double ax = tri.x[a], ay = tri.y[a], bx = tri.x[b], by = tri.y[b];
+            double length = std::sqrt(lengthSquared(tri, a, b));
+            double fraction = 0.5;
+            if (isInput(a) != isInput(b)) {
+                double shell = std::exp2(std::round(std::log2(0.5 * length)));
+                fraction = std::clamp(shell / length, 0.25, 0.75);
+                if (!isInput(a)) fraction = 1.0 - fraction;
+            }
+            double px = ax + fraction * (bx - ax), py = ay + fraction * (by - ay);
+
+            int seeds[2] = { t, tri.tris[t].n[i] };
+            tri.cavity(px, py, seeds, 2, a, b);
+            int p = tri.addVertex(px, py);
+            const std::vector<int>& created = tri.fillCavity(p, a, b);
+            auto it = segments.find(edgeKey(a, b));
+            Subsegment parent = it->second;
+            segments.erase(it);
+            segments[edgeKey(a, p)] = parent;
+            segments[edgeKey(p, b)] = parent;
+            steinerSegment.push_back({ { parent.originA, parent.originB } });
+            for (int nt : created) {
+                pushTriangle(nt);
+                pushConstrainedEdges(nt);
+            }
+            ++statistics_.steinerPoints;
+            return true;
+        };
+
+        while (statistics_.steinerPoints < options_.maxSteinerPoints) {
+            if (!segmentQueue.empty()) {
+                auto [a, b] = segmentQueue.back();
+                segmentQueue.pop_back();
+                if (segments.count(edgeKey(a, b)) && isEncroached(a, b)) splitSegment(a, b);
+                continue;
+            }
+            if (badQueue.empty()) break;
+
+            Candidate c = badQueue.back();
+            badQueue.pop_back();
+            const Triangle& T = tri.tris[c.t];
+            if (!tri.alive(c.t) || T.v[0] != c.v0 || T.v[1] != c.v1 || T.v[2] != c.v2 || !isBad(c.t)) continue;
+
+            // Circumcenter, relative to v0 for accuracy
+            double ax = tri.x[c.v0], ay = tri.y[c.v0];
+            double bx = tri.x[c.v1] - ax, by = tri.y[c.v1] - ay;
+            double qx = tri.x[c.v2] - ax, qy = tri.y[c.v2] - ay;
+            double d = 2.0 * (bx * qy - by * qx);
+            double b2 = bx * bx + by * by, q2 = qx * qx + qy * qy;
+            double px = ax + (qy * b2 - by * q2) / d;
+            double py = ay + (bx * q2 - qx * b2) / d;
+
+            int onEdge, onVertex, blockedTri, blockedEdge;
+            int t = tri.locate(px, py, c.t, true, onEdge, onVertex, blockedTri, blockedEdge);
+            if (t < 0) {
+                // Behind a segment: split it if the circumcenter encroaches it
+                if (blockedTri >= 0 && (tri.tris[blockedTri].constrained & (1 << blockedEdge))) {
+                    const Triangle& B = tri.tris[blockedTri];
+                    int a = B.v[next3(blockedEdge)], b = B.v[prev3(blockedEdge)];
+                    if (encroaches(a, b, px, py) && splitSegment(a, b)) badQueue.push_back(c);
+                }
+                continue;
+            }
+            if (onVertex >= 0) continue;
+            if (onEdge >= 0 && (tri.tris[t].constrained & (1 << onEdge))) {
+                const Triangle& E = tri.tris[t];
+                if (splitSegment(E.v[next3(onEdge)], E.v[prev3(onEdge)])) badQueue.push_back(c);
+                continue;
+            }
+
+            // Reject circumcenters that encroach a segment; split those segments instead
+            int seeds[2] = { t, onEdge >= 0 ? tri.tris[t].n[onEdge] : -1 };
+            const std::vector<int>& cavity = tri.cavity(px, py, seeds, 2, -1, -1);
+            std::vector<std::pair<int, int>> encroached;
+            for (int member : cavity) {
+                const Triangle& M = tri.tris[member];
+                for (int i = 0; i < 3; ++i) {
+                    if (!(M.constrained & (1 << i))) continue;
+                    if (M.n[i] >= 0 && tri.inCavity(M.n[i])) continue;
+                    int a = M.v[next3(i)], b = M.v[prev3(i)];
+                    if (encroaches(a, b, px, py)) encroached.emplace_back(a, b);
+                }
+            }
+            if (!encroached.empty()) {
+                for (auto [a, b] : encroached) {
+                    if (segments.count(edgeKey(a, b))) splitSegment(a, b);
+                }
+                badQueue.push_back(c);
+                continue;
+            }
+
+            int p = tri.addVertex(px, py);
+            steinerSegment.push_back({ { -1, -1 } });
+            const std::vector<int>& created = tri.fillCavity(p, -1, -1);
+            for (int nt : created) {
+                pushTriangle(nt);
+                pushConstrainedEdges(nt);
+            }
+            ++statistics_.steinerPoints;
+        }
+    }
+
+    // Build the mesh from the live triangles, numbering only the vertices they use
+    Mesh mesh;
+    mesh.id = newMeshId();
+    std::vector<MeshIndex> nodeOf(tri.x.size(), -1);
+    std::vector<char> used(tri.x.size(), 0);
+    std::size_t liveTriangles = 0;
+    for (std::size_t t = 0; t < tri.tris.size(); ++t) {
+        if (!tri.alive(static_cast<int>(t))) continue;
+        ++liveTriangles;
+        for (int v : tri.tris[t].v) used[v] = 1;
+    }
+    mesh.reserve(tri.x.size(), liveTriangles);
+    for (std::size_t v = superVertices; v < tri.x.size(); ++v) {
+        if (used[v]) {
+            nodeOf[v] = static_cast<MeshIndex>(mesh.nodeCount());
+            mesh.addNode(tri.x[v], tri.y[v]);
+        }
+    }
+
+    double minAngle = M_PI;
+    for (std::size_t t = 0; t < tri.tris.size(); ++t) {
+        if (!tri.alive(static_cast<int>(t))) continue;
+        const int* v = tri.tris[t].v;
+        if (nodeOf[v[0]] < 0 || nodeOf[v[1]] < 0 || nodeOf[v[2]] < 0) {
+            throw std::runtime_error("Delaunay mesher: triangle references a removed vertex");
+        }
+        mesh.addElement(Element{ nodeOf[v[0]], nodeOf[v[1]], nodeOf[v[2]] });
+
+        for (int k = 0; k < 3; ++k) {
+            double ux = tri.x[v[next3(k)]] - tri.x[v[k]], uy = tri.y[v[next3(k)]] - tri.y[v[k]];
+            double wx = tri.x[v[prev3(k)]] - tri.x[v[k]], wy = tri.y[v[prev3(k)]] - tri.y[v[k]];
+            minAngle = std::min(minAngle, std::atan2(std::abs(ux * wy - uy * wx), ux * wx + uy * wy));
+        }
+    }
+
+    std::vector<std::vector<MeshIndex>> boundaryNodes(names.size());
+    for (const auto& segment : segments) {
+        int a = static_cast<int>(segment.first >> 32), b = static_cast<int>(segment.first & 0xFFFFFFFFu);
+        if (nodeOf[a] >= 0) boundaryNodes[segment.second.name].push_back(nodeOf[a]);
+        if (nodeOf[b] >= 0) boundaryNodes[segment.second.name].push_back(nodeOf[b]);
+    }
+    for (std::size_t k = 0; k < names.size(); ++k) {
+        mesh.addBoundary(names[k], boundaryNodes[k]);
+    }
+
+    statistics_.triangles = mesh.elementCount();
+    statistics_.flips = tri.flips;
+    statistics_.minAngleDegrees = mesh.elementCount() > 0 ? minAngle * 180.0 / M_PI : 0.0;
+    statistics_.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return mesh;
+}
@@ -1,11 +1,22 @@
 #include "EllipticApp.h"
 #include "GUIApp.h"
 #include "MeshGenerator.h"
+#include "GmshReader.h"
+#include "MeshCache.h"
 #include "FunctionParser.h"
 #include "EllipticFEMSolver.h"
+#include "BoundaryValueCache.h"
+#include "OperatorAnalyzer.h"
+#include "ErrorEstimator.h"
+#include "AdaptiveSolver.h"
+#include "GoalOrientedSolver.h"
+#include "QuadraticMesh.h"
+#include "SparseFEMSolver.h"
+#include "StencilSolver.h"
 #include "Visualizer.h"
 #include <iostream>
 #include <memory>
+#include <stdexcept>
 #include <string>
 
 #ifdef _WIN32
@@ -16,11 +27,13 @@
 EllipticApp::EllipticApp()
     : Lx_(1.0), Ly_(1.0), Nx_(10), Ny_(10),
       a11_func_(nullptr), a12_func_(nullptr), a22_func_(nullptr),
-      b1_func_(nullptr), b2_func_(nullptr), c_func_(nullptr), f_func_(nullptr) {
+      b1_func_(nullptr), b2_func_(nullptr), c_func_(nullptr), f_func_(nullptr),
+      operatorIsSPD_(false) {
 
     // Initialize components
     meshGenerator_ = std::make_unique<MeshGenerator>(Lx_, Ly_, Nx_, Ny_);
     femSolver_ = std::make_unique<EllipticFEMSolver>();
+    boundaryCache_ = std::make_shared<BoundaryValueCache>();
     visualizer_ = std::make_unique<Visualizer>();
     guiApp_ = std::make_unique<GUIApp>();
 
@@ -86,11 +99,26 @@ void EllipticApp::generateMesh() {
                   << " and " << Nx_ << " x " << Ny_ << " nodes" << std::endl;
         #endif
 
-        currentMesh_ = std::make_unique<Mesh>(meshGenerator_->generate());
+        meshGenerator_->setSpacing(xSpacing_, ySpacing_);
+        MeshKey key{ meshGenerator_->getLx(), meshGenerator_->getLy(), meshGenerator_->getNx(), meshGenerator_->getNy(),
+                     meshGenerator_->getXSpacing(), meshGenerator_->getYSpacing() };
+        if (currentMesh_ && currentMeshKey_ && *currentMeshKey_ == key) {
+            #ifdef _DEBUG
+            std::cout << "Mesh unchanged, reusing " << currentMesh_->nodeCount() << " nodes" << std::endl;
+            #endif
+            return;
+        }
+
+        currentMesh_ = std::make_shared<const Mesh>(meshGenerator_->generate());
+        currentMeshKey_ = key;
+        currentGrid_ = meshGenerator_->view();
+        solutionMesh_.reset();
+        mappedMesh_.reset();
+        mappedMeshCopy_.reset();
 
         #ifdef _DEBUG
-        std::cout << "Mesh generated with " << currentMesh_->nodes.size()
-                  << " nodes and " << currentMesh_->elements.size() << " elements" << std::endl;
+        std::cout << "Mesh generated with " << currentMesh_->nodeCount()
+                  << " nodes and " << currentMesh_->elementCount() << " elements" << std::endl;
         #endif
     } catch (const std::exception& e) {
         #ifdef _DEBUG
@@ -104,9 +132,99 @@ void EllipticApp::generateMesh() {
     }
 }
 
+void EllipticApp::loadMesh(const std::string& filename) {
+    try {
+        if (MeshCache::isCacheFile(filename)) {
+            // Kept mapped: the solver and the report read the arrays in the shared pages
+            mappedMesh_ = MeshCache::open(filename);
+            mappedMeshCopy_.reset();
+            currentMesh_.reset();
+            currentMeshKey_.reset();
+            currentGrid_.reset();
+            solutionMesh_.reset();
+
+            #ifdef _DEBUG
+            std::cout << "Mesh loaded from cache " << filename << " with " << mappedMesh_->nodeCount() << " nodes and "
+                      << mappedMesh_->elementCount() << " elements" << std::endl;
+            #endif
+            return;
+        }
+
+        GmshReader reader;
+        currentMesh_ = std::make_shared<const Mesh>(reader.read(filename));
+        currentMeshKey_.reset();
+        currentGrid_.reset();
+        solutionMesh_.reset();
+        mappedMesh_.reset();
+        mappedMeshCopy_.reset();
+
+        #ifdef _DEBUG
+        const GmshReader::Statistics& stats = reader.getStatistics();
+        std::cout << "Mesh loaded from " << filename << " with " << stats.nodes << " nodes, "
+                  << stats.triangles << " elements and " << stats.physicalGroups << " boundaries in "
+                  << stats.milliseconds << " ms" << std::endl;
+        #endif
+    } catch (const std::exception& e) {
+        #ifdef _DEBUG
+        std::cerr << "Error loading mesh: " << e.what() << std::endl;
+        #else
+        #ifdef _WIN32
+        MessageBox(NULL, ("Error loading mesh: " + std::string(e.what())).c_str(), "Error", MB_OK | MB_ICONERROR);
+        #endif
+        #endif
+        throw;
+    }
+}
+
+void EllipticApp::saveMeshCache(const std::string& filename) const {
+    if (!hasMesh()) {
+        throw std::runtime_error("No mesh available. Generate mesh first.");
+    }
+    MeshCache::write(*explicitMesh(), filename);
+}
+
+void EllipticApp::configureSolver() {
+    // Update the solver with current coefficient functions. The solver is kept, so its
+    // renumbering of an unchanged mesh carries over to the next solve.
+    if (batchCoefficients_) {
+        const BatchCoefficients& batch = *batchCoefficients_;
+        femSolver_->setBatchCoefficients(batch.a11, batch.a12, batch.a22, batch.b1, batch.b2, batch.c, batch.f);
+    } else {
+        femSolver_->setBatchCoefficients(
+            EllipticFEMSolver::toBatchFunction(a11_func_), EllipticFEMSolver::toBatchFunction(a12_func_),
+            EllipticFEMSolver::toBatchFunction(a22_func_), EllipticFEMSolver::toBatchFunction(b1_func_),
+            EllipticFEMSolver::toBatchFunction(b2_func_), EllipticFEMSolver::toBatchFunction(c_func_),
+            EllipticFEMSolver::toBatchFunction(f_func_)
+        );
+    }
+    femSolver_->setAssembler(staticAssembler_);
+    femSolver_->setBoundaryValueCache(boundaryCache_);
+    femSolver_->setLinearSolver(operatorIsSPD_ ? EllipticFEMSolver::LinearSolver::Cholesky
+                                               : EllipticFEMSolver::LinearSolver::GaussianElimination);
+    // Cholesky only works within the matrix profile, so give it a banded numbering
+    femSolver_->setNodeOrdering(operatorIsSPD_ ? NodeOrdering::ReverseCuthillMcKee : NodeOrdering::Original);
+}
+
+std::shared_ptr<const Mesh> EllipticApp::explicitMesh() const {
+    if (currentMesh_ || !mappedMesh_) {
+        return currentMesh_;
+    }
+    if (!mappedMeshCopy_) {
+        mappedMeshCopy_ = std::make_shared<const Mesh>(mappedMesh_->toMesh());
+    }
+    return mappedMeshCopy_;
+}
+
+void EllipticApp::setElementOrder(int order) {
+    if (order != 1 && order != 2) {
+        throw std::invalid_argument("Element order must be 1 or 2");
+    }
+    elementOrder_ = order;
+}
+
 void EllipticApp::solveProblem() {
     try {
-        if (!currentMesh_) {
+        if (!hasMesh()) {
             throw std::runtime_error("No mesh available. Generate mesh first.");
         }
 
@@ -114,14 +232,74 @@ void EllipticApp::solveProblem() {
         std::cout << "Solving problem..." << std::endl;
         #endif
 
-        // Update the solver with current coefficient functions
-        femSolver_ = std::make_unique<EllipticFEMSolver>(
-            a11_func_, a12_func_, a22_func_,
-            b1_func_, b2_func_, c_func_, f_func_
-        );
+        configureSolver();
 
         // Solve the problem
-        currentSolution_ = femSolver_->solve(*currentMesh_, boundaryConditions_);
+        if (elementOrder_ == 2) {
+            QuadraticMesh quadratic = QuadraticMesh::fromLinear(*explicitMesh());
+            SparseFEMSolver sparseSolver(a11_func_, a12_func_, a22_func_, b1_func_, b2_func_, c_func_, f_func_);
+            currentSolution_ = sparseSolver.solve(quadratic, boundaryConditions_);
+            solutionMesh_ = std::make_shared<const Mesh>(quadratic.subdivided());
+
+            #ifdef _DEBUG
+            std::cout << sparseSolver.getReport().describe();
+            #endif
+        } else if (quadrilateralElements_) {
+            const std::optional<StructuredMeshView>& grid = currentGrid_;
+            if (!grid) {
+                throw std::runtime_error("Quadrilateral elements need a generated mesh");
+            }
+            SparseFEMSolver sparseSolver(a11_func_, a12_func_, a22_func_, b1_func_, b2_func_, c_func_, f_func_);
+            currentSolution_ = sparseSolver.solve(*grid, boundaryConditions_);
+            solutionMesh_ = currentMesh_;
+
+            #ifdef _DEBUG
+            std::cout << sparseSolver.getReport().describe();
+            #endif
+        } else if (const std::optional<StructuredMeshView>& grid = currentGrid_;
+                   grid && constantOperator_ && FastPoissonSolver::supports(*grid, *constantOperator_, boundaryConditions_)) {
+            // Constant coefficients on a uniform rectangle with Dirichlet and Neumann sides:
+            // diagonalized by sine and cosine transforms, unless cell counts with large prime
+            // factors make the transforms slower than conjugate gradients on the stencil
+            if (FastPoissonSolver::isFasterThanIteration(*grid, *constantOperator_, boundaryConditions_)) {
+                FastPoissonSolver fastSolver(*constantOperator_, f_func_);
+                currentSolution_ = fastSolver.solve(*grid, boundaryConditions_);
+
+                #ifdef _DEBUG
+                std::cout << fastSolver.getReport().describe();
+                #endif
+            } else {
+                StencilSolver stencilSolver(a11_func_, a12_func_, a22_func_, b1_func_, b2_func_, c_func_, f_func_);
+                currentSolution_ = stencilSolver.solve(*grid, boundaryConditions_);
+
+                #ifdef _DEBUG
+                std::cout << stencilSolver.getReport().describe();
+                #endif
+            }
+            solutionMesh_ = currentMesh_;
+        } else if (grid && grid->isUniform() && staticAssembler_ && staticAssembler_->hasUniformOperator()) {
+            // Constant operator on a uniform grid: assembled from reference element matrices on
+            // the grid view, whose natural numbering is already banded
+            currentSolution_ = femSolver_->solve(*grid, boundaryConditions_);
+            solutionMesh_ = currentMesh_;
+
+            #ifdef _DEBUG
+            std::cout << "Assembled from reference element matrices of the uniform grid" << std::endl;
+            #endif
+        } else if (mappedMesh_) {
+            // Solved on the mapped arrays without copying the mesh
+            currentSolution_ = femSolver_->solve(*mappedMesh_, boundaryConditions_);
+            solutionMesh_.reset();
+        } else {
+            currentSolution_ = femSolver_->solve(*currentMesh_, boundaryConditions_);
+            solutionMesh_ = currentMesh_;
+
+            #ifdef _DEBUG
+            if (femSolver_->getNodeOrdering() != NodeOrdering::Original) {
+                std::cout << femSolver_->getRenumberingReport().describe();
+            }
+            #endif
+        }
 
         #ifdef _DEBUG
         std::cout << "Problem solved. Solution computed for "
@@ -139,13 +317,89 @@ void EllipticApp::solveProblem() {
     }
 }
 
+void EllipticApp::solveAdaptively(double targetError) {
+    try {
+        if (!hasMesh()) {
+            throw std::runtime_error("No mesh available. Generate mesh first.");
+        }
+
+        configureSolver();
+        ErrorEstimator estimator(a11_func_, a12_func_, a22_func_, b1_func_, b2_func_, c_func_, f_func_);
+        AdaptiveSolver adaptive(*femSolver_, estimator);
+        AdaptiveSolver::Options options;
+        options.targetError = targetError;
+        adaptive.setOptions(options);
+        AdaptiveSolver::Result result = adaptive.solve(*explicitMesh(), boundaryConditions_);
+
+        // The refined mesh no longer matches the generator parameters
+        currentMesh_ = std::make_shared<const Mesh>(std::move(result.mesh));
+        currentMeshKey_.reset();
+        currentGrid_.reset();
+        mappedMesh_.reset();
+        mappedMeshCopy_.reset();
+        currentSolution_ = std::move(result.solution);
+        solutionMesh_ = currentMesh_;
+
+        #ifdef _DEBUG
+        std::cout << result.describe();
+        #endif
+    } catch (const std::exception& e) {
+        #ifdef _DEBUG
+        std::cerr << "Error solving problem: " << e.what() << std::endl;
+        #else
+        #ifdef _WIN32
+        MessageBox(NULL, ("Error solving problem: " + std::string(e.what())).c_str(), "Error", MB_OK | MB_ICONERROR);
+        #endif
+        #endif
+        throw;
+    }
+}
+
+double EllipticApp::solveForQuantity(const QuantityOfInterest& quantity, double targetError) {
+    try {
+        if (!hasMesh()) {
+            throw std::runtime_error("No mesh available. Generate mesh first.");
+        }
+
+        configureSolver();
+        ErrorEstimator estimator(a11_func_, a12_func_, a22_func_, b1_func_, b2_func_, c_func_, f_func_);
+        GoalOrientedSolver goal(*femSolver_, estimator, quantity);
+        GoalOrientedSolver::Options options;
+        options.targetError = targetError;
+        goal.setOptions(options);
+        GoalOrientedSolver::Result result = goal.solve(*explicitMesh(), boundaryConditions_);
+
+        currentMesh_ = std::make_shared<const Mesh>(std::move(result.mesh));
+        currentMeshKey_.reset();
+        currentGrid_.reset();
+        mappedMesh_.reset();
+        mappedMeshCopy_.reset();
+        currentSolution_ = std::move(result.solution);
+        solutionMesh_ = currentMesh_;
+
+        #ifdef _DEBUG
+        std::cout << result.describe();
+        #endif
+        return result.value;
+    } catch (const std::exception& e) {
+        #ifdef _DEBUG
+        std::cerr << "Error solving problem: " << e.what() << std::endl;
+        #else
+        #ifdef _WIN32
+        MessageBox(NULL, ("Error solving problem: " + std::string(e.what())).c_str(), "Error", MB_OK | MB_ICONERROR);
+        #endif
+        #endif
+        throw;
+    }
+}
+
 void EllipticApp::plotSolution() {
     try {
         if (currentSolution_.empty()) {
             throw std::runtime_error("No solution available to plot.");
         }
 
-        if (!currentMesh_) {
+        if (!hasMesh()) {
             throw std::runtime_error("No mesh available for plotting.");
         }
 
@@ -153,8 +407,12 @@ void EllipticApp::plotSolution() {
         std::cout << "Plotting solution..." << std::endl;
         #endif
 
-        // Plot the solution
-        visualizer_->plotSolution(*currentMesh_, currentSolution_, "FEM Solution");
+        // Plot the solution, on the mapped arrays when the solve ran on a loaded cache file
+        if (!solutionMesh_ && mappedMesh_) {
+            visualizer_->plotSolution(*mappedMesh_, currentSolution_, "FEM Solution");
+        } else {
+            visualizer_->plotSolution(getMesh(), currentSolution_, "FEM Solution");
+        }
 
         // Export the plot data
         exportResults();
@@ -185,9 +443,17 @@ void EllipticApp::exportResults() {
         coefficients["c"] = "0.0";
         coefficients["f"] = "1.0";
 
-        if (currentMesh_) {
+        if (!solutionMesh_ && mappedMesh_) {
+            visualizer_->generateReport(
+                *mappedMesh_,
+                currentSolution_,
+                coefficients,
+                boundaryConditions_,
+                "fem_detailed_report.txt"
+            );
+        } else if (hasMesh()) {
             visualizer_->generateReport(
-                *currentMesh_,
+                getMesh(),
                 currentSolution_,
                 coefficients,
                 boundaryConditions_,
@@ -208,20 +474,22 @@ void EllipticApp::exportResults() {
 
 void EllipticApp::resetProblem() {
     currentMesh_.reset();
+    currentMeshKey_.reset();
+    currentGrid_.reset();
     currentSolution_.clear();
+    solutionMesh_.reset();
+    mappedMesh_.reset();
+    mappedMeshCopy_.reset();
 
     // Reset to default values
     Lx_ = 1.0; Ly_ = 1.0;
     Nx_ = 10; Ny_ = 10;
 
     // Reset coefficient functions to default
-    a11_func_ = [](double, double) -> double { return 1.0; };
-    a12_func_ = [](double, double) -> double { return 0.0; };
-    a22_func_ = [](double, double) -> double { return 1.0; };
-    b1_func_ = [](double, double) -> double { return 0.0; };
-    b2_func_ = [](double, double) -> double { return 0.0; };
-    c_func_ = [](double, double) -> double { return 0.0; };
-    f_func_ = [](double, double) -> double { return 1.0; };
+    setStaticCoefficients(makeCoefficientSet(
+        ConstantCoefficient{ 1.0 }, ZeroCoefficient{}, ConstantCoefficient{ 1.0 },
+        ZeroCoefficient{}, ZeroCoefficient{}, ZeroCoefficient{}, ConstantCoefficient{ 1.0 }
+    ));
 
     // Reset boundary conditions
     boundaryConditions_.clear();
@@ -242,6 +510,10 @@ void EllipticApp::setCoefficientFunctions(
     b2_func_ = std::move(b2);
     c_func_ = std::move(c);
     f_func_ = std::move(f);
+    staticAssembler_.reset();
+    constantOperator_.reset();
+    batchCoefficients_.reset();
+    operatorIsSPD_ = false;
 }
 
 void EllipticApp::setupPoissonProblem() {
@@ -254,21 +526,18 @@ void EllipticApp::setupPoissonProblem() {
 
     // Coefficients for -Laplacian u = -(d²u/dx² + d²u/dy²) = f
     // This corresponds to: a11=1, a22=1, a12=b1=b2=c=0, f=function
-    a11_func_ = [](double, double) -> double { return 1.0; };
-    a12_func_ = [](double, double) -> double { return 0.0; };
-    a22_func_ = [](double, double) -> double { return 1.0; };
-    b1_func_ = [](double, double) -> double { return 0.0; };
-    b2_func_ = [](double, double) -> double { return 0.0; };
-    c_func_ = [](double, double) -> double { return 0.0; };
-    f_func_ = [](double x, double y) -> double {
-        // Example: f(x,y) = 2*pi*pi*sin(pi*x)*sin(pi*y) with solution u = sin(pi*x)*sin(pi*y)
-        return 2.0 * M_PI * M_PI * std::sin(M_PI * x) * std::sin(M_PI * y);
-    };
+    setStaticCoefficients(makeCoefficientSet(
+        ConstantCoefficient{ 1.0 }, ZeroCoefficient{}, ConstantCoefficient{ 1.0 },
+        ZeroCoefficient{}, ZeroCoefficient{}, ZeroCoefficient{},
+        [](double x, double y) -> double {
+            // Example: f(x,y) = 2*pi*pi*sin(pi*x)*sin(pi*y) with solution u = sin(pi*x)*sin(pi*y)
+            return 2.0 * M_PI * M_PI * std::sin(M_PI * x) * std::sin(M_PI * y);
+        }
+    ));
 
     // Set up Dirichlet boundary conditions (u = 0 on all boundaries)
     BoundaryConditionData zeroBC;
     zeroBC.type = "dirichlet";
-    zeroBC.value_func = [](double, double) -> double { return 0.0; };
     zeroBC.value = 0.0;
 
     boundaryConditions_["west"] = zeroBC;
@@ -287,19 +556,15 @@ void EllipticApp::setupLaplaceProblem() {
     Nx_ = 15;
     Ny_ = 15;
 
-    a11_func_ = [](double, double) -> double { return 1.0; };
-    a12_func_ = [](double, double) -> double { return 0.0; };
-    a22_func_ = [](double, double) -> double { return 1.0; };
-    b1_func_ = [](double, double) -> double { return 0.0; };
-    b2_func_ = [](double, double) -> double { return 0.0; };
-    c_func_ = [](double, double) -> double { return 0.0; };
-    f_func_ = [](double, double) -> double { return 0.0; };
+    setStaticCoefficients(makeCoefficientSet(
+        ConstantCoefficient{ 1.0 }, ZeroCoefficient{}, ConstantCoefficient{ 1.0 },
+        ZeroCoefficient{}, ZeroCoefficient{}, ZeroCoefficient{}, ZeroCoefficient{}
+    ));
 
     // Example boundary conditions: u = x^2 + y^2 on all boundaries
     BoundaryConditionData bc;
     bc.type = "dirichlet";
-    bc.value_func = [](double x, double y) -> double { return x*x + y*y; };
-    bc.value = 0.0;
+    bc.expression = FunctionParser::compile("x*x + y*y");
 
     boundaryConditions_["west"] = bc;
     boundaryConditions_["east"] = bc;
@@ -316,31 +581,26 @@ void EllipticApp::setupHelmholtzProblem() {
     Nx_ = 30;
     Ny_ = 10;
 
-    a11_func_ = [](double, double) -> double { return 1.0; };
-    a12_func_ = [](double, double) -> double { return 0.0; };
-    a22_func_ = [](double, double) -> double { return 1.0; };
-    b1_func_ = [](double, double) -> double { return 0.0; };
-    b2_func_ = [](double, double) -> double { return 0.0; };
-    c_func_ = [](double, double) -> double { return 1.0; };  // Coefficient for u term
-    f_func_ = [](double x, double y) -> double {
-        return std::cos(M_PI*x/3.0) * std::cos(M_PI*y);
-    };
+    setStaticCoefficients(makeCoefficientSet(
+        ConstantCoefficient{ 1.0 }, ZeroCoefficient{}, ConstantCoefficient{ 1.0 },
+        ZeroCoefficient{}, ZeroCoefficient{},
+        ConstantCoefficient{ 1.0 },  // Coefficient for u term
+        [](double x, double y) -> double {
+            return std::cos(M_PI*x/3.0) * std::cos(M_PI*y);
+        }
+    ));
 
     // Mixed boundary conditions
     BoundaryConditionData neumannBC, dirichletBC;
 
     // West: Neumann boundary condition
     neumannBC.type = "neumann";
-    neumannBC.value_func = [](double, double) -> double { return 0.0; };
     neumannBC.value = 0.0;
     boundaryConditions_["west"] = neumannBC;
 
     // Others: Dirichlet boundary conditions
     dirichletBC.type = "dirichlet";
-    dirichletBC.value_func = [](double x, double y) -> double {
-        return std::cos(M_PI*x/3.0) * std::cos(M_PI*y);
-    };
-    dirichletBC.value = 0.0;
+    dirichletBC.expression = FunctionParser::compile("cos(pi*x/3) * cos(pi*y)");
     boundaryConditions_["east"] = dirichletBC;
     boundaryConditions_["south"] = dirichletBC;
     boundaryConditions_["north"] = dirichletBC;
@@ -356,15 +616,15 @@ void EllipticApp::setupConvectionDiffusionProblem() {
     Ny_ = 20;
 
     // Variable diffusion coefficients
-    a11_func_ = [](double x, double) -> double { return 0.01 + 0.005*x; };
-    a12_func_ = [](double, double) -> double { return 0.0; };
-    a22_func_ = [](double x, double) -> double { return 0.01 + 0.005*x; };
-    b1_func_ = [](double, double) -> double { return 1.0; };  // Convection in x direction
-    b2_func_ = [](double, double) -> double { return 0.0; };
-    c_func_ = [](double, double) -> double { return 0.0; };
-    f_func_ = [](double x, double y) -> double {
-        return std::exp(-10.0 * ((x-2.0)*(x-2.0) + (y-0.5)*(y-0.5)));
-    };
+    auto diffusion = [](double x, double) -> double { return 0.01 + 0.005*x; };
+    setStaticCoefficients(makeCoefficientSet(
+        diffusion, ZeroCoefficient{}, diffusion,
+        ConstantCoefficient{ 1.0 }, ZeroCoefficient{},  // Convection in x direction
+        ZeroCoefficient{},
+        [](double x, double y) -> double {
+            return std::exp(-10.0 * ((x-2.0)*(x-2.0) + (y-0.5)*(y-0.5)));
+        }
+    ));
 
     // Boundary conditions
     BoundaryConditionData dirichletBC, neumannBC;
@@ -397,16 +657,16 @@ void EllipticApp::setupReactionDiffusionProblem() {
     Ny_ = 30;
 
     // Variable diffusion coefficients
-    a11_func_ = [](double x, double y) -> double { return 0.1 + 0.05*x*y; };
-    a12_func_ = [](double, double) -> double { return 0.0; };
-    a22_func_ = [](double x, double y) -> double { return 0.1 + 0.05*x*y; };
-    b1_func_ = [](double, double) -> double { return 0.0; };
-    b2_func_ = [](double, double) -> double { return 0.0; };
-    c_func_ = [](double, double) -> double { return 1.0; };  // Reaction term
-    f_func_ = [](double x, double y) -> double {
-        return 10.0 * std::exp(-5.0 * ((x-1.0)*(x-1.0) + (y-1.0)*(y-1.0))) +
-               2.0 * M_PI * M_PI * std::cos(M_PI*x) * std::cos(M_PI*y);
-    };
+    auto diffusion = [](double x, double y) -> double { return 0.1 + 0.05*x*y; };
+    setStaticCoefficients(makeCoefficientSet(
+        diffusion, ZeroCoefficient{}, diffusion,
+        ZeroCoefficient{}, ZeroCoefficient{},
+        ConstantCoefficient{ 1.0 },  // Reaction term
+        [](double x, double y) -> double {
+            return 10.0 * std::exp(-5.0 * ((x-1.0)*(x-1.0) + (y-1.0)*(y-1.0))) +
+                   2.0 * M_PI * M_PI * std::cos(M_PI*x) * std::cos(M_PI*y);
+        }
+    ));
 
     // Mixed boundary conditions
     BoundaryConditionData dirichletBC, neumannBC;
@@ -414,19 +674,15 @@ void EllipticApp::setupReactionDiffusionProblem() {
     dirichletBC.type = "dirichlet";
     neumannBC.type = "neumann";
 
-    dirichletBC.value_func = [](double, double) -> double { return 20.0; };
     dirichletBC.value = 20.0;
     boundaryConditions_["west"] = dirichletBC;
 
-    dirichletBC.value_func = [](double, double) -> double { return 10.0; };
     dirichletBC.value = 10.0;
     boundaryConditions_["east"] = dirichletBC;
 
-    dirichletBC.value_func = [](double, double) -> double { return 15.0; };
     dirichletBC.value = 15.0;
     boundaryConditions_["south"] = dirichletBC;
 
-    neumannBC.value_func = [](double, double) -> double { return 5.0; };
     neumannBC.value = 5.0;
     boundaryConditions_["north"] = neumannBC;
 
@@ -447,14 +703,27 @@ void EllipticApp::solveWithParameters(
         Nx_ = Nx;
         Ny_ = Ny;
 
-        // Parse coefficient functions
-        a11_func_ = FunctionParser::parseFunction(a11);
-        a12_func_ = FunctionParser::parseFunction(a12);
-        a22_func_ = FunctionParser::parseFunction(a22);
-        b1_func_ = FunctionParser::parseFunction(b1);
-        b2_func_ = FunctionParser::parseFunction(b2);
-        c_func_ = FunctionParser::parseFunction(c);
-        f_func_ = FunctionParser::parseFunction(f);
+        // Compile each coefficient once; the point and batched functions, the operator
+        // analysis and the constant operator check all share the compiled programs
+        auto a11Expression = FunctionParser::compile(a11), a12Expression = FunctionParser::compile(a12);
+        auto a22Expression = FunctionParser::compile(a22), b1Expression = FunctionParser::compile(b1);
+        auto b2Expression = FunctionParser::compile(b2), cExpression = FunctionParser::compile(c);
+        auto fExpression = FunctionParser::compile(f);
+        a11_func_ = FunctionParser::toFunction(a11Expression);
+        a12_func_ = FunctionParser::toFunction(a12Expression);
+        a22_func_ = FunctionParser::toFunction(a22Expression);
+        b1_func_ = FunctionParser::toFunction(b1Expression);
+        b2_func_ = FunctionParser::toFunction(b2Expression);
+        c_func_ = FunctionParser::toFunction(cExpression);
+        f_func_ = FunctionParser::toFunction(fExpression);
+        batchCoefficients_ = BatchCoefficients{
+            FunctionParser::toBatchFunction(a11Expression), FunctionParser::toBatchFunction(a12Expression),
+            FunctionParser::toBatchFunction(a22Expression), FunctionParser::toBatchFunction(b1Expression),
+            FunctionParser::toBatchFunction(b2Expression), FunctionParser::toBatchFunction(cExpression),
+            FunctionParser::toBatchFunction(fExpression)
+        };
+        staticAssembler_.reset();
+        constantOperator_.reset();
 
         // Setup boundary conditions
         boundaryConditions_.clear();
@@ -463,30 +732,42 @@ void EllipticApp::solveWithParameters(
         BoundaryConditionData westBCData;
         westBCData.type = westBC;
         westBCData.value = westVal;
-        westBCData.value_func = [westVal](double, double) -> double { return westVal; }; // Simple constant
         boundaryConditions_["west"] = westBCData;
 
         // East boundary
         BoundaryConditionData eastBCData;
         eastBCData.type = eastBC;
         eastBCData.value = eastVal;
-        eastBCData.value_func = [eastVal](double, double) -> double { return eastVal; };
         boundaryConditions_["east"] = eastBCData;
 
         // South boundary
         BoundaryConditionData southBCData;
         southBCData.type = southBC;
         southBCData.value = southVal;
-        southBCData.value_func = [southVal](double, double) -> double { return southVal; };
         boundaryConditions_["south"] = southBCData;
 
         // North boundary
         BoundaryConditionData northBCData;
         northBCData.type = northBC;
         northBCData.value = northVal;
-        northBCData.value_func = [northVal](double, double) -> double { return northVal; };
         boundaryConditions_["north"] = northBCData;
 
+        // Check the operator on the domain to pick the linear solver
+        bool hasDirichlet = westBC == "dirichlet" || eastBC == "dirichlet" ||
+                            southBC == "dirichlet" || northBC == "dirichlet";
+        OperatorAnalyzer analyzer;
+        OperatorAnalyzer::Report report = analyzer.analyze(
+            *a11Expression, *a12Expression, *a22Expression, *b1Expression, *b2Expression, *cExpression,
+            Lx_, Ly_, hasDirichlet
+        );
+        operatorIsSPD_ = report.classification == OperatorAnalyzer::OperatorClass::SymmetricPositiveDefinite;
+        constantOperator_ = FastPoissonSolver::fromExpressions(
+            *a11Expression, *a12Expression, *a22Expression, *b1Expression, *b2Expression, *cExpression);
+
+        #ifdef _DEBUG
+        std::cout << report.describe();
+        #endif
+
         // Generate mesh with new parameters
         meshGenerator_ = std::make_unique<MeshGenerator>(Lx_, Ly_, Nx_, Ny_);
         generateMesh();
@@ -13,284 +13,282 @@ EllipticFEMSolver::EllipticFEMSolver(
     CoefficientFunction b2_func,
     CoefficientFunction c_func,
     CoefficientFunction f_func
-) : a11_func_(a11_func ? a11_func : [](double, double) -> double { return 0.0; }),
-    a12_func_(a12_func ? a12_func : [](double, double) -> double { return 0.0; }),
-    a22_func_(a22_func ? a22_func : [](double, double) -> double { return 0.0; }),
-    b1_func_(b1_func ? b1_func : [](double, double) -> double { return 0.0; }),
-    b2_func_(b2_func ? b2_func : [](double, double) -> double { return 0.0; }),
-    c_func_(c_func ? c_func : [](double, double) -> double { return 0.0; }),
-    f_func_(f_func ? f_func : [](double, double) -> double { return 0.0; })
+) : a11_func_(toBatchFunction(a11_func)),
+    a12_func_(toBatchFunction(a12_func)),
+    a22_func_(toBatchFunction(a22_func)),
+    b1_func_(toBatchFunction(b1_func)),
+    b2_func_(toBatchFunction(b2_func)),
+    c_func_(toBatchFunction(c_func)),
+    f_func_(toBatchFunction(f_func))
 {
 }
 
-std::vector<double> EllipticFEMSolver::solve(const Mesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
-    // Assemble global matrix and vector
-    auto [K_global, F_global] = assembleGlobalMatrix(mesh);
-    
-    // Apply boundary conditions
-    applyBoundaryConditions(K_global, F_global, mesh, boundaryConditions);
-    
-    // Solve the linear system (using a simple Gaussian elimination for now)
-    // In a real implementation, you'd want to use a proper linear solver
-    std::vector<double> solution = solveLinearSystem(K_global, F_global);
-    
-    return solution;
+void EllipticFEMSolver::setBatchCoefficients(
+    BatchCoefficientFunction a11_func, BatchCoefficientFunction a12_func, BatchCoefficientFunction a22_func,
+    BatchCoefficientFunction b1_func, BatchCoefficientFunction b2_func,
+    BatchCoefficientFunction c_func, BatchCoefficientFunction f_func
+) {
+    if (a11_func) a11_func_ = std::move(a11_func);
+    if (a12_func) a12_func_ = std::move(a12_func);
+    if (a22_func) a22_func_ = std::move(a22_func);
+    if (b1_func) b1_func_ = std::move(b1_func);
+    if (b2_func) b2_func_ = std::move(b2_func);
+    if (c_func) c_func_ = std::move(c_func);
+    if (f_func) f_func_ = std::move(f_func);
 }
 
-std::pair<std::vector<std::vector<double>>, std::vector<double>> 
-EllipticFEMSolver::assembleGlobalMatrix(const Mesh& mesh) {
-    int nNodes = static_cast<int>(mesh.nodes.size());
-    
-    // Initialize global matrices
-    std::vector<std::vector<double>> K_global(nNodes, std::vector<double>(nNodes, 0.0));
-    std::vector<double> F_global(nNodes, 0.0);
-    
-    // Assemble by elements
-    for (const auto& element : mesh.elements) {
-        // Get coordinates of the element nodes
-        std::vector<Node> coords = {
-            mesh.nodes[element[0]],
-            mesh.nodes[element[1]],
-            mesh.nodes[element[2]]
+BatchCoefficientFunction EllipticFEMSolver::toBatchFunction(CoefficientFunction func) {
+    if (!func) {
+        return [](const double*, const double*, double* out, std::size_t n) {
+            std::fill(out, out + n, 0.0);
         };
-        
-        // Compute local matrices
-        auto Ee = localEllipticMatrix(coords);
-        auto Ce = localConvectionMatrix(coords);
-        auto Re = localReactionMatrix(coords);
-        auto Fe = localLoadVector(coords);
-        
-        // Assemble into global matrix
-        for (int i = 0; i < 3; ++i) {
-            for (int j = 0; j < 3; ++j) {
-                K_global[element[i]][element[j]] += Ee[i][j] + Ce[i][j] + Re[i][j];
-            }
-            F_global[element[i]] += Fe[i];
+    }
+    return [func](const double* x, const double* y, double* out, std::size_t n) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = func(x[i], y[i]);
         }
+    };
+}
+
+std::vector<double> EllipticFEMSolver::solve(const Mesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    if (nodeOrdering_ == NodeOrdering::Original) {
+        return solveOn(mesh, boundaryConditions);
     }
-    
-    return std::make_pair(K_global, F_global);
+
+    // Solve on the renumbered copy and return the solution in the caller's node order
+    return permutation_.toOriginalOrder(solveOn(renumbered(mesh), boundaryConditions));
 }
 
-void EllipticFEMSolver::applyBoundaryConditions(
-    std::vector<std::vector<double>>& K_global,
-    std::vector<double>& F_global,
+std::vector<double> EllipticFEMSolver::solve(const StructuredMeshView& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    return solveOn(mesh, boundaryConditions);
+}
+
+std::vector<double> EllipticFEMSolver::solve(const MappedMesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    return solveOn(mesh, boundaryConditions);
+}
+
+std::vector<double> EllipticFEMSolver::solveAdjoint(
     const Mesh& mesh,
-    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+    const std::vector<double>& load
 ) {
-    const int nNodes = static_cast<int>(mesh.nodes.size());
-    std::vector<bool> isDirichletNode(nNodes, false);
-    std::vector<double> dirichletValues(nNodes, 0.0);
+    if (load.size() != mesh.nodeCount()) {
+        throw std::invalid_argument("Adjoint load needs one value per mesh node");
+    }
+    if (nodeOrdering_ == NodeOrdering::Original) {
+        return solveAdjointOn(mesh, boundaryConditions, load);
+    }
+    const Mesh& renumberedMesh = renumbered(mesh);
+    return permutation_.toOriginalOrder(
+        solveAdjointOn(renumberedMesh, boundaryConditions, permutation_.toRenumberedOrder(load)));
+}
+
+std::vector<double> EllipticFEMSolver::residual(
+    const Mesh& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+    const std::vector<double>& solution
+) {
+    if (solution.size() != mesh.nodeCount()) {
+        throw std::invalid_argument("Residual needs one solution value per mesh node");
+    }
+    auto [K_global, F_global] = assembleGlobalMatrix(mesh);
 
-    // First, identify all Dirichlet nodes and their values
+    // Neumann loads only, so the Dirichlet rows keep their equations
+    std::map<std::string, BoundaryConditionData> neumannConditions;
     for (const auto& pair : boundaryConditions) {
-        const BoundaryConditionData& bcData = pair.second;
-        if (bcData.type == "dirichlet") {
-            auto boundaryIt = mesh.boundaries.find(pair.first);
-            if (boundaryIt != mesh.boundaries.end()) {
-                for (int nodeIdx : boundaryIt->second) {
-                    isDirichletNode[nodeIdx] = true;
-                    double x = mesh.nodes[nodeIdx].first;
-                    double y = mesh.nodes[nodeIdx].second;
-                    dirichletValues[nodeIdx] = bcData.value_func ? bcData.value_func(x, y) : bcData.value;
-                }
-            }
-        }
+        if (pair.second.type == "neumann") neumannConditions.insert(pair);
     }
+    applyBoundaryConditions(K_global, F_global, mesh, neumannConditions);
 
-    // Modify the right-hand side (F_global) for Dirichlet conditions ("lifting")
-    for (int i = 0; i < nNodes; ++i) {
-        if (!isDirichletNode[i]) {
-            for (int j = 0; j < nNodes; ++j) {
-                if (isDirichletNode[j]) {
-                    F_global[i] -= K_global[i][j] * dirichletValues[j];
-                }
-            }
+    std::vector<double> r(mesh.nodeCount());
+    for (std::size_t i = 0; i < r.size(); ++i) {
+        const std::vector<double>& row = K_global[i];
+        double sum = -F_global[i];
+        for (std::size_t j = 0; j < r.size(); ++j) {
+            sum += row[j] * solution[j];
         }
+        r[i] = sum;
     }
+    return r;
+}
 
-    // Now, modify the matrix and RHS for Dirichlet nodes and apply Neumann conditions
-    for (const auto& pair : boundaryConditions) {
-        const std::string& boundaryName = pair.first;
-        const BoundaryConditionData& bcData = pair.second;
+const Mesh& EllipticFEMSolver::renumbered(const Mesh& mesh) {
+    if (!renumberedMesh_ || mesh.id == 0 || renumberedSourceId_ != mesh.id) {
+        MeshRenumberer renumberer(nodeOrdering_);
+        renumberedMesh_ = std::make_shared<const Mesh>(renumberer.renumber(mesh, permutation_, renumberingReport_));
+        renumberedSourceId_ = mesh.id;
+    }
+    return *renumberedMesh_;
+}
 
-        auto boundaryIt = mesh.boundaries.find(boundaryName);
-        if (boundaryIt == mesh.boundaries.end()) continue;
+std::pair<std::vector<std::vector<double>>, std::vector<double>>
+EllipticFEMSolver::assembleGlobalMatrix(const Mesh& mesh) {
+    return assembleOn(mesh);
+}
 
-        const std::vector<int>& boundaryNodes = boundaryIt->second;
+std::pair<std::vector<std::vector<double>>, std::vector<double>>
+EllipticFEMSolver::assembleGlobalMatrix(const StructuredMeshView& mesh) {
+    return assembleOn(mesh);
+}
 
-        if (bcData.type == "dirichlet") {
-            for (int nodeIdx : boundaryNodes) {
-                // Zero out the row and column
-                for (int j = 0; j < nNodes; ++j) {
-                    K_global[nodeIdx][j] = 0.0;
-                    K_global[j][nodeIdx] = 0.0;
-                }
-                // Set diagonal to 1 and RHS to the Dirichlet value
-                K_global[nodeIdx][nodeIdx] = 1.0;
-                F_global[nodeIdx] = dirichletValues[nodeIdx];
-            }
-        } else if (bcData.type == "neumann") {
-            for (int nodeIdx : boundaryNodes) {
-                // Skip modifying Neumann nodes if they are also Dirichlet nodes (Dirichlet takes precedence)
-                if (!isDirichletNode[nodeIdx]) {
-                    double x = mesh.nodes[nodeIdx].first;
-                    double y = mesh.nodes[nodeIdx].second;
-                    double h_val = bcData.value_func ? bcData.value_func(x, y) : bcData.value;
-                    F_global[nodeIdx] += h_val;
-                }
-            }
-        }
-    }
+std::pair<std::vector<std::vector<double>>, std::vector<double>>
+EllipticFEMSolver::assembleGlobalMatrix(const MappedMesh& mesh) {
+    return assembleOn(mesh);
 }
 
-std::vector<std::vector<double>> EllipticFEMSolver::localEllipticMatrix(const std::vector<Node>& coords) {
-    // Calculate element area
-    double x1 = coords[0].first, y1 = coords[0].second;
-    double x2 = coords[1].first, y2 = coords[1].second;
-    double x3 = coords[2].first, y3 = coords[2].second;
-    
-    double area = 0.5 * std::abs((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1));
-    
-    // Calculate centroid for coefficient evaluation
-    double x_c = (x1 + x2 + x3) / 3.0;
-    double y_c = (y1 + y2 + y3) / 3.0;
-    
-    double a11_val = a11_func_(x_c, y_c);
-    double a12_val = a12_func_(x_c, y_c) * 2.0; // Factor of 2 for the mixed term
-    double a22_val = a22_func_(x_c, y_c);
-    
-    // Gradients of shape functions
-    double detJ = 2.0 * area;
-    double b1 = y2 - y3;
-    double c1 = x3 - x2;
-    double b2 = y3 - y1;
-    double c2 = x1 - x3;
-    double b3 = y1 - y2;
-    double c3 = x2 - x1;
-    
-    std::vector<std::vector<double>> Be(3, std::vector<double>(3, 0.0));
+void EllipticFEMSolver::applyBoundaryConditions(
+    std::vector<std::vector<double>>& K_global,
+    std::vector<double>& F_global,
+    const Mesh& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    applyBoundaryConditionsOn(K_global, F_global, mesh, boundaryConditions);
+}
+
+void EllipticFEMSolver::applyBoundaryConditions(
+    std::vector<std::vector<double>>& K_global,
+    std::vector<double>& F_global,
+    const StructuredMeshView& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    applyBoundaryConditionsOn(K_global, F_global, mesh, boundaryConditions);
+}
+
+void EllipticFEMSolver::applyBoundaryConditions(
+    std::vector<std::vector<double>>& K_global,
+    std::vector<double>& F_global,
+    const MappedMesh& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    applyBoundaryConditionsOn(K_global, F_global, mesh, boundaryConditions);
+}
+
+template <class MeshType>
+std::vector<double> EllipticFEMSolver::solveOn(const MeshType& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    // Assemble global matrix and vector
+    auto [K_global, F_global] = assembleGlobalMatrix(mesh);
     
-    for (int i = 0; i < 3; ++i) {
-        double dN_dx_i = (i == 0) ? b1 : (i == 1) ? b2 : b3;
-        double dN_dy_i = (i == 0) ? c1 : (i == 1) ? c2 : c3;
-        dN_dx_i /= detJ;
-        dN_dy_i /= detJ;
-        
-        for (int j = 0; j < 3; ++j) {
-            double dN_dx_j = (j == 0) ? b1 : (j == 1) ? b2 : b3;
-            double dN_dy_j = (j == 0) ? c1 : (j == 1) ? c2 : c3;
-            dN_dx_j /= detJ;
-            dN_dy_j /= detJ;
-            
-            // Element stiffness matrix: integral of grad(Ni)^T * A * grad(Nj) * area
-            Be[i][j] = area * (a11_val * dN_dx_i * dN_dx_j + 
-                               a12_val * dN_dx_i * dN_dy_j + 
-                               a12_val * dN_dy_i * dN_dx_j + 
-                               a22_val * dN_dy_i * dN_dy_j);
+    // Apply boundary conditions
+    applyBoundaryConditions(K_global, F_global, mesh, boundaryConditions);
+
+    return solveSystem(K_global, F_global);
+}
+
+std::vector<double> EllipticFEMSolver::solveAdjointOn(
+    const Mesh& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+    const std::vector<double>& load
+) {
+    auto [K_global, F_global] = assembleGlobalMatrix(mesh);
+
+    // Transpose, then impose the boundary conditions on the adjoint system like on the primal one
+    const std::size_t n = K_global.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = i + 1; j < n; ++j) {
+            std::swap(K_global[i][j], K_global[j][i]);
         }
     }
-    
-    return Be;
+    F_global = load;
+    applyBoundaryConditions(K_global, F_global, mesh, boundaryConditions);
+
+    return solveSystem(K_global, F_global);
 }
 
-std::vector<std::vector<double>> EllipticFEMSolver::localConvectionMatrix(const std::vector<Node>& coords) {
-    // Calculate element area
-    double x1 = coords[0].first, y1 = coords[0].second;
-    double x2 = coords[1].first, y2 = coords[1].second;
-    double x3 = coords[2].first, y3 = coords[2].second;
-    
-    double area = 0.5 * std::abs((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1));
-    
-    // Calculate centroid for coefficient evaluation
-    double x_c = (x1 + x2 + x3) / 3.0;
-    double y_c = (y1 + y2 + y3) / 3.0;
-    
-    double b1_val = b1_func_(x_c, y_c);
-    double b2_val = b2_func_(x_c, y_c);
-    
-    std::vector<std::vector<double>> Ce(3, std::vector<double>(3, 0.0));
-    
-    if (std::abs(b1_val) < 1e-9 && std::abs(b2_val) < 1e-9) {
-        return Ce; // Return zero matrix if convection is negligible
+std::vector<double> EllipticFEMSolver::solveSystem(
+    const std::vector<std::vector<double>>& K_global,
+    const std::vector<double>& F_global
+) {
+    // Cholesky when the operator is known to be SPD
+    std::vector<double> solution;
+    if (linearSolver_ == LinearSolver::Cholesky && solveCholesky(K_global, F_global, solution)) {
+        return solution;
     }
+    return solveLinearSystem(K_global, F_global);
+}
 
-    // Gradients of shape functions (dN/dx, dN/dy)
-    double detJ = 2.0 * area;
-    double dN_dx[3], dN_dy[3];
+template <class MeshType>
+std::pair<std::vector<std::vector<double>>, std::vector<double>>
+EllipticFEMSolver::assembleOn(const MeshType& mesh) {
+    int nNodes = static_cast<int>(mesh.nodeCount());
     
-    // dN1/dx, dN1/dy
-    dN_dx[0] = (y2 - y3) / detJ;
-    dN_dy[0] = (x3 - x2) / detJ;
-    
-    // dN2/dx, dN2/dy
-    dN_dx[1] = (y3 - y1) / detJ;
-    dN_dy[1] = (x1 - x3) / detJ;
-    
-    // dN3/dx, dN3/dy
-    dN_dx[2] = (y1 - y2) / detJ;
-    dN_dy[2] = (x2 - x1) / detJ;
-
-    // Integral of Ni * (b . grad(Nj)) dV
-    // For linear triangular elements, this is approximated as:
-    // (Area / 3) * (b1 * dNj/dx + b2 * dNj/dy)
-    // where the integral of Ni is Area/3 and the rest of the integrand is constant
+    // Initialize global matrices
+    std::vector<std::vector<double>> K_global(nNodes, std::vector<double>(nNodes, 0.0));
+    std::vector<double> F_global(nNodes, 0.0);
     
-    for (int i = 0; i < 3; ++i) {
-        for (int j = 0; j < 3; ++j) {
-            double b_dot_grad_Nj = b1_val * dN_dx[j] + b2_val * dN_dy[j];
-            Ce[i][j] = (area / 3.0) * b_dot_grad_Nj;
-        }
+    // Assemble by elements, either through the prebuilt assembler or the type-erased coefficients
+    if (assembler_) {
+        assembler_->assemble(mesh, K_global, F_global);
+    } else {
+        DynamicCoefficientSet coeffs = {
+            { a11_func_ }, { a12_func_ }, { a22_func_ },
+            { b1_func_ }, { b2_func_ },
+            { c_func_ }, { f_func_ }
+        };
+        assembleElements(mesh, coeffs, K_global, F_global);
     }
     
-    return Ce;
+    return std::make_pair(K_global, F_global);
 }
 
-std::vector<std::vector<double>> EllipticFEMSolver::localReactionMatrix(const std::vector<Node>& coords) {
-    // Calculate element area
-    double x1 = coords[0].first, y1 = coords[0].second;
-    double x2 = coords[1].first, y2 = coords[1].second;
-    double x3 = coords[2].first, y3 = coords[2].second;
-    
-    double area = 0.5 * std::abs((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1));
-    
-    // Calculate centroid for coefficient evaluation
-    double x_c = (x1 + x2 + x3) / 3.0;
-    double y_c = (y1 + y2 + y3) / 3.0;
-    
-    double c_val = c_func_(x_c, y_c);
-    
-    std::vector<std::vector<double>> Re(3, std::vector<double>(3, 0.0));
-    
-    if (c_val != 0.0) {
-        // Reaction matrix for linear elements
-        // Integral of c*N_i*N_j over element = c*area/12*[2,1,1; 1,2,1; 1,1,2]
-        double factor = c_val * area / 12.0;
-        Re[0][0] = Re[1][1] = Re[2][2] = 2.0 * factor;
-        Re[0][1] = Re[0][2] = Re[1][0] = Re[1][2] = Re[2][0] = Re[2][1] = factor;
+template <class MeshType>
+void EllipticFEMSolver::applyBoundaryConditionsOn(
+    std::vector<std::vector<double>>& K_global,
+    std::vector<double>& F_global,
+    const MeshType& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    const MeshIndex nNodes = static_cast<MeshIndex>(mesh.nodeCount());
+
+    // Resolve every condition once (values per boundary node, cached expressions), then one
+    // pass over the node tags
+    std::vector<std::pair<MeshIndex, double>> dirichletNodes; // Ascending node index
+    std::vector<std::pair<MeshIndex, double>> neumannTerms;
+    forEachBoundaryConditionNode(
+        mesh, resolveBoundaryConditions(mesh, boundaryConditions, boundaryCache_.get()),
+        [&](MeshIndex i, bool dirichlet, double dirichletValue, const std::vector<double>& neumannValues) {
+            if (dirichlet) {
+                dirichletNodes.emplace_back(i, dirichletValue);
+            } else {
+                for (double value : neumannValues) neumannTerms.emplace_back(i, value);
+            }
+        });
+
+    std::vector<MeshIndex> freeNodes;
+    freeNodes.reserve(static_cast<std::size_t>(nNodes) - dirichletNodes.size());
+    std::size_t nextDirichlet = 0;
+    for (MeshIndex i = 0; i < nNodes; ++i) {
+        if (nextDirichlet < dirichletNodes.size() && dirichletNodes[nextDirichlet].first == i) {
+            ++nextDirichlet;
+        } else {
+            freeNodes.push_back(i);
+        }
     }
-    
-    return Re;
-}
 
-std::vector<double> EllipticFEMSolver::localLoadVector(const std::vector<Node>& coords) {
-    // Calculate element area
-    double x1 = coords[0].first, y1 = coords[0].second;
-    double x2 = coords[1].first, y2 = coords[1].second;
-    double x3 = coords[2].first, y3 = coords[2].second;
-    
-    double area = 0.5 * std::abs((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1));
-    
-    // Calculate centroid for coefficient evaluation
-    double x_c = (x1 + x2 + x3) / 3.0;
-    double y_c = (y1 + y2 + y3) / 3.0;
-    
-    double f_val = f_func_(x_c, y_c);
-    
-    // For linear elements: integral of f*N_i over element = f*area/3 for each i
-    std::vector<double> Fe(3, f_val * area / 3.0);
-    
-    return Fe;
+    // Modify the right-hand side (F_global) for Dirichlet conditions ("lifting")
+    for (MeshIndex i : freeNodes) {
+        const std::vector<double>& row = K_global[i];
+        for (const auto& dirichletNode : dirichletNodes) {
+            F_global[i] -= row[dirichletNode.first] * dirichletNode.second;
+        }
+    }
+
+    // Replace the Dirichlet equations by u = g
+    for (const auto& dirichletNode : dirichletNodes) {
+        MeshIndex nodeIdx = dirichletNode.first;
+        // Zero out the row and column
+        for (MeshIndex j = 0; j < nNodes; ++j) {
+            K_global[nodeIdx][j] = 0.0;
+            K_global[j][nodeIdx] = 0.0;
+        }
+        // Set diagonal to 1 and RHS to the Dirichlet value
+        K_global[nodeIdx][nodeIdx] = 1.0;
+        F_global[nodeIdx] = dirichletNode.second;
+    }
+
+    // Apply Neumann conditions on the remaining boundary nodes
+    for (const auto& term : neumannTerms) {
+        F_global[term.first] += term.second;
+    }
 }
 
 std::vector<double> EllipticFEMSolver::solveLinearSystem(
@@ -343,4 +341,62 @@ std::vector<double> EllipticFEMSolver::solveLinearSystem(
     }
     
     return x;
-}
\ No newline at end of file
+}
+
+bool EllipticFEMSolver::solveCholesky(
+    const std::vector<std::vector<double>>& A,
+    const std::vector<double>& b,
+    std::vector<double>& x
+) {
+    int n = static_cast<int>(b.size());
+
+    // Row i of A (and of L) is zero left of first[i], so all loops start at the row envelope;
+    // the cost follows the profile of the matrix, which node renumbering keeps small
+    std::vector<int> first(n);
+    for (int i = 0; i < n; ++i) {
+        int j = 0;
+        while (j < i && A[i][j] == 0.0) ++j;
+        first[i] = j;
+    }
+
+    // Factor A = L * L^T, storing the rows of L up to the diagonal
+    std::vector<std::vector<double>> L(n);
+    for (int i = 0; i < n; ++i) {
+        L[i].assign(A[i].begin(), A[i].begin() + i + 1);
+        for (int j = first[i]; j <= i; ++j) {
+            const double* li = L[i].data();
+            const double* lj = L[j].data();
+            double sum = li[j];
+            for (int k = std::max(first[i], first[j]); k < j; ++k) {
+                sum -= li[k] * lj[k];
+            }
+            if (j < i) {
+                L[i][j] = sum / lj[j];
+            } else {
+                if (!(sum > 1e-15)) {
+                    return false;
+                }
+                L[i][i] = std::sqrt(sum);
+            }
+        }
+    }
+
+    // Forward substitution: L * z = b
+    x.assign(b.begin(), b.end());
+    for (int i = 0; i < n; ++i) {
+        for (int k = first[i]; k < i; ++k) {
+            x[i] -= L[i][k] * x[k];
+        }
+        x[i] /= L[i][i];
+    }
+
+    // Back substitution: L^T * x = z
+    for (int i = n - 1; i >= 0; --i) {
+        x[i] /= L[i][i];
+        for (int k = first[i]; k < i; ++k) {
+            x[k] -= L[i][k] * x[i];
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,216 @@
+#include "ErrorEstimator.h"
+#include "BoundaryValueCache.h"
+#include "EllipticFEMSolver.h"
+#include "MeshAdjacency.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+ErrorEstimator::ErrorEstimator(
+    CoefficientFunction a11_func,
+    CoefficientFunction a12_func,
+    CoefficientFunction a22_func,
+    CoefficientFunction b1_func,
+    CoefficientFunction b2_func,
+    CoefficientFunction c_func,
+    CoefficientFunction f_func
+) : a11_func_(EllipticFEMSolver::toBatchFunction(a11_func)),
+    a12_func_(EllipticFEMSolver::toBatchFunction(a12_func)),
+    a22_func_(EllipticFEMSolver::toBatchFunction(a22_func)),
+    b1_func_(EllipticFEMSolver::toBatchFunction(b1_func)),
+    b2_func_(EllipticFEMSolver::toBatchFunction(b2_func)),
+    c_func_(EllipticFEMSolver::toBatchFunction(c_func)),
+    f_func_(EllipticFEMSolver::toBatchFunction(f_func))
+{
+}
+
+void ErrorEstimator::setBatchCoefficients(
+    BatchCoefficientFunction a11_func, BatchCoefficientFunction a12_func, BatchCoefficientFunction a22_func,
+    BatchCoefficientFunction b1_func, BatchCoefficientFunction b2_func,
+    BatchCoefficientFunction c_func, BatchCoefficientFunction f_func
+) {
+    if (a11_func) a11_func_ = std::move(a11_func);
+    if (a12_func) a12_func_ = std::move(a12_func);
+    if (a22_func) a22_func_ = std::move(a22_func);
+    if (b1_func) b1_func_ = std::move(b1_func);
+    if (b2_func) b2_func_ = std::move(b2_func);
+    if (c_func) c_func_ = std::move(c_func);
+    if (f_func) f_func_ = std::move(f_func);
+}
+
+std::vector<double> ErrorEstimator::estimate(
+    const Mesh& mesh,
+    const std::vector<double>& solution,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) const {
+    const std::size_t n = mesh.nodeCount();
+    const std::size_t nElements = mesh.elementCount();
+    if (solution.size() != n) {
+        throw std::invalid_argument("Error estimate needs one solution value per mesh node");
+    }
+    const bool residual = indicator_ == ErrorIndicator::Residual;
+
+    // Diffusion at the centroids (as in the assembly), the other coefficients at the edge
+    // midpoints, which integrate the quadratic element residual exactly
+    std::vector<double> cx(nElements), cy(nElements);
+    std::vector<double> mx(residual ? 3 * nElements : 0), my(residual ? 3 * nElements : 0);
+    parallelFor(nElements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t e = begin; e < end; ++e) {
+            const MeshIndex* t = &mesh.connectivity[3 * e];
+            cx[e] = (mesh.x[t[0]] + mesh.x[t[1]] + mesh.x[t[2]]) / 3.0;
+            cy[e] = (mesh.y[t[0]] + mesh.y[t[1]] + mesh.y[t[2]]) / 3.0;
+            if (!residual) continue;
+            for (int k = 0; k < 3; ++k) {
+                MeshIndex a = t[(k + 1) % 3], b = t[(k + 2) % 3];
+                mx[3 * e + k] = 0.5 * (mesh.x[a] + mesh.x[b]);
+                my[3 * e + k] = 0.5 * (mesh.y[a] + mesh.y[b]);
+            }
+        }
+    });
+    std::vector<double> a11(nElements), a12(nElements), a22(nElements);
+    a11_func_(cx.data(), cy.data(), a11.data(), nElements);
+    a12_func_(cx.data(), cy.data(), a12.data(), nElements);
+    a22_func_(cx.data(), cy.data(), a22.data(), nElements);
+    std::vector<double> b1(mx.size()), b2(mx.size()), c(mx.size()), f(mx.size());
+    if (residual) {
+        b1_func_(mx.data(), my.data(), b1.data(), mx.size());
+        b2_func_(mx.data(), my.data(), b2.data(), mx.size());
+        c_func_(mx.data(), my.data(), c.data(), mx.size());
+        f_func_(mx.data(), my.data(), f.data(), mx.size());
+    }
+
+    // Gradient and flux A grad u_h of every element; the mixed coefficient is weighted like the assembly
+    std::vector<double> gradX(nElements), gradY(nElements), fluxX(nElements), fluxY(nElements);
+    parallelFor(nElements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t e = begin; e < end; ++e) {
+            const MeshIndex* t = &mesh.connectivity[3 * e];
+            double x1 = mesh.x[t[0]], y1 = mesh.y[t[0]];
+            double x2 = mesh.x[t[1]], y2 = mesh.y[t[1]];
+            double x3 = mesh.x[t[2]], y3 = mesh.y[t[2]];
+            double detJ = (x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1);
+            double u1 = solution[t[0]], u2 = solution[t[1]], u3 = solution[t[2]];
+            gradX[e] = (u1 * (y2 - y3) + u2 * (y3 - y1) + u3 * (y1 - y2)) / detJ;
+            gradY[e] = (u1 * (x3 - x2) + u2 * (x1 - x3) + u3 * (x2 - x1)) / detJ;
+            fluxX[e] = a11[e] * gradX[e] + 2.0 * a12[e] * gradY[e];
+            fluxY[e] = 2.0 * a12[e] * gradX[e] + a22[e] * gradY[e];
+        }
+    });
+
+    // Boundary conditions: Dirichlet boundaries, and the Neumann nodal loads spread over half
+    // the Neumann boundary edges at each node to give a flux density
+    std::uint32_t dirichletMask = 0, neumannMask = 0;
+    std::vector<double> load(n, 0.0), loadLength(n, 0.0);
+    for (const auto& pair : boundaryConditions) {
+        int bit = mesh.boundaryTagBit(pair.first);
+        if (bit < 0) continue;
+        if (pair.second.type == "dirichlet") {
+            dirichletMask |= 1u << bit;
+        } else if (pair.second.type == "neumann") {
+            neumannMask |= 1u << bit;
+            const std::vector<MeshIndex>& nodes = mesh.boundarySets[bit];
+            std::vector<double> xs(nodes.size()), ys(nodes.size()), values(nodes.size());
+            for (std::size_t k = 0; k < nodes.size(); ++k) {
+                xs[k] = mesh.x[nodes[k]];
+                ys[k] = mesh.y[nodes[k]];
+            }
+            evaluateBoundaryCondition(pair.second, xs.data(), ys.data(), values.data(), nodes.size());
+            for (std::size_t k = 0; k < nodes.size(); ++k) load[nodes[k]] += values[k];
+        }
+    }
+
+    const std::vector<MeshIndex> across = mesh.adjacency()->elementNeighbors(mesh);
+    auto isNeumannEdge = [&](MeshIndex a, MeshIndex b) {
+        std::uint32_t common = mesh.boundaryTag(a) & mesh.boundaryTag(b);
+        return !(common & dirichletMask) && (common & neumannMask);
+    };
+    if (neumannMask) {
+        for (std::size_t e = 0; e < nElements; ++e) {
+            const MeshIndex* t = &mesh.connectivity[3 * e];
+            for (int k = 0; k < 3; ++k) {
+                MeshIndex a = t[(k + 1) % 3], b = t[(k + 2) % 3];
+                if (across[3 * e + k] >= 0 || !isNeumannEdge(a, b)) continue;
+                double h = std::hypot(mesh.x[b] - mesh.x[a], mesh.y[b] - mesh.y[a]);
+                loadLength[a] += 0.5 * h;
+                loadLength[b] += 0.5 * h;
+            }
+        }
+    }
+
+    std::vector<double> indicators(nElements);
+    parallelFor(nElements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t e = begin; e < end; ++e) {
+            const MeshIndex* t = &mesh.connectivity[3 * e];
+            double detJ = (mesh.x[t[1]] - mesh.x[t[0]]) * (mesh.y[t[2]] - mesh.y[t[0]]) -
+                          (mesh.x[t[2]] - mesh.x[t[0]]) * (mesh.y[t[1]] - mesh.y[t[0]]);
+            double orientation = detJ > 0.0 ? 1.0 : -1.0;
+            double eta = 0.0, diameter = 0.0;
+
+            for (int k = 0; k < 3; ++k) {
+                MeshIndex a = t[(k + 1) % 3], b = t[(k + 2) % 3];
+                double ex = mesh.x[b] - mesh.x[a], ey = mesh.y[b] - mesh.y[a];
+                double h = std::hypot(ex, ey);
+                diameter = std::max(diameter, h);
+                // Outward unit normal of edge a -> b
+                double nx = orientation * ey / h, ny = -orientation * ex / h;
+
+                MeshIndex neighbor = across[3 * e + k];
+                if (neighbor >= 0) {
+                    double jump = nx * (fluxX[e] - fluxX[neighbor]) + ny * (fluxY[e] - fluxY[neighbor]);
+                    eta += 0.5 * h * h * jump * jump;
+                } else {
+                    std::uint32_t common = mesh.boundaryTag(a) & mesh.boundaryTag(b);
+                    if (common & dirichletMask) continue;
+                    double q = 0.0;
+                    if (common & neumannMask) {
+                        double qa = loadLength[a] > 0.0 ? load[a] / loadLength[a] : 0.0;
+                        double qb = loadLength[b] > 0.0 ? load[b] / loadLength[b] : 0.0;
+                        q = 0.5 * (qa + qb);
+                    }
+                    double r = q - (nx * fluxX[e] + ny * fluxY[e]);
+                    eta += h * h * r * r;
+                }
+            }
+
+            if (residual) {
+                double sum = 0.0;
+                for (int k = 0; k < 3; ++k) {
+                    std::size_t q = 3 * e + k;
+                    double u = 0.5 * (solution[t[(k + 1) % 3]] + solution[t[(k + 2) % 3]]);
+                    double r = f[q] - (b1[q] * gradX[e] + b2[q] * gradY[e]) - c[q] * u;
+                    sum += r * r;
+                }
+                double area = 0.5 * std::abs(detJ);
+                eta += diameter * diameter * area / 3.0 * sum;
+            }
+            indicators[e] = eta;
+        }
+    });
+    return indicators;
+}
+
+double ErrorEstimator::globalEstimate(const std::vector<double>& indicators) {
+    return std::sqrt(std::accumulate(indicators.begin(), indicators.end(), 0.0));
+}
+
+std::vector<MeshIndex> ErrorEstimator::markDorfler(const std::vector<double>& indicators, double theta) {
+    if (!(theta > 0.0 && theta <= 1.0)) {
+        throw std::invalid_argument("Dorfler marking parameter must lie in (0, 1]");
+    }
+    std::vector<MeshIndex> order(indicators.size());
+    std::iota(order.begin(), order.end(), MeshIndex(0));
+    std::sort(order.begin(), order.end(), [&](MeshIndex a, MeshIndex b) {
+        return indicators[a] > indicators[b] || (indicators[a] == indicators[b] && a < b);
+    });
+
+    const double goal = theta * std::accumulate(indicators.begin(), indicators.end(), 0.0);
+    double sum = 0.0;
+    std::size_t count = 0;
+    while (count < order.size() && (sum < goal || count == 0) && goal > 0.0) {
+        sum += indicators[order[count++]];
+    }
+    order.resize(count);
+    std::sort(order.begin(), order.end());
+    return order;
+}
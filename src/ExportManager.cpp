@@ -61,6 +61,11 @@ bool ExportManager::exportSolutionToFile(const std::string& filename) {
         outFile << "# Generated by FEM Solver\n";
         outFile << "# Domain: [0, " << m_appData->Lx << "] x [0, " << m_appData->Ly << "]\n";
         outFile << "# Mesh: " << m_appData->Nx << " x " << m_appData->Ny << " nodes\n";
+        if (ellipticApp->getElementOrder() == 2) {
+            outFile << "# Elements: quadratic (P2), each listed as four linear triangles on its nodes\n";
+        } else if (ellipticApp->usesQuadrilateralElements()) {
+            outFile << "# Elements: bilinear quadrilaterals (Q1), each listed as two linear triangles on its nodes\n";
+        }
         outFile << "# Coefficients:\n";
         outFile << "#   a11(x,y) = " << m_appData->a11Func << "\n";
         outFile << "#   a12(x,y) = " << m_appData->a12Func << "\n";
@@ -73,22 +78,22 @@ bool ExportManager::exportSolutionToFile(const std::string& filename) {
         outFile << "# Node_ID\tX_coord\tY_coord\tSolution_Value\n";
 
         // Write node data with solution values
-        size_t min_size = (mesh.nodes.size() < solution.size()) ? mesh.nodes.size() : solution.size();
+        size_t min_size = (mesh.nodeCount() < solution.size()) ? mesh.nodeCount() : solution.size();
         for (size_t i = 0; i < min_size; ++i) {
             outFile << i << "\t"
-                   << mesh.nodes[i].first << "\t"
-                   << mesh.nodes[i].second << "\t"
+                   << mesh.x[i] << "\t"
+                   << mesh.y[i] << "\t"
                    << solution[i] << "\n";
         }
 
         // Write element connectivity
         outFile << "\n# Element Connectivity\n";
         outFile << "# Element_ID\tNode1\tNode2\tNode3\n";
-        for (size_t i = 0; i < mesh.elements.size(); ++i) {
+        for (size_t i = 0; i < mesh.elementCount(); ++i) {
             outFile << i << "\t"
-                   << mesh.elements[i][0] << "\t"
-                   << mesh.elements[i][1] << "\t"
-                   << mesh.elements[i][2] << "\n";
+                   << mesh.connectivity[3 * i] << "\t"
+                   << mesh.connectivity[3 * i + 1] << "\t"
+                   << mesh.connectivity[3 * i + 2] << "\n";
         }
 
         outFile.close();
@@ -0,0 +1,151 @@
+#include "FFT.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+std::complex<double> unitRoot(std::size_t k, std::size_t n) {
+    double angle = -2.0 * kPi * static_cast<double>(k) / static_cast<double>(n);
+    return std::complex<double>(std::cos(angle), std::sin(angle));
+}
+
+// Plain complex product; operator* also handles infinities and NaNs, which makes it a
+// library call without -ffast-math
+inline std::complex<double> multiply(const std::complex<double>& a, const std::complex<double>& b) {
+    return std::complex<double>(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+} // namespace
+
+FFT::FFT(std::size_t n) : n_(n) {
+    if (n == 0) {
+        throw std::invalid_argument("FFT length must be positive");
+    }
+    for (std::size_t rest = n, p = 2; rest > 1;) {
+        if (p * p > rest) p = rest;
+        if (rest % p == 0) {
+            factors_.push_back(p);
+            rest /= p;
+        } else {
+            ++p;
+        }
+    }
+
+    // Work per point: a radix-2 pass costs about one complex multiply-add, a radix-p pass p + 1
+    // (the twiddles and the p-point sums). The chirp convolution takes two power-of-two
+    // transforms of m >= 2n - 1 points (the filter spectrum is precomputed) and three products.
+    std::size_t m = 1, log2m = 0;
+    while (m < 2 * n - 1) {
+        m *= 2;
+        ++log2m;
+    }
+    double mixedCost = 0.0;
+    for (std::size_t p : factors_) mixedCost += p == 2 ? 1.0 : static_cast<double>(p + 1);
+    const double chirpCost = static_cast<double>(2 * m * log2m + 3 * m) / static_cast<double>(n);
+    if (!factors_.empty() && factors_.back() > 2 && mixedCost > chirpCost) {
+        factors_.clear();
+        // j^2 is reduced modulo 2n so that the angles stay small for long sequences
+        chirp_.resize(n_);
+        for (std::size_t j = 0; j < n_; ++j) {
+            chirp_[j] = unitRoot((j * j) % (2 * n_), 2 * n_);
+        }
+        convolution_ = std::make_unique<FFT>(m);
+        filterSpectrum_.assign(m, std::complex<double>(0.0, 0.0));
+        filterSpectrum_[0] = std::conj(chirp_[0]);
+        for (std::size_t j = 1; j < n_; ++j) {
+            filterSpectrum_[j] = filterSpectrum_[m - j] = std::conj(chirp_[j]);
+        }
+        convolution_->forward(filterSpectrum_.data());
+        costPerPoint_ = chirpCost;
+        workspaceSize_ = m + convolution_->workspaceSize();
+        return;
+    }
+
+    twiddles_.resize(n_);
+    for (std::size_t k = 0; k < n_; ++k) twiddles_[k] = unitRoot(k, n_);
+    costPerPoint_ = mixedCost;
+    // The input copy of the out-of-place recursion and the butterfly of the largest radix
+    if (!factors_.empty()) workspaceSize_ = n_ + (factors_.back() > 2 ? factors_.back() : 0);
+}
+
+FFT::~FFT() = default;
+
+void FFT::mixedRadix(std::complex<double>* out, const std::complex<double>* in, std::size_t stride,
+                     std::size_t factor, std::complex<double>* butterfly) const {
+    const std::size_t p = factors_[factor];
+    const std::size_t length = n_ / stride;
+    const std::size_t m = length / p;
+
+    // Transforms of the p decimated subsequences into consecutive blocks of m
+    if (m == 1) {
+        for (std::size_t q = 0; q < p; ++q) out[q] = in[q * stride];
+    } else {
+        for (std::size_t q = 0; q < p; ++q) mixedRadix(out + q * m, in + q * stride, stride * p, factor + 1, butterfly);
+    }
+
+    // Combine them with the twiddles exp(-2 pi i q u / length) = twiddles_[q u stride]
+    if (p == 2) {
+        for (std::size_t u = 0; u < m; ++u) {
+            std::complex<double> a = out[u];
+            std::complex<double> b = multiply(out[u + m], twiddles_[u * stride]);
+            out[u] = a + b;
+            out[u + m] = a - b;
+        }
+        return;
+    }
+    const std::size_t rootStep = n_ / p;
+    for (std::size_t u = 0; u < m; ++u) {
+        for (std::size_t q = 0; q < p; ++q) butterfly[q] = multiply(out[u + q * m], twiddles_[q * u * stride]);
+        for (std::size_t k = 0; k < p; ++k) {
+            std::complex<double> sum = butterfly[0];
+            for (std::size_t q = 1, j = k; q < p; ++q) {
+                sum += multiply(butterfly[q], twiddles_[j * rootStep]);
+                j += k;
+                if (j >= p) j -= p;
+            }
+            out[u + k * m] = sum;
+        }
+    }
+}
+
+void FFT::forward(std::complex<double>* data, std::complex<double>* workspace) const {
+    if (convolution_) {
+        // X[k] = chirp[k] sum_j (x[j] chirp[j]) conj(chirp[k - j]), with the inverse transform of
+        // the product as the conjugate of the forward transform of its conjugate
+        const std::size_t m = convolution_->size();
+        std::complex<double>* work = workspace;
+        std::complex<double>* inner = workspace + m;
+        for (std::size_t j = 0; j < n_; ++j) work[j] = multiply(data[j], chirp_[j]);
+        std::fill(work + n_, work + m, std::complex<double>(0.0, 0.0));
+        convolution_->forward(work, inner);
+        for (std::size_t k = 0; k < m; ++k) work[k] = std::conj(multiply(work[k], filterSpectrum_[k]));
+        convolution_->forward(work, inner);
+        const double scale = 1.0 / static_cast<double>(m);
+        for (std::size_t k = 0; k < n_; ++k) data[k] = multiply(std::conj(work[k]), chirp_[k]) * scale;
+        return;
+    }
+    if (factors_.empty()) return; // n = 1
+    std::copy(data, data + n_, workspace);
+    mixedRadix(data, workspace, 1, 0, workspace + n_);
+}
+
+void FFT::inverse(std::complex<double>* data, std::complex<double>* workspace) const {
+    // The inverse is the conjugate of the forward transform of the conjugate
+    for (std::size_t j = 0; j < n_; ++j) data[j] = std::conj(data[j]);
+    forward(data, workspace);
+    const double scale = 1.0 / static_cast<double>(n_);
+    for (std::size_t k = 0; k < n_; ++k) data[k] = std::conj(data[k]) * scale;
+}
+
+void FFT::forward(std::complex<double>* data) const {
+    std::vector<std::complex<double>> workspace(workspaceSize_);
+    forward(data, workspace.data());
+}
+
+void FFT::inverse(std::complex<double>* data) const {
+    std::vector<std::complex<double>> workspace(workspaceSize_);
+    inverse(data, workspace.data());
+}
@@ -0,0 +1,268 @@
+#include "FastPoissonSolver.h"
+#include "FFT.h"
+#include "FunctionParser.h"
+#include "KrylovSolvers.h"
+#include "ParallelFor.h"
+#include "StencilSolver.h"
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+const double kPi = 3.14159265358979323846;
+
+// Grid lines or columns per parallel chunk of the transforms
+constexpr std::size_t kLinesPerChunk = 32;
+
+// Cost model of isFasterThanIteration, fitted on FastPoissonBenchmark: conjugate gradients on
+// the stencil operator take about 2.2 iterations per cell along the grid (twice as many along
+// axes with mixed ends), and one transform solve costs about 0.6 of those iterations per unit
+// of FFT work per point, summed over the axes
+constexpr double kIterationsPerCell = 2.2;
+constexpr double kIterationsPerTransformWork = 0.6;
+
+// Eigenvector transform of the 1D second difference on an axis of `cells` cells whose ends are
+// Dirichlet (the end node is known) or Neumann (half a row at the end node). With M cells the
+// basis vectors on the unknown nodes j are
+//     Dirichlet-Dirichlet  sin(pi k j / M),              k = 1 .. M-1, j = 1 .. M-1
+//     Neumann-Neumann      cos(pi k j / M),              k = 0 .. M,   j = 0 .. M
+//     Dirichlet-Neumann    sin(pi (2k+1) j / (2M)),      k = 0 .. M-1, j = 1 .. M
+//     Neumann-Dirichlet    cos(pi (2k+1) j / (2M)),      k = 0 .. M-1, j = 0 .. M-1
+// i.e. sin or cos(2 pi m j / L) at mode positions m of an FFT of length L = 2M (4M for mixed
+// ends), with eigenvalues 2 - 2 cos(2 pi m / L). The sums over j (analysis) and over k
+// (synthesis) are both read off one FFT, since the kernel is symmetric in m and j; two real
+// sequences go through each complex FFT.
+class AxisTransform {
+public:
+    AxisTransform(int cells, bool dirichletLow, bool dirichletHigh)
+        : sine_(dirichletLow),
+          length_((dirichletLow == dirichletHigh ? 2 : 4) * static_cast<std::size_t>(cells)),
+          fft_(length_) {
+        const std::size_t M = static_cast<std::size_t>(cells);
+        firstNode_ = dirichletLow ? 1 : 0;
+        const std::size_t lastNode = dirichletHigh ? M - 1 : M;
+        const std::size_t count = lastNode >= firstNode_ ? lastNode - firstNode_ + 1 : 0;
+        for (std::size_t t = 0; t < count; ++t) {
+            std::size_t m = dirichletLow == dirichletHigh ? (sine_ ? t + 1 : t) : 2 * t + 1;
+            modePositions_.push_back(m);
+            nodePositions_.push_back(firstNode_ + t);
+            eigenvalues_.push_back(2.0 - 2.0 * std::cos(2.0 * kPi * static_cast<double>(m) / static_cast<double>(length_)));
+            // Squared norm in the weighted inner product with weight 1/2 at Neumann ends
+            bool doubled = !dirichletLow && !dirichletHigh && (m == 0 || m == M);
+            norms_.push_back(doubled ? static_cast<double>(M) : 0.5 * static_cast<double>(M));
+        }
+    }
+
+    std::size_t firstNode() const { return firstNode_; }
+    std::size_t count() const { return nodePositions_.size(); }
+    double eigenvalue(std::size_t k) const { return eigenvalues_[k]; }
+    double norm(std::size_t k) const { return norms_[k]; }
+
+    // Analysis out[k] = sum_j in[j] phi_k(j), or synthesis out[j] = sum_k in[k] phi_k(j), of
+    // in0 and (if given) in1. work holds the sequence and the FFT workspace and is reused.
+    void apply(const double* in0, const double* in1, double* out0, double* out1, bool synthesis,
+               std::vector<std::complex<double>>& work) const {
+        const std::vector<std::size_t>& from = synthesis ? modePositions_ : nodePositions_;
+        const std::vector<std::size_t>& to = synthesis ? nodePositions_ : modePositions_;
+        work.resize(length_ + fft_.workspaceSize());
+        std::fill(work.begin(), work.begin() + length_, std::complex<double>(0.0, 0.0));
+        for (std::size_t t = 0; t < from.size(); ++t) {
+            work[from[t]] = std::complex<double>(in0[t], in1 ? in1[t] : 0.0);
+        }
+        fft_.forward(work.data(), work.data() + length_);
+        for (std::size_t t = 0; t < to.size(); ++t) {
+            // Transforms of the real and imaginary parts from X[p] and conj(X[L - p])
+            const std::size_t p = to[t];
+            const std::complex<double> X = work[p], Y = std::conj(work[(length_ - p) % length_]);
+            const std::complex<double> first = 0.5 * (X + Y), second = std::complex<double>(0.0, -0.5) * (X - Y);
+            out0[t] = sine_ ? -first.imag() : first.real();
+            if (out1) out1[t] = sine_ ? -second.imag() : second.real();
+        }
+    }
+
+private:
+    bool sine_;
+    std::size_t length_;
+    FFT fft_;
+    std::size_t firstNode_ = 0;
+    std::vector<std::size_t> modePositions_, nodePositions_;
+    std::vector<double> eigenvalues_, norms_;
+};
+
+bool isDirichlet(const std::map<std::string, BoundaryConditionData>& boundaryConditions, const char* side) {
+    auto it = boundaryConditions.find(side);
+    return it != boundaryConditions.end() && it->second.type == "dirichlet";
+}
+
+// z = K^-1 r for the stiffness matrix of the constant operator with a lumped reaction term on
+// the unknown nodes, z = r on the Dirichlet nodes (identity rows after applyDirichlet)
+class TransformSolve {
+public:
+    TransformSolve(const StructuredMeshView& grid, const FastPoissonSolver::Coefficients& coefficients,
+                   const std::map<std::string, BoundaryConditionData>& boundaryConditions)
+        : Nx_(static_cast<std::size_t>(grid.getNx())),
+          x_(grid.getNx() - 1, isDirichlet(boundaryConditions, "west"), isDirichlet(boundaryConditions, "east")),
+          y_(grid.getNy() - 1, isDirichlet(boundaryConditions, "south"), isDirichlet(boundaryConditions, "north")) {
+        const double hx = grid.getLx() / (grid.getNx() - 1), hy = grid.getLy() / (grid.getNy() - 1);
+        alpha_ = coefficients.a11 * hy / hx;
+        beta_ = coefficients.a22 * hx / hy;
+        gamma_ = coefficients.c * hx * hy;
+    }
+
+    void apply(const std::vector<double>& r, std::vector<double>& z) const {
+        z = r;
+        const std::size_t nx = x_.count(), ny = y_.count();
+        if (nx == 0 || ny == 0) return;
+        const std::size_t x0 = x_.firstNode(), y0 = y_.firstNode();
+
+        // Rows: analysis along x into modes[row][k]
+        std::vector<double> modes(nx * ny);
+        const std::size_t rowPairs = (ny + 1) / 2;
+        parallelFor(rowPairs, [&](std::size_t begin, std::size_t end) {
+            std::vector<std::complex<double>> work;
+            for (std::size_t pair = begin; pair < end; ++pair) {
+                const std::size_t t = 2 * pair;
+                const bool both = t + 1 < ny;
+                x_.apply(&r[(y0 + t) * Nx_ + x0], both ? &r[(y0 + t + 1) * Nx_ + x0] : nullptr,
+                         &modes[t * nx], both ? &modes[(t + 1) * nx] : nullptr, false, work);
+            }
+        }, kLinesPerChunk);
+
+        // Columns: analysis along y, division by the eigenvalues and synthesis along y
+        const std::size_t columnPairs = (nx + 1) / 2;
+        parallelFor(columnPairs, [&](std::size_t begin, std::size_t end) {
+            std::vector<std::complex<double>> work;
+            std::vector<double> column0(ny), column1(ny), hat0(ny), hat1(ny);
+            for (std::size_t pair = begin; pair < end; ++pair) {
+                const std::size_t k = 2 * pair;
+                const bool both = k + 1 < nx;
+                for (std::size_t t = 0; t < ny; ++t) {
+                    column0[t] = modes[t * nx + k];
+                    if (both) column1[t] = modes[t * nx + k + 1];
+                }
+                y_.apply(column0.data(), both ? column1.data() : nullptr, hat0.data(), hat1.data(), false, work);
+                for (std::size_t l = 0; l < ny; ++l) {
+                    hat0[l] /= (alpha_ * x_.eigenvalue(k) + beta_ * y_.eigenvalue(l) + gamma_) * x_.norm(k) * y_.norm(l);
+                    if (both) {
+                        hat1[l] /= (alpha_ * x_.eigenvalue(k + 1) + beta_ * y_.eigenvalue(l) + gamma_) * x_.norm(k + 1) * y_.norm(l);
+                    }
+                }
+                y_.apply(hat0.data(), both ? hat1.data() : nullptr, column0.data(), column1.data(), true, work);
+                for (std::size_t t = 0; t < ny; ++t) {
+                    modes[t * nx + k] = column0[t];
+                    if (both) modes[t * nx + k + 1] = column1[t];
+                }
+            }
+        }, kLinesPerChunk);
+
+        // Rows: synthesis along x into the unknown nodes
+        parallelFor(rowPairs, [&](std::size_t begin, std::size_t end) {
+            std::vector<std::complex<double>> work;
+            for (std::size_t pair = begin; pair < end; ++pair) {
+                const std::size_t t = 2 * pair;
+                const bool both = t + 1 < ny;
+                x_.apply(&modes[t * nx], both ? &modes[(t + 1) * nx] : nullptr,
+                         &z[(y0 + t) * Nx_ + x0], both ? &z[(y0 + t + 1) * Nx_ + x0] : nullptr, true, work);
+            }
+        }, kLinesPerChunk);
+    }
+
+private:
+    std::size_t Nx_;
+    AxisTransform x_, y_;
+    double alpha_ = 0.0, beta_ = 0.0, gamma_ = 0.0;
+};
+
+} // namespace
+
+std::optional<FastPoissonSolver::Coefficients> FastPoissonSolver::fromExpressions(
+    const CompiledExpression& a11, const CompiledExpression& a12, const CompiledExpression& a22,
+    const CompiledExpression& b1, const CompiledExpression& b2, const CompiledExpression& c
+) {
+    for (const CompiledExpression* expression : { &a11, &a12, &a22, &b1, &b2, &c }) {
+        if (!expression->isConstant()) return std::nullopt;
+    }
+    if (a12.constantValue() != 0.0 || b1.constantValue() != 0.0 || b2.constantValue() != 0.0) {
+        return std::nullopt;
+    }
+    return Coefficients{ a11.constantValue(), a22.constantValue(), c.constantValue() };
+}
+
+FastPoissonSolver::FastPoissonSolver(const Coefficients& coefficients, CoefficientFunction f_func)
+    : coefficients_(coefficients), f_func_(std::move(f_func)) {}
+
+bool FastPoissonSolver::supports(
+    const StructuredMeshView& grid, const Coefficients& coefficients,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    if (!grid.isUniform() || !(coefficients.a11 > 0.0) || !(coefficients.a22 > 0.0) ||
+        !(coefficients.c >= 0.0) || !std::isfinite(coefficients.a11 + coefficients.a22 + coefficients.c)) {
+        return false;
+    }
+    bool anyDirichlet = false;
+    for (const auto& pair : boundaryConditions) {
+        if (pair.first != "west" && pair.first != "east" && pair.first != "south" && pair.first != "north") return false;
+        if (pair.second.type == "dirichlet") {
+            anyDirichlet = true;
+        } else if (pair.second.type != "neumann") {
+            return false;
+        }
+    }
+    return anyDirichlet || coefficients.c > 0.0;
+}
+
+bool FastPoissonSolver::isFasterThanIteration(
+    const StructuredMeshView& grid, const Coefficients& coefficients,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    double transformWork = 0.0, iterations = 0.0;
+    auto addAxis = [&](int nodes, bool dirichletLow, bool dirichletHigh) {
+        const std::size_t cells = static_cast<std::size_t>(nodes - 1);
+        const bool mixed = dirichletLow != dirichletHigh;
+        const std::size_t length = (mixed ? 4 : 2) * cells; // See AxisTransform
+        transformWork += (mixed ? 4.0 : 2.0) * FFT(length).costPerPoint();
+        iterations = std::max(iterations, kIterationsPerCell * static_cast<double>(cells) * (mixed ? 2.0 : 1.0));
+    };
+    addAxis(grid.getNx(), isDirichlet(boundaryConditions, "west"), isDirichlet(boundaryConditions, "east"));
+    addAxis(grid.getNy(), isDirichlet(boundaryConditions, "south"), isDirichlet(boundaryConditions, "north"));
+
+    // Exact for c = 0; otherwise the preconditioned iteration typically takes one or two steps
+    const double transformSolves = coefficients.c == 0.0 ? 1.0 : 2.0;
+    return transformSolves * transformWork * kIterationsPerTransformWork < iterations;
+}
+
+std::vector<double> FastPoissonSolver::solve(
+    const StructuredMeshView& grid, const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    if (!supports(grid, coefficients_, boundaryConditions)) {
+        throw std::invalid_argument("Fast Poisson solver needs constant positive a11, a22, c >= 0, a uniform grid "
+                                    "and Dirichlet or Neumann sides with at least one Dirichlet side when c = 0");
+    }
+
+    // The system of StencilSolver with the constant coefficients
+    auto constant = [](double value) -> CoefficientFunction {
+        return [value](double, double) { return value; };
+    };
+    StencilSolver stencilSolver(constant(coefficients_.a11), nullptr, constant(coefficients_.a22), nullptr, nullptr,
+                                coefficients_.c != 0.0 ? constant(coefficients_.c) : nullptr, f_func_);
+    auto [A, F] = stencilSolver.assemble(grid);
+    A.applyDirichlet(stencilSolver.applyBoundaryConditions(grid, boundaryConditions, F), F);
+    A.detectConstantInterior();
+
+    // The transform solve is the initial guess and the preconditioner; for c = 0 the guess is
+    // already the solution
+    TransformSolve transformSolve(grid, coefficients_, boundaryConditions);
+    std::vector<double> solution;
+    transformSolve.apply(F, solution);
+    report_ = krylov::preconditionedConjugateGradient(
+        A, F, solution,
+        [&](const std::vector<double>& r, std::vector<double>& z) { transformSolve.apply(r, z); },
+        tolerance_, maxIterations_, "FFT-preconditioned conjugate gradients");
+    if (!report_.converged) {
+        throw std::runtime_error("Iterative solver did not converge: " + report_.describe());
+    }
+    return solution;
+}
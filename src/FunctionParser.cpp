@@ -5,6 +5,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include <math.h>
+#include <algorithm>
 
 // Simple mathematical expression evaluator
 class ExpressionEvaluator {
@@ -184,22 +185,412 @@ double ExpressionEvaluator::parsePrimary() {
     throw std::runtime_error("Unknown function or variable: " + funcName);
 }
 
+// Compiler producing a postfix program with the same grammar and error behaviour as ExpressionEvaluator.
+// Operations on constant operands are folded while emitting.
+class ExpressionCompiler {
+private:
+    using OpCode = CompiledExpression::OpCode;
+    using Instruction = CompiledExpression::Instruction;
+
+    std::string expression;
+    size_t pos;
+    std::vector<Instruction> program;
+    int depth, maxDepth;
+    bool usesX, usesY;
+
+    char peek() const {
+        if (pos >= expression.length()) return 0;
+        return expression[pos];
+    }
+
+    char get() {
+        if (pos >= expression.length()) return 0;
+        return expression[pos++];
+    }
+
+    void skipWhitespace() {
+        while (std::isspace(peek())) get();
+    }
+
+    void push(Instruction instruction) {
+        program.push_back(instruction);
+        if (++depth > maxDepth) maxDepth = depth;
+    }
+
+    void emitConstant(double value) { push({ OpCode::Constant, value }); }
+    void emitUnary(OpCode op);
+    void emitBinary(OpCode op);
+    void emitFunctionCall(OpCode op);
+
+    void parseExpression();
+    void parseTerm();
+    void parseFactor();
+    void parsePrimary();
+
+public:
+    explicit ExpressionCompiler(const std::string& expr)
+        : expression(expr), pos(0), depth(0), maxDepth(0), usesX(false), usesY(false) {}
+
+    void compile(CompiledExpression& result);
+};
+
+// Apply a unary operation to a scalar, throwing where ExpressionEvaluator would
+static double applyUnary(CompiledExpression::OpCode op, double arg) {
+    using OpCode = CompiledExpression::OpCode;
+    switch (op) {
+        case OpCode::Neg: return -arg;
+        case OpCode::Sin: return std::sin(arg);
+        case OpCode::Cos: return std::cos(arg);
+        case OpCode::Tan: return std::tan(arg);
+        case OpCode::Exp: return std::exp(arg);
+        case OpCode::Log: return std::log(arg);
+        case OpCode::Sqrt:
+            if (arg < 0) throw std::runtime_error("Square root of negative number");
+            return std::sqrt(arg);
+        case OpCode::Abs: return std::abs(arg);
+        default: throw std::logic_error("Not a unary operation");
+    }
+}
+
+static double applyBinary(CompiledExpression::OpCode op, double left, double right) {
+    using OpCode = CompiledExpression::OpCode;
+    switch (op) {
+        case OpCode::Add: return left + right;
+        case OpCode::Sub: return left - right;
+        case OpCode::Mul: return left * right;
+        case OpCode::Div:
+            if (right == 0) throw std::runtime_error("Division by zero");
+            return left / right;
+        default: throw std::logic_error("Not a binary operation");
+    }
+}
+
+void ExpressionCompiler::emitUnary(OpCode op) {
+    Instruction& arg = program.back();
+    if (arg.op == OpCode::Constant) {
+        arg.value = applyUnary(op, arg.value);
+    } else {
+        program.push_back({ op, 0.0 });
+    }
+}
+
+void ExpressionCompiler::emitBinary(OpCode op) {
+    // The right operand is complete at the end of the program; a constant there preceded by a
+    // constant means both operands are single constants
+    size_t n = program.size();
+    if (n >= 2 && program[n - 1].op == OpCode::Constant && program[n - 2].op == OpCode::Constant) {
+        program[n - 2].value = applyBinary(op, program[n - 2].value, program[n - 1].value);
+        program.pop_back();
+    } else {
+        program.push_back({ op, 0.0 });
+    }
+    --depth;
+}
+
+void ExpressionCompiler::emitFunctionCall(OpCode op) {
+    if (get() != '(') throw std::runtime_error("Expected '(' after function name");
+    parseExpression();
+    if (get() != ')') throw std::runtime_error("Expected ')' after function argument");
+    emitUnary(op);
+}
+
+void ExpressionCompiler::compile(CompiledExpression& result) {
+    pos = 0;
+    parseExpression();
+    skipWhitespace();
+    if (pos < expression.length()) {
+        throw std::runtime_error("Unexpected character at end of expression");
+    }
+    result.program_ = std::move(program);
+    result.stackDepth_ = maxDepth;
+    result.usesX_ = usesX;
+    result.usesY_ = usesY;
+    result.valid_ = true;
+}
+
+void ExpressionCompiler::parseExpression() {
+    parseTerm();
+
+    while (true) {
+        skipWhitespace();
+        char op = peek();
+        if (op == '+' || op == '-') {
+            get(); // consume operator
+            parseTerm();
+            emitBinary(op == '+' ? OpCode::Add : OpCode::Sub);
+        } else {
+            break;
+        }
+    }
+}
+
+void ExpressionCompiler::parseTerm() {
+    parseFactor();
+
+    while (true) {
+        skipWhitespace();
+        char op = peek();
+        if (op == '*' || op == '/') {
+            get(); // consume operator
+            parseFactor();
+            emitBinary(op == '*' ? OpCode::Mul : OpCode::Div);
+        } else {
+            break;
+        }
+    }
+}
+
+void ExpressionCompiler::parseFactor() {
+    skipWhitespace();
+    char op = peek();
+    if (op == '+' || op == '-') {
+        get(); // consume operator
+        parsePrimary();
+        if (op == '-') emitUnary(OpCode::Neg);
+        return;
+    }
+    parsePrimary();
+}
+
+void ExpressionCompiler::parsePrimary() {
+    skipWhitespace();
+
+    // Handle numbers
+    if (std::isdigit(peek()) || peek() == '.') {
+        std::string numStr;
+        while (std::isdigit(peek()) || peek() == '.') {
+            numStr += get();
+        }
+        emitConstant(std::stod(numStr));
+        return;
+    }
+
+    // Handle variables
+    if (peek() == 'x') {
+        get();
+        usesX = true;
+        push({ OpCode::VarX, 0.0 });
+        return;
+    }
+    if (peek() == 'y') {
+        get();
+        usesY = true;
+        push({ OpCode::VarY, 0.0 });
+        return;
+    }
+
+    // Handle functions
+    std::string funcName;
+    while (std::isalpha(peek()) || peek() == '_') {
+        funcName += get();
+    }
+
+    if (funcName == "sin") {
+        emitFunctionCall(OpCode::Sin);
+        return;
+    } else if (funcName == "cos") {
+        emitFunctionCall(OpCode::Cos);
+        return;
+    } else if (funcName == "tan") {
+        emitFunctionCall(OpCode::Tan);
+        return;
+    } else if (funcName == "exp") {
+        emitFunctionCall(OpCode::Exp);
+        return;
+    } else if (funcName == "log") {
+        emitFunctionCall(OpCode::Log);
+        return;
+    } else if (funcName == "sqrt") {
+        emitFunctionCall(OpCode::Sqrt);
+        return;
+    } else if (funcName == "abs") {
+        emitFunctionCall(OpCode::Abs);
+        return;
+    } else if (funcName == "pi") {
+        emitConstant(M_PI);
+        return;
+    } else if (funcName.empty()) {
+        // Handle parentheses
+        if (peek() == '(') {
+            get(); // consume '('
+            parseExpression();
+            if (get() != ')') throw std::runtime_error("Expected ')'");
+            return;
+        }
+    }
+
+    throw std::runtime_error("Unknown function or variable: " + funcName);
+}
+
+// Implementation of CompiledExpression methods
+double CompiledExpression::evaluate(double x, double y) const {
+    const int kInlineDepth = 32;
+    if (stackDepth_ > kInlineDepth) {
+        double result;
+        evaluate(&x, &y, &result, 1);
+        return result;
+    }
+
+    double stack[kInlineDepth];
+    int top = -1;
+    try {
+        for (const Instruction& instruction : program_) {
+            switch (instruction.op) {
+                case OpCode::Constant: stack[++top] = instruction.value; break;
+                case OpCode::VarX: stack[++top] = x; break;
+                case OpCode::VarY: stack[++top] = y; break;
+                case OpCode::Add: case OpCode::Sub: case OpCode::Mul: case OpCode::Div:
+                    stack[top - 1] = applyBinary(instruction.op, stack[top - 1], stack[top]);
+                    --top;
+                    break;
+                default:
+                    stack[top] = applyUnary(instruction.op, stack[top]);
+                    break;
+            }
+        }
+    } catch (...) {
+        return 0.0; // Return 0.0 on error
+    }
+    return top == 0 ? stack[0] : 0.0;
+}
+
+void CompiledExpression::evaluate(const double* x, const double* y, double* out, std::size_t n) const {
+    if (isConstant() || !valid_) {
+        std::fill(out, out + n, constantValue());
+        return;
+    }
+
+    // Run the program over chunks of points; each instruction is a simple loop over the chunk
+    const std::size_t kChunk = 64;
+    std::vector<double> stack(static_cast<std::size_t>(stackDepth_) * kChunk);
+    bool failed[kChunk];
+
+    for (std::size_t start = 0; start < n; start += kChunk) {
+        const std::size_t m = std::min(kChunk, n - start);
+        const double* xs = x + start;
+        const double* ys = y + start;
+        std::fill(failed, failed + m, false);
+
+        // Stack slot k occupies stack[k * kChunk, (k + 1) * kChunk)
+        double* base = stack.data();
+        std::size_t sp = 0;
+        for (const Instruction& instruction : program_) {
+            double* top = base + (sp > 0 ? sp - 1 : 0) * kChunk;
+            double* below = sp > 1 ? top - kChunk : top;
+            switch (instruction.op) {
+                case OpCode::Constant:
+                    std::fill(base + sp * kChunk, base + sp * kChunk + m, instruction.value);
+                    ++sp;
+                    break;
+                case OpCode::VarX:
+                    std::copy(xs, xs + m, base + sp * kChunk);
+                    ++sp;
+                    break;
+                case OpCode::VarY:
+                    std::copy(ys, ys + m, base + sp * kChunk);
+                    ++sp;
+                    break;
+                case OpCode::Add:
+                    for (std::size_t i = 0; i < m; ++i) below[i] += top[i];
+                    --sp;
+                    break;
+                case OpCode::Sub:
+                    for (std::size_t i = 0; i < m; ++i) below[i] -= top[i];
+                    --sp;
+                    break;
+                case OpCode::Mul:
+                    for (std::size_t i = 0; i < m; ++i) below[i] *= top[i];
+                    --sp;
+                    break;
+                case OpCode::Div:
+                    for (std::size_t i = 0; i < m; ++i) {
+                        failed[i] |= (top[i] == 0);
+                        below[i] /= top[i];
+                    }
+                    --sp;
+                    break;
+                case OpCode::Neg:
+                    for (std::size_t i = 0; i < m; ++i) top[i] = -top[i];
+                    break;
+                case OpCode::Sin:
+                    for (std::size_t i = 0; i < m; ++i) top[i] = std::sin(top[i]);
+                    break;
+                case OpCode::Cos:
+                    for (std::size_t i = 0; i < m; ++i) top[i] = std::cos(top[i]);
+                    break;
+                case OpCode::Tan:
+                    for (std::size_t i = 0; i < m; ++i) top[i] = std::tan(top[i]);
+                    break;
+                case OpCode::Exp:
+                    for (std::size_t i = 0; i < m; ++i) top[i] = std::exp(top[i]);
+                    break;
+                case OpCode::Log:
+                    for (std::size_t i = 0; i < m; ++i) top[i] = std::log(top[i]);
+                    break;
+                case OpCode::Sqrt:
+                    for (std::size_t i = 0; i < m; ++i) {
+                        failed[i] |= (top[i] < 0);
+                        top[i] = std::sqrt(top[i]);
+                    }
+                    break;
+                case OpCode::Abs:
+                    for (std::size_t i = 0; i < m; ++i) top[i] = std::abs(top[i]);
+                    break;
+            }
+        }
+
+        const double* result = base;
+        for (std::size_t i = 0; i < m; ++i) {
+            out[start + i] = failed[i] ? 0.0 : result[i];
+        }
+    }
+}
+
 // Implementation of FunctionParser methods
 CoefficientFunction FunctionParser::parseFunction(const std::string& funcStr) {
     if (funcStr.empty()) {
         return [](double, double) -> double { return 0.0; };
     }
     
-    return [funcStr](double x, double y) -> double {
-        try {
-            ExpressionEvaluator evaluator(funcStr, x, y);
-            return evaluator.evaluate();
-        } catch (...) {
-            return 0.0; // Return 0.0 on error
-        }
+    return toFunction(compile(funcStr));
+}
+
+BatchCoefficientFunction FunctionParser::parseBatchFunction(const std::string& funcStr) {
+    return toBatchFunction(compile(funcStr));
+}
+
+CoefficientFunction FunctionParser::toFunction(std::shared_ptr<const CompiledExpression> compiled) {
+    if (compiled->isConstant()) {
+        double value = compiled->constantValue();
+        return [value](double, double) -> double { return value; };
+    }
+    return [compiled](double x, double y) -> double {
+        return compiled->evaluate(x, y);
     };
 }
 
+BatchCoefficientFunction FunctionParser::toBatchFunction(std::shared_ptr<const CompiledExpression> compiled) {
+    return [compiled](const double* x, const double* y, double* out, std::size_t n) {
+        compiled->evaluate(x, y, out, n);
+    };
+}
+
+std::shared_ptr<const CompiledExpression> FunctionParser::compile(const std::string& funcStr) {
+    auto result = std::make_shared<CompiledExpression>();
+    result->source_ = funcStr;
+    try {
+        ExpressionCompiler compiler(funcStr);
+        compiler.compile(*result);
+    } catch (...) {
+        // Invalid expressions (and empty strings) evaluate to 0.0, as with parseFunction
+        result->program_.assign(1, { CompiledExpression::OpCode::Constant, 0.0 });
+        result->stackDepth_ = 1;
+        result->usesX_ = result->usesY_ = false;
+        result->valid_ = false;
+    }
+    return result;
+}
+
 double FunctionParser::safeEval(const std::string& expression, double x, double y) {
     try {
         ExpressionEvaluator evaluator(expression, x, y);
@@ -647,7 +647,7 @@ void OnSolveButtonClicked(HWND hwnd) {
                     solutionInfo << L"Solution Details:\n";
                     solutionInfo << L"-------------------\n";
                     solutionInfo << L"Nodes: " << solution.size() << L"\n";
-                    solutionInfo << L"Elements: " << mesh.elements.size() << L"\n";
+                    solutionInfo << L"Elements: " << mesh.elementCount() << L"\n";
                     solutionInfo << L"Domain: [0, " << g_appData.Lx << L"] x [0, " << g_appData.Ly << L"]\n";
                     solutionInfo << L"Mesh: " << g_appData.Nx << L" x " << g_appData.Ny << L" nodes\n";
                     solutionInfo << L"Min value: " << min_val << L"\n";
@@ -12,7 +12,7 @@ void GdiVisualizer::setWindowHandle(HWND handle) {
 }
 
 void GdiVisualizer::render(const Mesh& mesh, const std::vector<double>& solution, int Nx, int Ny, const std::string& title) {
-    if (mesh.nodes.empty() || solution.empty() || !hwndTarget_) {
+    if (mesh.empty() || solution.empty() || !hwndTarget_) {
         // No valid data or target window, clear previous solution and set flag
         hasSolution_ = false;
         mesh_ = Mesh(); // Clear mesh
@@ -56,7 +56,7 @@ void GdiVisualizer::drawInternal(HDC hdc, const RECT& rect) {
         // Draw solution stats
         std::wostringstream wstats;
         wstats << L"Nodes: " << solution_.size()
-                << L", Elements: " << mesh_.elements.size();
+                << L", Elements: " << mesh_.elementCount();
         TextOutW(hdc, 10, 30, wstats.str().c_str(), static_cast<int>(wstats.str().length()));
 
         // Draw a simplified visualization
@@ -89,8 +89,8 @@ void GdiVisualizer::drawInternal(HDC hdc, const RECT& rect) {
                             x_original = std::min(x_original, Nx_ - 1); // Clamp to avoid out of bounds
                             y_original = std::min(y_original, Ny_ - 1); // Clamp to avoid out of bounds
 
-                            int original_idx = y_original * Nx_ + x_original;
-                            if (original_idx >= 0 && original_idx < static_cast<int>(solution_.size())) {
+                            MeshIndex original_idx = static_cast<MeshIndex>(y_original) * Nx_ + x_original;
+                            if (original_idx >= 0 && static_cast<size_t>(original_idx) < solution_.size()) {
                                 double val = solution_[original_idx];
                                 double normVal = (range != 0) ? (val - minVal) / range : 0.0;
 
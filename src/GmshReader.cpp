@@ -0,0 +1,453 @@
+#include "GmshReader.h"
+#include "MappedFile.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+// Records (lines of ASCII text, fixed-size binary records) parsed by one task
+constexpr std::size_t kChunkRecords = 16384;
+
+[[noreturn]] void fail(const std::string& source, const std::string& message) {
+    throw std::runtime_error("Gmsh file " + source + ": " + message);
+}
+
+// Position in the mapped file. Text numbers are read with from_chars, so no line is ever copied
+// into a string; binary values are stored in native byte order (checked by the file header).
+struct Cursor {
+    const char* p;
+    const char* end;
+    const std::string* source;
+
+    void skipSpace() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) ++p;
+    }
+
+    template <class T>
+    T integer() {
+        skipSpace();
+        T value{};
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) fail(*source, "expected an integer");
+        p = result.ptr;
+        return value;
+    }
+
+    double real() {
+        skipSpace();
+        double value = 0.0;
+        auto result = std::from_chars(p, end, value);
+        if (result.ec != std::errc()) fail(*source, "expected a number");
+        p = result.ptr;
+        return value;
+    }
+
+    template <class T>
+    T binary() {
+        if (static_cast<std::size_t>(end - p) < sizeof(T)) fail(*source, "unexpected end of file");
+        T value;
+        std::memcpy(&value, p, sizeof(T));
+        p += sizeof(T);
+        return value;
+    }
+
+    void skipLine() {
+        const void* newline = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+        p = newline ? static_cast<const char*>(newline) + 1 : end;
+    }
+
+    void skipLines(std::size_t count) {
+        for (std::size_t k = 0; k < count; ++k) {
+            if (p >= end) fail(*source, "unexpected end of file");
+            skipLine();
+        }
+    }
+
+    void skipBytes(std::size_t count) {
+        if (static_cast<std::size_t>(end - p) < count) fail(*source, "unexpected end of file");
+        p += count;
+    }
+};
+
+// Reads the header fields of the MSH 4.1 sections, whose types are the same in both formats
+// (size_t fields are 8 bytes, the only data size accepted)
+struct FieldReader {
+    Cursor& c;
+    bool binary;
+
+    std::uint64_t size() { return binary ? c.binary<std::uint64_t>() : c.integer<std::uint64_t>(); }
+    int integer() { return binary ? c.binary<std::int32_t>() : c.integer<int>(); }
+    double real() { return binary ? c.binary<double>() : c.real(); }
+    // Move to the first record after a block header
+    void endHeader() { if (!binary) c.skipLine(); }
+};
+
+// Consecutive records of one block handed to a parallel task
+struct Chunk {
+    const char* begin;  // First record
+    std::size_t first;  // Index of the first record in the output
+    std::size_t count;
+    int values;         // Numbers per record
+    int keep;           // Node numbers stored per element record
+    MeshIndexVector* out;
+};
+
+// Split `records` records starting at the cursor into chunks and move the cursor past them
+void splitRecords(Cursor& c, bool binary, std::size_t records, int values, int keep, std::size_t first,
+                  MeshIndexVector* out, std::vector<Chunk>& chunks) {
+    for (std::size_t k = 0; k < records; k += kChunkRecords) {
+        std::size_t count = std::min(kChunkRecords, records - k);
+        chunks.push_back({ c.p, first + k, count, values, keep, out });
+        if (binary) {
+            c.skipBytes(count * values * sizeof(std::uint64_t));
+        } else {
+            c.skipLines(count);
+        }
+    }
+}
+
+// Nodes per element of the MSH element types (0 for unknown types)
+int nodesPerElement(int type) {
+    switch (type) {
+    case 15: return 1;          // Point
+    case 1: return 2;           // Line
+    case 8: return 3;           // 3-node line
+    case 26: return 4;          // 4-node line
+    case 2: return 3;           // Triangle
+    case 9: return 6;           // 6-node triangle
+    case 21: return 10;         // 10-node triangle
+    case 3: return 4;           // Quadrangle
+    case 16: return 8;          // 8-node quadrangle
+    case 10: return 9;          // 9-node quadrangle
+    case 4: return 4;           // Tetrahedron
+    case 11: return 10;         // 10-node tetrahedron
+    case 5: return 8;           // Hexahedron
+    case 6: return 6;           // Prism
+    case 7: return 5;           // Pyramid
+    default: return 0;
+    }
+}
+
+// Node tag -> index in file order: a table over [minTag, maxTag] when the tags are dense enough,
+// otherwise binary search over the sorted tags
+class NodeLookup {
+public:
+    void build(const std::vector<std::uint64_t>& tags, std::uint64_t minTag, std::uint64_t maxTag,
+               const std::string& source) {
+        const std::size_t n = tags.size();
+        dense_ = n > 0 && maxTag >= minTag && maxTag - minTag < 4 * static_cast<std::uint64_t>(n) + 1024;
+        if (dense_) {
+            minTag_ = minTag;
+            table_.assign(static_cast<std::size_t>(maxTag - minTag + 1), -1);
+            parallelFor(n, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    if (tags[i] < minTag || tags[i] > maxTag) fail(source, "node tag outside the declared range");
+                    table_[static_cast<std::size_t>(tags[i] - minTag)] = static_cast<MeshIndex>(i);
+                }
+            });
+        } else {
+            sorted_.resize(n);
+            parallelFor(n, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) sorted_[i] = { tags[i], static_cast<MeshIndex>(i) };
+            });
+            std::sort(sorted_.begin(), sorted_.end());
+        }
+    }
+
+    // -1 for unknown tags
+    MeshIndex find(std::uint64_t tag) const {
+        if (dense_) {
+            return tag >= minTag_ && tag - minTag_ < table_.size() ? table_[static_cast<std::size_t>(tag - minTag_)] : -1;
+        }
+        auto it = std::lower_bound(sorted_.begin(), sorted_.end(), std::make_pair(tag, static_cast<MeshIndex>(-1)));
+        return it != sorted_.end() && it->first == tag ? it->second : -1;
+    }
+
+private:
+    bool dense_ = true;
+    std::uint64_t minTag_ = 0;
+    std::vector<MeshIndex> table_;
+    std::vector<std::pair<std::uint64_t, MeshIndex>> sorted_;
+};
+
+using EntityKey = std::pair<int, int>; // (dimension, tag)
+
+} // namespace
+
+Mesh GmshReader::read(const std::string& filename) {
+    MappedFile file(filename);
+    return parse(file.data(), file.size(), filename);
+}
+
+Mesh GmshReader::parse(const char* data, std::size_t size, const std::string& source) {
+    auto startTime = std::chrono::steady_clock::now();
+    statistics_ = Statistics();
+    statistics_.fileBytes = size;
+
+    Cursor c{ data, data + size, &source };
+    bool haveFormat = false, binary = false;
+    std::map<EntityKey, std::string> physicalNames;
+    std::map<EntityKey, std::vector<int>> entityPhysicals; // Points and curves only
+
+    std::vector<std::uint64_t> nodeTags;
+    std::vector<double> nodeX, nodeY;
+    NodeLookup lookup;
+    bool haveNodes = false, haveElements = false;
+
+    MeshIndexVector connectivity;
+    struct BoundaryBlock { EntityKey entity; MeshIndexVector nodes; };
+    std::vector<BoundaryBlock> boundaryBlocks;
+
+    while (true) {
+        c.skipSpace();
+        if (c.p >= c.end) break;
+        if (*c.p != '$') fail(source, "expected a section");
+        const char* nameBegin = c.p + 1;
+        const char* nameEnd = nameBegin;
+        while (nameEnd < c.end && *nameEnd != '\n' && *nameEnd != '\r' && *nameEnd != ' ') ++nameEnd;
+        const std::string section(nameBegin, nameEnd);
+        c.p = nameEnd;
+        c.skipLine();
+
+        FieldReader r{ c, binary };
+        if (section == "MeshFormat") {
+            c.skipSpace();
+            const char* versionBegin = c.p;
+            double version = c.real();
+            const std::string versionText(versionBegin, c.p);
+            int fileType = c.integer<int>();
+            int dataSize = c.integer<int>();
+            if (version < 4.1 || version >= 5.0) {
+                fail(source, "only MSH 4.1 files are supported (this one is version " + versionText + ")");
+            }
+            if (dataSize != 8) fail(source, "unsupported data size " + std::to_string(dataSize));
+            binary = fileType == 1;
+            if (binary) {
+                c.skipLine();
+                if (c.binary<std::int32_t>() != 1) fail(source, "binary file written with a different byte order");
+            }
+            haveFormat = true;
+        } else if (!haveFormat) {
+            fail(source, "missing $MeshFormat");
+        } else if (section == "PhysicalNames") {
+            // Always text, even in binary files
+            std::size_t count = c.integer<std::size_t>();
+            for (std::size_t k = 0; k < count; ++k) {
+                int dim = c.integer<int>();
+                int tag = c.integer<int>();
+                c.skipSpace();
+                const char* quote = c.p < c.end && *c.p == '"' ? c.p + 1 : nullptr;
+                const char* close = quote ? static_cast<const char*>(std::memchr(quote, '"', c.end - quote)) : nullptr;
+                if (!close) fail(source, "invalid physical name");
+                physicalNames[{ dim, tag }] = std::string(quote, close);
+                c.p = close + 1;
+            }
+        } else if (section == "Entities") {
+            std::uint64_t counts[4];
+            for (auto& count : counts) count = r.size();
+            for (int dim = 0; dim < 4; ++dim) {
+                for (std::uint64_t k = 0; k < counts[dim]; ++k) {
+                    int tag = r.integer();
+                    for (int v = 0; v < (dim == 0 ? 3 : 6); ++v) r.real(); // Point or bounding box
+                    std::vector<int> physicals(static_cast<std::size_t>(r.size()));
+                    for (int& physical : physicals) physical = r.integer();
+                    if (dim > 0) {
+                        std::uint64_t bounding = r.size();
+                        for (std::uint64_t b = 0; b < bounding; ++b) r.integer();
+                    }
+                    if (dim <= 1 && !physicals.empty()) entityPhysicals[{ dim, tag }] = std::move(physicals);
+                }
+            }
+        } else if (section == "Nodes") {
+            std::uint64_t blocks = r.size(), total = r.size(), minTag = r.size(), maxTag = r.size();
+            if (!fitsMeshIndex(static_cast<std::size_t>(total))) {
+                fail(source, "mesh too large for 32-bit indices: build with FEMSOLVER_INDEX64");
+            }
+            nodeTags.resize(static_cast<std::size_t>(total));
+            nodeX.resize(static_cast<std::size_t>(total));
+            nodeY.resize(static_cast<std::size_t>(total));
+
+            // Sequential pass over the block headers, then parse the records in parallel
+            std::vector<Chunk> tagChunks, coordinateChunks;
+            std::size_t offset = 0;
+            for (std::uint64_t b = 0; b < blocks; ++b) {
+                int dim = r.integer();
+                r.integer(); // Entity tag
+                int parametric = r.integer();
+                std::size_t count = static_cast<std::size_t>(r.size());
+                r.endHeader();
+                if (count > total - offset) fail(source, "more nodes than declared");
+                splitRecords(c, binary, count, 1, 0, offset, nullptr, tagChunks);
+                splitRecords(c, binary, count, 3 + (parametric ? dim : 0), 0, offset, nullptr, coordinateChunks);
+                offset += count;
+            }
+            if (offset != total) fail(source, "fewer nodes than declared");
+
+            parallelFor(tagChunks.size(), [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; ++k) {
+                    const Chunk& chunk = tagChunks[k];
+                    Cursor local{ chunk.begin, c.end, &source };
+                    for (std::size_t i = 0; i < chunk.count; ++i) {
+                        nodeTags[chunk.first + i] = binary ? local.binary<std::uint64_t>() : local.integer<std::uint64_t>();
+                    }
+                }
+            }, 1);
+            parallelFor(coordinateChunks.size(), [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; ++k) {
+                    const Chunk& chunk = coordinateChunks[k];
+                    Cursor local{ chunk.begin, c.end, &source };
+                    for (std::size_t i = 0; i < chunk.count; ++i) {
+                        if (binary) {
+                            nodeX[chunk.first + i] = local.binary<double>();
+                            nodeY[chunk.first + i] = local.binary<double>();
+                            local.p += (chunk.values - 2) * sizeof(double);
+                        } else {
+                            nodeX[chunk.first + i] = local.real();
+                            nodeY[chunk.first + i] = local.real();
+                            for (int v = 2; v < chunk.values; ++v) local.real();
+                        }
+                    }
+                }
+            }, 1);
+            lookup.build(nodeTags, minTag, maxTag, source);
+            haveNodes = true;
+        } else if (section == "Elements") {
+            if (!haveNodes) fail(source, "$Elements before $Nodes");
+            std::uint64_t blocks = r.size();
+            r.size(); // Element count, including points and lines
+            r.size();
+            r.size();
+
+            // Chunks refer to their output vector, which is sized before the parallel parse:
+            // `connectivity` once all blocks are counted, boundary blocks up front (the reserve
+            // keeps them in place)
+            std::vector<Chunk> chunks;
+            std::size_t triangles = 0;
+            boundaryBlocks.reserve(static_cast<std::size_t>(blocks));
+            for (std::uint64_t b = 0; b < blocks; ++b) {
+                int dim = r.integer();
+                int entity = r.integer();
+                int type = r.integer();
+                std::size_t count = static_cast<std::size_t>(r.size());
+                r.endHeader();
+                int nodes = nodesPerElement(type);
+                if (nodes == 0) fail(source, "unknown element type " + std::to_string(type));
+                if (dim == 3) fail(source, "volume elements are not supported");
+
+                if (type == 2) {
+                    splitRecords(c, binary, count, 1 + nodes, 3, triangles, &connectivity, chunks);
+                    triangles += count;
+                } else if (dim == 2) {
+                    fail(source, "unsupported surface element type " + std::to_string(type) + " (only 3-node triangles)");
+                } else if (entityPhysicals.count({ dim, entity })) {
+                    int keep = dim == 0 ? 1 : 2; // End points of (possibly curved) lines
+                    boundaryBlocks.push_back({ { dim, entity }, MeshIndexVector(count * keep) });
+                    splitRecords(c, binary, count, 1 + nodes, keep, 0, &boundaryBlocks.back().nodes, chunks);
+                    statistics_.boundaryElements += count;
+                } else if (binary) {
+                    c.skipBytes(count * (1 + nodes) * sizeof(std::uint64_t));
+                } else {
+                    c.skipLines(count);
+                }
+            }
+            if (!fitsMeshIndex(triangles)) {
+                fail(source, "mesh too large for 32-bit indices: build with FEMSOLVER_INDEX64");
+            }
+            connectivity.resize(3 * triangles);
+
+            parallelFor(chunks.size(), [&](std::size_t begin, std::size_t end) {
+                for (std::size_t k = begin; k < end; ++k) {
+                    const Chunk& chunk = chunks[k];
+                    Cursor local{ chunk.begin, c.end, &source };
+                    MeshIndex* out = chunk.out->data() + chunk.first * chunk.keep;
+                    for (std::size_t i = 0; i < chunk.count; ++i) {
+                        if (binary) local.p += sizeof(std::uint64_t); else local.integer<std::uint64_t>(); // Element tag
+                        for (int j = 1; j < chunk.values; ++j) {
+                            std::uint64_t tag = binary ? local.binary<std::uint64_t>() : local.integer<std::uint64_t>();
+                            if (j > chunk.keep) continue;
+                            MeshIndex node = lookup.find(tag);
+                            if (node < 0) fail(source, "element uses unknown node " + std::to_string(tag));
+                            *out++ = node;
+                        }
+                    }
+                }
+            }, 1);
+            haveElements = true;
+        }
+
+        // Skip to the end of the section (unknown sections are skipped whole)
+        const std::string marker = "$End" + section;
+        const char* found = std::search(c.p, c.end, marker.begin(), marker.end());
+        if (found == c.end) fail(source, "missing " + marker);
+        c.p = found + marker.size();
+    }
+    if (!haveElements) fail(source, "no $Nodes and $Elements sections");
+
+    const std::size_t nTriangles = connectivity.size() / 3;
+    if (nTriangles == 0) fail(source, "no triangles");
+
+    // Counterclockwise orientation, as the assembly expects
+    parallelFor(nTriangles, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t e = begin; e < end; ++e) {
+            MeshIndex* t = &connectivity[3 * e];
+            double cross = (nodeX[t[1]] - nodeX[t[0]]) * (nodeY[t[2]] - nodeY[t[0]]) -
+                           (nodeY[t[1]] - nodeY[t[0]]) * (nodeX[t[2]] - nodeX[t[0]]);
+            if (cross < 0.0) std::swap(t[1], t[2]);
+        }
+    });
+
+    // Keep the nodes used by triangles, in file order
+    std::vector<MeshIndex> newIndex(nodeX.size(), -1);
+    for (MeshIndex node : connectivity) newIndex[node] = 0;
+    std::size_t kept = 0;
+    for (MeshIndex& index : newIndex) {
+        if (index == 0) index = static_cast<MeshIndex>(kept++);
+    }
+
+    Mesh mesh;
+    mesh.id = newMeshId();
+    mesh.x.resize(kept);
+    mesh.y.resize(kept);
+    parallelFor(nodeX.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            if (newIndex[i] >= 0) {
+                mesh.x[newIndex[i]] = nodeX[i];
+                mesh.y[newIndex[i]] = nodeY[i];
+            }
+        }
+    });
+    parallelFor(connectivity.size(), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = begin; k < end; ++k) connectivity[k] = newIndex[connectivity[k]];
+    });
+    mesh.connectivity = std::move(connectivity);
+
+    // Physical groups of points and curves -> boundaries
+    std::map<EntityKey, std::vector<MeshIndex>> groups;
+    for (const BoundaryBlock& block : boundaryBlocks) {
+        for (int physical : entityPhysicals[block.entity]) {
+            std::vector<MeshIndex>& nodes = groups[{ block.entity.first, physical }];
+            for (MeshIndex node : block.nodes) {
+                if (newIndex[node] >= 0) nodes.push_back(newIndex[node]);
+            }
+        }
+    }
+    for (const auto& group : groups) {
+        auto name = physicalNames.find(group.first);
+        mesh.addBoundary(name != physicalNames.end() ? name->second : "physical" + std::to_string(group.first.second),
+                         group.second);
+    }
+
+    statistics_.binary = binary;
+    statistics_.nodes = mesh.nodeCount();
+    statistics_.triangles = mesh.elementCount();
+    statistics_.physicalGroups = groups.size();
+    statistics_.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    return mesh;
+}
@@ -0,0 +1,186 @@
+#include "GoalOrientedSolver.h"
+#include "EllipticFEMSolver.h"
+#include <chrono>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+QuantityOfInterest QuantityOfInterest::regionAverage(double x0, double x1, double y0, double y1) {
+    if (!(x1 > x0 && y1 > y0)) {
+        throw std::invalid_argument("Region of a quantity of interest must have positive area");
+    }
+    QuantityOfInterest quantity;
+    double scale = 1.0 / ((x1 - x0) * (y1 - y0));
+    quantity.weight = [=](double x, double y) {
+        return (x >= x0 && x <= x1 && y >= y0 && y <= y1) ? scale : 0.0;
+    };
+    return quantity;
+}
+
+QuantityOfInterest QuantityOfInterest::boundaryFlux(const std::string& boundary) {
+    QuantityOfInterest quantity;
+    quantity.fluxBoundary = boundary;
+    return quantity;
+}
+
+GoalOrientedSolver::GoalOrientedSolver(EllipticFEMSolver& solver, const ErrorEstimator& estimator, const QuantityOfInterest& quantity)
+    : solver_(solver), estimator_(estimator), adjointEstimator_(estimator), quantity_(quantity) {
+    if (!quantity_.weight && quantity_.fluxBoundary.empty()) {
+        throw std::invalid_argument("Quantity of interest has neither a weight nor a flux boundary");
+    }
+    // The adjoint weights only need the flux jumps, which do not involve the right-hand side
+    adjointEstimator_.setIndicator(ErrorIndicator::Kelly);
+}
+
+std::vector<double> GoalOrientedSolver::weightLoad(const Mesh& mesh) const {
+    std::vector<double> load(mesh.nodeCount(), 0.0);
+    if (!quantity_.weight) return load;
+
+    // Edge midpoint rule; each midpoint value is shared by the two nodes of its edge
+    for (std::size_t e = 0; e < mesh.elementCount(); ++e) {
+        const MeshIndex* t = &mesh.connectivity[3 * e];
+        double detJ = (mesh.x[t[1]] - mesh.x[t[0]]) * (mesh.y[t[2]] - mesh.y[t[0]]) -
+                      (mesh.x[t[2]] - mesh.x[t[0]]) * (mesh.y[t[1]] - mesh.y[t[0]]);
+        double weight = std::abs(detJ) / 12.0; // area / 3, halved
+        for (int k = 0; k < 3; ++k) {
+            MeshIndex a = t[(k + 1) % 3], b = t[(k + 2) % 3];
+            double g = quantity_.weight(0.5 * (mesh.x[a] + mesh.x[b]), 0.5 * (mesh.y[a] + mesh.y[b]));
+            load[a] += weight * g;
+            load[b] += weight * g;
+        }
+    }
+    return load;
+}
+
+std::map<std::string, BoundaryConditionData> GoalOrientedSolver::adjointConditions(
+    const Mesh& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) const {
+    if (!quantity_.fluxBoundary.empty()) {
+        auto flux = boundaryConditions.find(quantity_.fluxBoundary);
+        if (flux == boundaryConditions.end() || flux->second.type != "dirichlet" ||
+            mesh.boundaryTagBit(quantity_.fluxBoundary) < 0) {
+            throw std::invalid_argument("Flux quantity needs a Dirichlet boundary, got: " + quantity_.fluxBoundary);
+        }
+    }
+
+    std::map<std::string, BoundaryConditionData> conditions;
+    for (const auto& pair : boundaryConditions) {
+        const std::string& type = pair.second.type;
+        if (type != "dirichlet" && type != "neumann") continue;
+        BoundaryConditionData condition;
+        condition.type = type;
+        condition.value = pair.first == quantity_.fluxBoundary ? 1.0 : 0.0;
+        conditions[pair.first] = condition;
+    }
+    return conditions;
+}
+
+double GoalOrientedSolver::evaluate(
+    const Mesh& mesh,
+    const std::vector<double>& solution,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) const {
+    double value = 0.0;
+    if (quantity_.weight) {
+        std::vector<double> load = weightLoad(mesh);
+        for (std::size_t i = 0; i < load.size(); ++i) value += load[i] * solution[i];
+    }
+    if (!quantity_.fluxBoundary.empty()) {
+        // Sum of the residual against the adjoint boundary values, which resolve nodes on
+        // several Dirichlet boundaries like the solver does (the last name wins)
+        std::map<std::string, BoundaryConditionData> conditions = adjointConditions(mesh, boundaryConditions);
+        std::vector<double> r = solver_.residual(mesh, boundaryConditions, solution);
+        std::vector<std::pair<std::uint32_t, double>> dirichlet;
+        for (const auto& pair : conditions) {
+            int bit = mesh.boundaryTagBit(pair.first);
+            if (bit >= 0 && pair.second.type == "dirichlet") dirichlet.emplace_back(1u << bit, pair.second.value);
+        }
+        for (std::size_t i = 0; i < r.size(); ++i) {
+            std::uint32_t tags = mesh.boundaryTag(i);
+            double psi = 0.0;
+            for (const auto& condition : dirichlet) {
+                if (tags & condition.first) psi = condition.second;
+            }
+            value += psi * r[i];
+        }
+    }
+    return value;
+}
+
+GoalOrientedSolver::Result GoalOrientedSolver::solve(
+    const Mesh& initialMesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions
+) {
+    if (!(options_.targetError > 0.0)) {
+        throw std::invalid_argument("Adaptive solve needs a positive target error");
+    }
+    if (!(options_.theta > 0.0 && options_.theta <= 1.0)) {
+        throw std::invalid_argument("Dorfler marking parameter must lie in (0, 1]");
+    }
+
+    Result result;
+    result.mesh = initialMesh;
+    MeshRefiner::labelLongestEdges(result.mesh);
+
+    for (int iteration = 0; iteration < options_.maxIterations; ++iteration) {
+        auto start = std::chrono::steady_clock::now();
+        Step step;
+        step.nodes = result.mesh.nodeCount();
+        step.elements = result.mesh.elementCount();
+
+        std::map<std::string, BoundaryConditionData> adjointBcs = adjointConditions(result.mesh, boundaryConditions);
+        result.solution = solver_.solve(result.mesh, boundaryConditions);
+        result.adjoint = solver_.solveAdjoint(result.mesh, adjointBcs, weightLoad(result.mesh));
+        step.value = evaluate(result.mesh, result.solution, boundaryConditions);
+
+        // Local residuals weighted by the local adjoint indicators. The estimate sums
+        // eta_T omega_T, while Dorfler marking takes the squared products eta_T^2 omega_T^2.
+        std::vector<double> primal = estimator_.estimate(result.mesh, result.solution, boundaryConditions);
+        std::vector<double> weights = adjointEstimator_.estimate(result.mesh, result.adjoint, adjointBcs);
+        std::vector<double> indicators(primal.size());
+        step.estimate = 0.0;
+        for (std::size_t e = 0; e < primal.size(); ++e) {
+            indicators[e] = primal[e] * weights[e];
+            step.estimate += std::sqrt(indicators[e]);
+        }
+        step.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        result.value = step.value;
+        result.estimate = step.estimate;
+        if (step.estimate <= options_.targetError) {
+            result.history.push_back(step);
+            result.converged = true;
+            break;
+        }
+        // The mesh is only replaced when it is solved on again, so it always matches the solutions
+        if (iteration + 1 == options_.maxIterations) {
+            result.history.push_back(step);
+            break;
+        }
+
+        std::vector<MeshIndex> marked = ErrorEstimator::markDorfler(indicators, options_.theta);
+        Mesh refined = refiner_.refine(result.mesh, marked);
+        if (refined.nodeCount() > options_.maxNodes) {
+            result.history.push_back(step);
+            break;
+        }
+        step.markedElements = marked.size();
+        result.history.push_back(step);
+        result.mesh = std::move(refined);
+    }
+    return result;
+}
+
+std::string GoalOrientedSolver::Result::describe() const {
+    std::ostringstream out;
+    out << "Goal-oriented solve: quantity " << value << " +- " << estimate << ", " << history.size() << " steps, "
+        << (converged ? "target reached" : "target not reached") << "\n";
+    for (std::size_t i = 0; i < history.size(); ++i) {
+        const Step& step = history[i];
+        out << "  " << i << ": " << step.nodes << " nodes, " << step.elements << " elements, quantity "
+            << step.value << ", estimate " << step.estimate << ", marked " << step.markedElements
+            << " (" << step.milliseconds << " ms)\n";
+    }
+    return out.str();
+}
@@ -0,0 +1,132 @@
+#include "MappedFile.h"
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include "StringUtils.h"
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+    open(path);
+}
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        close();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(opened_, other.opened_);
+#ifdef _WIN32
+        std::swap(fileHandle_, other.fileHandle_);
+        std::swap(mappingHandle_, other.mappingHandle_);
+#endif
+    }
+    return *this;
+}
+
+#ifdef _WIN32
+
+void MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileW(utf8_to_wstring(path).c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Could not open file for mapping: " + path);
+    }
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+        CloseHandle(file);
+        throw std::runtime_error("Could not query file size: " + path);
+    }
+
+    fileHandle_ = file;
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    opened_ = true;
+
+    // Empty files cannot be mapped; report them as open with no data
+    if (size_ == 0) return;
+
+    HANDLE mapping = CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (mapping == NULL) {
+        close();
+        throw std::runtime_error("Could not create file mapping: " + path);
+    }
+    mappingHandle_ = mapping;
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == NULL) {
+        close();
+        throw std::runtime_error("Could not map view of file: " + path);
+    }
+    data_ = static_cast<const char*>(view);
+}
+
+void MappedFile::close() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mappingHandle_) CloseHandle(static_cast<HANDLE>(mappingHandle_));
+    if (fileHandle_) CloseHandle(static_cast<HANDLE>(fileHandle_));
+    data_ = nullptr;
+    mappingHandle_ = nullptr;
+    fileHandle_ = nullptr;
+    size_ = 0;
+    opened_ = false;
+}
+
+#else
+
+void MappedFile::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open file for mapping: " + path);
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("Could not query file size: " + path);
+    }
+
+    size_ = static_cast<std::size_t>(st.st_size);
+    opened_ = true;
+
+    if (size_ > 0) {
+        void* view = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        if (view == MAP_FAILED) {
+            ::close(fd);
+            size_ = 0;
+            opened_ = false;
+            throw std::runtime_error("Could not map file: " + path);
+        }
+        data_ = static_cast<const char*>(view);
+    }
+
+    // The mapping stays valid after the descriptor is closed
+    ::close(fd);
+}
+
+void MappedFile::close() {
+    if (data_) munmap(const_cast<char*>(data_), size_);
+    data_ = nullptr;
+    size_ = 0;
+    opened_ = false;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "MeshAdjacency.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+std::shared_ptr<const MeshAdjacency> Mesh::adjacency() const {
+    // Concurrent first calls may both build; either result is equivalent
+    std::shared_ptr<const MeshAdjacency> cached = std::atomic_load(&adjacencyCache);
+    if (!cached || !cached->matches(*this)) {
+        cached = std::make_shared<const MeshAdjacency>(*this);
+        std::atomic_store(&adjacencyCache, cached);
+    }
+    return cached;
+}
+
+MeshAdjacency::MeshAdjacency(const Mesh& mesh)
+    : meshId_(mesh.id), nodeCount_(mesh.nodeCount()), elementCount_(mesh.elementCount()) {
+    auto start = std::chrono::steady_clock::now();
+    buildNodeElements(mesh);
+    buildNodeNeighbors(mesh);
+    buildMilliseconds_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+MeshAdjacency::MeshAdjacency(const Mesh& mesh, std::vector<std::size_t> nodeElementOffsets, std::vector<MeshIndex> nodeElements,
+                             std::vector<std::size_t> nodeNeighborOffsets, std::vector<MeshIndex> nodeNeighbors)
+    : meshId_(mesh.id), nodeCount_(mesh.nodeCount()), elementCount_(mesh.elementCount()),
+      nodeElementOffsets_(std::move(nodeElementOffsets)), nodeElements_(std::move(nodeElements)),
+      nodeNeighborOffsets_(std::move(nodeNeighborOffsets)), nodeNeighbors_(std::move(nodeNeighbors)) {
+    if (nodeElementOffsets_.size() != nodeCount_ + 1 || nodeNeighborOffsets_.size() != nodeCount_ + 1) {
+        throw std::invalid_argument("Adjacency arrays do not match the mesh");
+    }
+}
+
+bool MeshAdjacency::matches(const Mesh& mesh) const {
+    return meshId_ == mesh.id && nodeCount_ == mesh.nodeCount() && elementCount_ == mesh.elementCount();
+}
+
+void MeshAdjacency::buildNodeElements(const Mesh& mesh) {
+    const std::size_t n = nodeCount_;
+    const std::size_t nElements = elementCount_;
+    const MeshIndex* connectivity = mesh.connectivity.data();
+
+    // Count the elements of every node
+    std::vector<std::atomic<std::size_t>> cursor(n);
+    parallelFor(n, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) cursor[i].store(0, std::memory_order_relaxed);
+    });
+    parallelFor(nElements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t k = 3 * begin; k < 3 * end; ++k) {
+            cursor[connectivity[k]].fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+
+    // Row offsets (a sequential scan costs about as much as one more pass over the nodes)
+    nodeElementOffsets_.assign(n + 1, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t count = cursor[i].load(std::memory_order_relaxed);
+        cursor[i].store(nodeElementOffsets_[i], std::memory_order_relaxed);
+        nodeElementOffsets_[i + 1] = nodeElementOffsets_[i] + count;
+    }
+
+    // Scatter the elements, then sort every row so the result does not depend on thread timing
+    nodeElements_.resize(nodeElementOffsets_[n]);
+    parallelFor(nElements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t e = begin; e < end; ++e) {
+            for (int a = 0; a < 3; ++a) {
+                std::size_t slot = cursor[connectivity[3 * e + a]].fetch_add(1, std::memory_order_relaxed);
+                nodeElements_[slot] = static_cast<MeshIndex>(e);
+            }
+        }
+    });
+    parallelFor(n, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            std::sort(nodeElements_.begin() + nodeElementOffsets_[i], nodeElements_.begin() + nodeElementOffsets_[i + 1]);
+        }
+    });
+}
+
+void MeshAdjacency::buildNodeNeighbors(const Mesh& mesh) {
+    const std::size_t n = nodeCount_;
+    const MeshIndex* connectivity = mesh.connectivity.data();
+
+    // Every chunk of nodes collects its rows into its own buffer; the buffers are then copied
+    // into place once the row offsets are known
+    const std::size_t chunks = parallelChunkCount(n);
+    std::vector<std::vector<MeshIndex>> chunkNeighbors(chunks);
+    nodeNeighborOffsets_.assign(n + 1, 0);
+
+    parallelChunks(n, chunks, [&](std::size_t chunk, std::size_t begin, std::size_t end) {
+        std::vector<MeshIndex>& out = chunkNeighbors[chunk];
+        for (std::size_t i = begin; i < end; ++i) {
+            std::size_t rowBegin = out.size();
+            for (MeshIndex e : elementsOf(static_cast<MeshIndex>(i))) {
+                for (int a = 0; a < 3; ++a) {
+                    MeshIndex node = connectivity[3 * static_cast<std::size_t>(e) + a];
+                    if (static_cast<std::size_t>(node) != i) out.push_back(node);
+                }
+            }
+            std::sort(out.begin() + rowBegin, out.end());
+            out.erase(std::unique(out.begin() + rowBegin, out.end()), out.end());
+            nodeNeighborOffsets_[i + 1] = out.size() - rowBegin;
+        }
+    });
+
+    for (std::size_t i = 0; i < n; ++i) {
+        nodeNeighborOffsets_[i + 1] += nodeNeighborOffsets_[i];
+    }
+
+    nodeNeighbors_.resize(nodeNeighborOffsets_[n]);
+    parallelChunks(n, chunks, [&](std::size_t chunk, std::size_t begin, std::size_t) {
+        std::vector<MeshIndex>& rows = chunkNeighbors[chunk];
+        std::copy(rows.begin(), rows.end(), nodeNeighbors_.begin() + nodeNeighborOffsets_[begin]);
+        std::vector<MeshIndex>().swap(rows);
+    });
+}
+
+std::vector<MeshIndex> MeshAdjacency::elementNeighbors(const Mesh& mesh) const {
+    const std::size_t nElements = elementCount_;
+    std::vector<MeshIndex> across(3 * nElements, -1);
+    parallelFor(nElements, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t e = begin; e < end; ++e) {
+            const MeshIndex* t = &mesh.connectivity[3 * e];
+            for (int k = 0; k < 3; ++k) {
+                // The one other element in both endpoint rows (sorted, so intersect by merging)
+                IndexSpan first = elementsOf(t[(k + 1) % 3]);
+                IndexSpan second = elementsOf(t[(k + 2) % 3]);
+                const MeshIndex* i = first.begin();
+                const MeshIndex* j = second.begin();
+                while (i != first.end() && j != second.end()) {
+                    if (*i < *j) {
+                        ++i;
+                    } else if (*j < *i) {
+                        ++j;
+                    } else {
+                        if (static_cast<std::size_t>(*i) != e) {
+                            across[3 * e + k] = *i;
+                            break;
+                        }
+                        ++i;
+                        ++j;
+                    }
+                }
+            }
+        }
+    });
+    return across;
+}
+
+std::size_t MeshAdjacency::nodeElementBytes() const {
+    return nodeElementOffsets_.capacity() * sizeof(std::size_t) + nodeElements_.capacity() * sizeof(MeshIndex);
+}
+
+std::size_t MeshAdjacency::nodeNeighborBytes() const {
+    return nodeNeighborOffsets_.capacity() * sizeof(std::size_t) + nodeNeighbors_.capacity() * sizeof(MeshIndex);
+}
+
+std::string MeshAdjacency::describe() const {
+    std::ostringstream out;
+    out << "Mesh adjacency: " << nodeCount_ << " nodes, " << elementCount_ << " elements\n"
+        << "  node-element: " << nodeElements_.size() << " entries, " << nodeElementBytes() / 1024.0 << " KiB\n"
+        << "  node-node:    " << nodeNeighbors_.size() << " entries, " << nodeNeighborBytes() / 1024.0 << " KiB\n"
+        << "  total " << memoryBytes() / 1024.0 << " KiB, built in " << buildMilliseconds_ << " ms\n";
+    return out.str();
+}
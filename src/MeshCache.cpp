@@ -0,0 +1,359 @@
+#include "MeshCache.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char kMagic[8] = { 'F', 'E', 'M', 'M', 'E', 'S', 'H', '\0' };
+constexpr std::uint32_t kByteOrderMark = 0x01020304u;
+constexpr std::size_t kAlignment = 64; // Section alignment, one cache line
+
+enum SectionType : std::uint32_t {
+    NodeX = 1,
+    NodeY,
+    Connectivity,
+    BoundaryTagArray,     // uint32 per node
+    BoundaryNameTable,    // Per bit: uint32 length and the name's bytes
+    BoundaryOffsets,      // uint64 per bit + 1
+    BoundaryNodes,
+    NodeElementOffsets,   // uint64 per node + 1
+    NodeElements,
+    NodeNeighborOffsets,  // uint64 per node + 1
+    NodeNeighbors,
+    ElementAreas,
+    ElementCentroidX,
+    ElementCentroidY
+};
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrderMark;
+    std::uint32_t indexBytes;
+    std::uint32_t sectionCount;
+    std::uint64_t nodeCount;
+    std::uint64_t elementCount;
+    std::uint64_t fileBytes;
+};
+
+struct SectionEntry {
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t bytes;
+};
+
+static_assert(sizeof(FileHeader) == 48 && sizeof(SectionEntry) == 24, "Mesh cache header layout");
+
+std::size_t alignUp(std::size_t offset) {
+    return (offset + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+// Section to be written: a view of mesh data or of a buffer owned by the writer
+struct PendingSection {
+    std::uint32_t type;
+    const void* data;
+    std::size_t bytes;
+};
+
+template <class T>
+std::vector<std::uint64_t> toUint64(const std::vector<T>& values) {
+    return std::vector<std::uint64_t>(values.begin(), values.end());
+}
+
+} // namespace
+
+int MappedMesh::boundaryTagBit(const std::string& name) const {
+    for (std::size_t bit = 0; bit < boundaryTagNames_.size(); ++bit) {
+        if (!boundaryTagNames_[bit].empty() && boundaryTagNames_[bit] == name) {
+            return static_cast<int>(bit);
+        }
+    }
+    return -1;
+}
+
+std::optional<MappedMesh::BoundaryRange> MappedMesh::findBoundary(const std::string& name) const {
+    int bit = boundaryTagBit(name);
+    if (bit < 0) return std::nullopt;
+    return IndexSpan(boundaryNodes_ + boundaryOffsets_[bit], boundaryNodes_ + boundaryOffsets_[bit + 1]);
+}
+
+std::vector<std::string> MappedMesh::boundaryNames() const {
+    std::vector<std::string> names;
+    for (const std::string& name : boundaryTagNames_) {
+        if (!name.empty()) names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+Mesh MappedMesh::toMesh() const {
+    Mesh mesh;
+    mesh.id = newMeshId();
+    mesh.x.assign(x_, x_ + nodeCount_);
+    mesh.y.assign(y_, y_ + nodeCount_);
+    mesh.connectivity.assign(connectivity_, connectivity_ + 3 * elementCount_);
+    if (tags_) {
+        mesh.boundaryTags.assign(tags_, tags_ + nodeCount_);
+        mesh.boundaryTagNames = boundaryTagNames_;
+        mesh.boundarySets.resize(boundaryTagNames_.size());
+        for (std::size_t bit = 0; bit < boundaryTagNames_.size(); ++bit) {
+            mesh.boundarySets[bit].assign(boundaryNodes_ + boundaryOffsets_[bit], boundaryNodes_ + boundaryOffsets_[bit + 1]);
+        }
+    }
+    if (hasAdjacency()) {
+        mesh.adjacencyCache = std::make_shared<const MeshAdjacency>(
+            mesh,
+            std::vector<std::size_t>(nodeElementOffsets_, nodeElementOffsets_ + nodeCount_ + 1),
+            std::vector<MeshIndex>(nodeElements_, nodeElements_ + nodeElementOffsets_[nodeCount_]),
+            std::vector<std::size_t>(nodeNeighborOffsets_, nodeNeighborOffsets_ + nodeCount_ + 1),
+            std::vector<MeshIndex>(nodeNeighbors_, nodeNeighbors_ + nodeNeighborOffsets_[nodeCount_]));
+    }
+    return mesh;
+}
+
+void MeshCache::write(const Mesh& mesh, const std::string& path, const WriteOptions& options) {
+    const std::size_t n = mesh.nodeCount();
+    const std::size_t nElements = mesh.elementCount();
+    if (mesh.y.size() != n || mesh.connectivity.size() != 3 * nElements) {
+        throw std::invalid_argument("Mesh cache: inconsistent mesh arrays");
+    }
+
+    std::vector<PendingSection> sections;
+    sections.push_back({ NodeX, mesh.x.data(), n * sizeof(double) });
+    sections.push_back({ NodeY, mesh.y.data(), n * sizeof(double) });
+    sections.push_back({ Connectivity, mesh.connectivity.data(), mesh.connectivity.size() * sizeof(MeshIndex) });
+
+    // Boundaries: tags padded to every node, names, and the sets concatenated in bit order
+    std::vector<std::uint32_t> tags;
+    std::vector<char> nameTable;
+    std::vector<std::uint64_t> boundaryOffsets;
+    std::vector<MeshIndex> boundaryNodes;
+    if (!mesh.boundaryTagNames.empty()) {
+        tags.assign(n, 0u);
+        std::copy(mesh.boundaryTags.begin(), mesh.boundaryTags.begin() + std::min(n, mesh.boundaryTags.size()), tags.begin());
+        boundaryOffsets.push_back(0);
+        for (std::size_t bit = 0; bit < mesh.boundaryTagNames.size(); ++bit) {
+            const std::string& name = mesh.boundaryTagNames[bit];
+            std::uint32_t length = static_cast<std::uint32_t>(name.size());
+            const char* lengthBytes = reinterpret_cast<const char*>(&length);
+            nameTable.insert(nameTable.end(), lengthBytes, lengthBytes + sizeof(length));
+            nameTable.insert(nameTable.end(), name.begin(), name.end());
+            if (bit < mesh.boundarySets.size()) {
+                boundaryNodes.insert(boundaryNodes.end(), mesh.boundarySets[bit].begin(), mesh.boundarySets[bit].end());
+            }
+            boundaryOffsets.push_back(boundaryNodes.size());
+        }
+        sections.push_back({ BoundaryTagArray, tags.data(), tags.size() * sizeof(std::uint32_t) });
+        sections.push_back({ BoundaryNameTable, nameTable.data(), nameTable.size() });
+        sections.push_back({ BoundaryOffsets, boundaryOffsets.data(), boundaryOffsets.size() * sizeof(std::uint64_t) });
+        sections.push_back({ BoundaryNodes, boundaryNodes.data(), boundaryNodes.size() * sizeof(MeshIndex) });
+    }
+
+    std::shared_ptr<const MeshAdjacency> adjacency;
+    std::vector<std::uint64_t> elementOffsets, neighborOffsets;
+    if (options.adjacency && nElements > 0) {
+        adjacency = mesh.adjacency();
+        elementOffsets = toUint64(adjacency->nodeElementOffsets());
+        neighborOffsets = toUint64(adjacency->nodeNeighborOffsets());
+        sections.push_back({ NodeElementOffsets, elementOffsets.data(), elementOffsets.size() * sizeof(std::uint64_t) });
+        sections.push_back({ NodeElements, adjacency->nodeElements().data(), adjacency->nodeElements().size() * sizeof(MeshIndex) });
+        sections.push_back({ NodeNeighborOffsets, neighborOffsets.data(), neighborOffsets.size() * sizeof(std::uint64_t) });
+        sections.push_back({ NodeNeighbors, adjacency->nodeNeighbors().data(), adjacency->nodeNeighbors().size() * sizeof(MeshIndex) });
+    }
+
+    std::vector<double> areas, centroidX, centroidY;
+    if (options.geometry) {
+        areas.resize(nElements);
+        centroidX.resize(nElements);
+        centroidY.resize(nElements);
+        for (std::size_t e = 0; e < nElements; ++e) {
+            const MeshIndex* t = &mesh.connectivity[3 * e];
+            double x1 = mesh.x[t[0]], y1 = mesh.y[t[0]];
+            double x2 = mesh.x[t[1]], y2 = mesh.y[t[1]];
+            double x3 = mesh.x[t[2]], y3 = mesh.y[t[2]];
+            areas[e] = 0.5 * std::abs((x2 - x1) * (y3 - y1) - (x3 - x1) * (y2 - y1));
+            centroidX[e] = (x1 + x2 + x3) / 3.0;
+            centroidY[e] = (y1 + y2 + y3) / 3.0;
+        }
+        sections.push_back({ ElementAreas, areas.data(), nElements * sizeof(double) });
+        sections.push_back({ ElementCentroidX, centroidX.data(), nElements * sizeof(double) });
+        sections.push_back({ ElementCentroidY, centroidY.data(), nElements * sizeof(double) });
+    }
+
+    // Layout: header, section table, then the aligned sections
+    std::vector<SectionEntry> table(sections.size());
+    std::size_t offset = alignUp(sizeof(FileHeader) + sections.size() * sizeof(SectionEntry));
+    for (std::size_t s = 0; s < sections.size(); ++s) {
+        table[s] = { sections[s].type, 0u, offset, sections[s].bytes };
+        offset = alignUp(offset + sections[s].bytes);
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrderMark = kByteOrderMark;
+    header.indexBytes = sizeof(MeshIndex);
+    header.sectionCount = static_cast<std::uint32_t>(sections.size());
+    header.nodeCount = n;
+    header.elementCount = nElements;
+    header.fileBytes = offset;
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Could not create mesh cache file: " + temporary);
+        }
+        static const char padding[kAlignment] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(SectionEntry));
+        std::size_t written = sizeof(header) + table.size() * sizeof(SectionEntry);
+        for (std::size_t s = 0; s < sections.size(); ++s) {
+            out.write(padding, table[s].offset - written);
+            out.write(static_cast<const char*>(sections[s].data), sections[s].bytes);
+            written = table[s].offset + sections[s].bytes;
+        }
+        out.write(padding, offset - written);
+        if (!out) {
+            out.close();
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Could not write mesh cache file: " + temporary);
+        }
+    }
+
+    // Replace atomically where the platform allows it; otherwise remove the old file first
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(path.c_str());
+        if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+            std::remove(temporary.c_str());
+            throw std::runtime_error("Could not move mesh cache file into place: " + path);
+        }
+    }
+}
+
+MappedMesh MeshCache::open(const std::string& path) {
+    auto file = std::make_shared<MappedFile>(path);
+    const char* data = file->data();
+    const std::size_t size = file->size();
+
+    FileHeader header;
+    if (size < sizeof(header)) {
+        throw std::runtime_error("Not a mesh cache file: " + path);
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        throw std::runtime_error("Not a mesh cache file: " + path);
+    }
+    if (header.version != kVersion) {
+        throw std::runtime_error("Mesh cache file " + path + " has format version " + std::to_string(header.version) +
+                                 ", expected " + std::to_string(kVersion));
+    }
+    if (header.byteOrderMark != kByteOrderMark) {
+        throw std::runtime_error("Mesh cache file was written with another byte order: " + path);
+    }
+    if (header.indexBytes != sizeof(MeshIndex)) {
+        throw std::runtime_error("Mesh cache file uses " + std::to_string(8 * header.indexBytes) +
+                                 "-bit indices, this build uses " + std::to_string(8 * sizeof(MeshIndex)) + ": " + path);
+    }
+    if (header.fileBytes != size ||
+        header.sectionCount > (size - sizeof(header)) / sizeof(SectionEntry) ||
+        !fitsMeshIndex(header.nodeCount) || !fitsMeshIndex(header.elementCount)) {
+        throw std::runtime_error("Damaged mesh cache file: " + path);
+    }
+
+    std::vector<SectionEntry> table(header.sectionCount);
+    std::memcpy(table.data(), data + sizeof(header), table.size() * sizeof(SectionEntry));
+    for (const SectionEntry& entry : table) {
+        if (entry.offset % kAlignment != 0 || entry.offset > size || entry.bytes > size - entry.offset) {
+            throw std::runtime_error("Damaged mesh cache file: " + path);
+        }
+    }
+
+    // Section of the given type, checked against its expected size (elementBytes per entry,
+    // `count` entries unless count is zero); null if the file does not have it
+    auto section = [&](std::uint32_t type, std::size_t elementBytes, std::size_t count) -> const char* {
+        for (const SectionEntry& entry : table) {
+            if (entry.type != type) continue;
+            if ((count != 0 && entry.bytes != count * elementBytes) || entry.bytes % elementBytes != 0) {
+                throw std::runtime_error("Damaged mesh cache file: " + path);
+            }
+            return data + entry.offset;
+        }
+        return nullptr;
+    };
+    auto sectionBytes = [&](std::uint32_t type) -> std::size_t {
+        for (const SectionEntry& entry : table) {
+            if (entry.type == type) return static_cast<std::size_t>(entry.bytes);
+        }
+        return 0;
+    };
+    auto required = [&](const char* pointer) {
+        if (!pointer) throw std::runtime_error("Incomplete mesh cache file: " + path);
+        return pointer;
+    };
+
+    MappedMesh mesh;
+    mesh.id = newMeshId();
+    mesh.nodeCount_ = static_cast<std::size_t>(header.nodeCount);
+    mesh.elementCount_ = static_cast<std::size_t>(header.elementCount);
+    const std::size_t n = mesh.nodeCount_;
+    const std::size_t nElements = mesh.elementCount_;
+
+    // Empty sections are checked but not required
+    auto array = [&](std::uint32_t type, std::size_t elementBytes, std::size_t count) {
+        return count == 0 ? section(type, elementBytes, 0) : required(section(type, elementBytes, count));
+    };
+    mesh.x_ = reinterpret_cast<const double*>(array(NodeX, sizeof(double), n));
+    mesh.y_ = reinterpret_cast<const double*>(array(NodeY, sizeof(double), n));
+    mesh.connectivity_ = reinterpret_cast<const MeshIndex*>(array(Connectivity, sizeof(MeshIndex), 3 * nElements));
+
+    if (const char* names = section(BoundaryNameTable, 1, 0)) {
+        const char* end = names + sectionBytes(BoundaryNameTable);
+        while (names != end) {
+            std::uint32_t length;
+            if (static_cast<std::size_t>(end - names) < sizeof(length)) throw std::runtime_error("Damaged mesh cache file: " + path);
+            std::memcpy(&length, names, sizeof(length));
+            names += sizeof(length);
+            if (length > static_cast<std::size_t>(end - names)) throw std::runtime_error("Damaged mesh cache file: " + path);
+            mesh.boundaryTagNames_.emplace_back(names, length);
+            names += length;
+        }
+        const std::size_t bits = mesh.boundaryTagNames_.size();
+        if (bits > static_cast<std::size_t>(BoundaryTags::MaxTags)) throw std::runtime_error("Damaged mesh cache file: " + path);
+        if (n > 0) mesh.tags_ = reinterpret_cast<const std::uint32_t*>(required(section(BoundaryTagArray, sizeof(std::uint32_t), n)));
+        mesh.boundaryOffsets_ = reinterpret_cast<const std::uint64_t*>(required(section(BoundaryOffsets, sizeof(std::uint64_t), bits + 1)));
+        mesh.boundaryNodes_ = reinterpret_cast<const MeshIndex*>(section(BoundaryNodes, sizeof(MeshIndex), 0));
+        if (mesh.boundaryOffsets_[bits] != sectionBytes(BoundaryNodes) / sizeof(MeshIndex)) {
+            throw std::runtime_error("Damaged mesh cache file: " + path);
+        }
+    }
+
+    if (section(NodeElementOffsets, sizeof(std::uint64_t), 0)) {
+        mesh.nodeElementOffsets_ = reinterpret_cast<const std::uint64_t*>(required(section(NodeElementOffsets, sizeof(std::uint64_t), n + 1)));
+        mesh.nodeElements_ = reinterpret_cast<const MeshIndex*>(section(NodeElements, sizeof(MeshIndex), 0));
+        mesh.nodeNeighborOffsets_ = reinterpret_cast<const std::uint64_t*>(required(section(NodeNeighborOffsets, sizeof(std::uint64_t), n + 1)));
+        mesh.nodeNeighbors_ = reinterpret_cast<const MeshIndex*>(section(NodeNeighbors, sizeof(MeshIndex), 0));
+        if (mesh.nodeElementOffsets_[n] != sectionBytes(NodeElements) / sizeof(MeshIndex) ||
+            mesh.nodeNeighborOffsets_[n] != sectionBytes(NodeNeighbors) / sizeof(MeshIndex)) {
+            throw std::runtime_error("Damaged mesh cache file: " + path);
+        }
+    }
+
+    if (section(ElementAreas, sizeof(double), 0)) {
+        mesh.areas_ = reinterpret_cast<const double*>(required(section(ElementAreas, sizeof(double), nElements)));
+        mesh.centroidX_ = reinterpret_cast<const double*>(required(section(ElementCentroidX, sizeof(double), nElements)));
+        mesh.centroidY_ = reinterpret_cast<const double*>(required(section(ElementCentroidY, sizeof(double), nElements)));
+    }
+
+    mesh.file_ = std::move(file);
+    return mesh;
+}
+
+bool MeshCache::isCacheFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(kMagic)];
+    return in.read(magic, sizeof(magic)) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
@@ -1,4 +1,6 @@
 #include "MeshGenerator.h"
+#include "ParallelFor.h"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
@@ -7,72 +9,71 @@ MeshGenerator::MeshGenerator(double Lx, double Ly, int Nx, int Ny)
     if (Lx <= 0 || Ly <= 0 || Nx < 2 || Ny < 2) {
         throw std::invalid_argument("Invalid mesh parameters: Lx, Ly must be positive, Nx, Ny must be >= 2");
     }
+    // Node and element counts are computed in size_t, then every index fits MeshIndex
+    if (!fitsMeshIndex(static_cast<std::size_t>(Nx) * Ny) ||
+        !fitsMeshIndex(2 * static_cast<std::size_t>(Nx - 1) * (Ny - 1))) {
+        throw std::invalid_argument("Mesh too large for 32-bit indices: build with FEMSOLVER_INDEX64");
+    }
 }
 
 Mesh MeshGenerator::generate() {
     Mesh mesh;
-    
-    // Create nodes
-    mesh.nodes.reserve(Nx_ * Ny_);
-    
-    double dx = Lx_ / (Nx_ - 1);
-    double dy = Ly_ / (Ny_ - 1);
-    
-    for (int i = 0; i < Ny_; ++i) {
-        for (int j = 0; j < Nx_; ++j) {
-            double x = j * dx;
-            double y = i * dy;
-            mesh.nodes.emplace_back(x, y);
+    mesh.id = newMeshId();
+
+    const std::size_t nx = Nx_, ny = Ny_;
+    const std::size_t cellsPerRow = nx - 1;
+    const std::vector<double> xs = xSpacing_.coordinates(Lx_, Nx_);
+    const std::vector<double> ys = ySpacing_.coordinates(Ly_, Ny_);
+
+    // Pre-sized arrays (not zero-filled, see AlignedAllocator) are first touched by the thread
+    // that fills each block of rows. A block writes its node rows and the element rows above them,
+    // so the elements sit on the same memory node as most of their nodes.
+    mesh.x.resize(nx * ny);
+    mesh.y.resize(nx * ny);
+    mesh.connectivity.resize(6 * cellsPerRow * (ny - 1));
+
+    const std::size_t minRows = std::max<std::size_t>(1, 65536 / nx);
+    parallelChunks(ny, parallelChunkCount(ny, minRows), [&](std::size_t, std::size_t rowBegin, std::size_t rowEnd) {
+        for (std::size_t i = rowBegin; i < rowEnd; ++i) {
+            double* x = mesh.x.data() + i * nx;
+            double* y = mesh.y.data() + i * nx;
+            for (std::size_t j = 0; j < nx; ++j) {
+                x[j] = xs[j];
+                y[j] = ys[i];
+            }
         }
-    }
-    
-    // Create elements (triangles)
-    mesh.elements.reserve(2 * (Nx_ - 1) * (Ny_ - 1));
-    
-    for (int i = 0; i < Ny_ - 1; ++i) {
-        for (int j = 0; j < Nx_ - 1; ++j) {
-            int n1 = i * Nx_ + j;
-            int n2 = i * Nx_ + (j + 1);
-            int n3 = (i + 1) * Nx_ + j;
-            int n4 = (i + 1) * Nx_ + (j + 1);
-            
-            // First triangle
-            Element elem1 = {n1, n2, n3};
-            mesh.elements.push_back(elem1);
-            
-            // Second triangle
-            Element elem2 = {n2, n4, n3};
-            mesh.elements.push_back(elem2);
+
+        // Two triangles per cell: (n1, n2, n3) and (n2, n4, n3)
+        for (std::size_t i = rowBegin; i < std::min(rowEnd, ny - 1); ++i) {
+            MeshIndex* element = mesh.connectivity.data() + 6 * cellsPerRow * i;
+            const MeshIndex rowStart = static_cast<MeshIndex>(i * nx);
+            for (std::size_t j = 0; j < cellsPerRow; ++j) {
+                MeshIndex n1 = rowStart + static_cast<MeshIndex>(j);
+                MeshIndex n2 = n1 + 1;
+                MeshIndex n3 = n1 + static_cast<MeshIndex>(nx);
+                MeshIndex n4 = n3 + 1;
+                element[0] = n1; element[1] = n2; element[2] = n3;
+                element[3] = n2; element[4] = n4; element[5] = n3;
+                element += 6;
+            }
         }
+    });
+
+    // Boundaries follow from the numbering: node (row i, column j) is i * Nx + j
+    std::vector<MeshIndex> west(ny), east(ny), south(nx), north(nx);
+    for (std::size_t i = 0; i < ny; ++i) {
+        west[i] = static_cast<MeshIndex>(i * nx);
+        east[i] = static_cast<MeshIndex>(i * nx + nx - 1);
     }
-    
-    // Define boundaries
-    std::vector<int> west, east, south, north;
-    
-    // West boundary (x = 0)
-    for (int i = 0; i < Ny_; ++i) {
-        west.push_back(i * Nx_);
-    }
-    
-    // East boundary (x = Lx)
-    for (int i = 0; i < Ny_; ++i) {
-        east.push_back(i * Nx_ + Nx_ - 1);
-    }
-    
-    // South boundary (y = 0)
-    for (int j = 0; j < Nx_; ++j) {
-        south.push_back(j);
-    }
-    
-    // North boundary (y = Ly)
-    for (int j = 0; j < Nx_; ++j) {
-        north.push_back((Ny_ - 1) * Nx_ + j);
+    for (std::size_t j = 0; j < nx; ++j) {
+        south[j] = static_cast<MeshIndex>(j);
+        north[j] = static_cast<MeshIndex>((ny - 1) * nx + j);
     }
-    
-    mesh.boundaries["west"] = west;
-    mesh.boundaries["east"] = east;
-    mesh.boundaries["south"] = south;
-    mesh.boundaries["north"] = north;
-    
+
+    mesh.addBoundary("west", west);
+    mesh.addBoundary("east", east);
+    mesh.addBoundary("south", south);
+    mesh.addBoundary("north", north);
+
     return mesh;
-}
\ No newline at end of file
+}
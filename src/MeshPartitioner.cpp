@@ -0,0 +1,520 @@
+#include "MeshPartitioner.h"
+#include "MeshAdjacency.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Weighted undirected graph in compressed rows
+struct Graph {
+    std::vector<std::size_t> offsets;
+    std::vector<MeshIndex> neighbors;
+    std::vector<MeshIndex> edgeWeights;
+    std::vector<MeshIndex> vertexWeights;
+
+    std::size_t size() const { return vertexWeights.size(); }
+    std::int64_t totalWeight() const {
+        return std::accumulate(vertexWeights.begin(), vertexWeights.end(), std::int64_t(0));
+    }
+};
+
+// Graphs at most this large are bisected directly
+constexpr std::size_t kCoarsestSize = 120;
+// Halves at least this large are partitioned on their own thread
+constexpr std::size_t kParallelSize = 20000;
+// Refinement passes per level, and moves without improvement before a pass gives up
+constexpr int kRefinementPasses = 8;
+constexpr int kMaxFruitlessMoves = 100;
+// Graph growing attempts for the initial bisection
+constexpr int kInitialTrials = 6;
+
+// Element dual graph: two elements are adjacent when they share an edge
+Graph dualGraph(const Mesh& mesh) {
+    const std::size_t nElements = mesh.elementCount();
+    const std::vector<MeshIndex> across = mesh.adjacency()->elementNeighbors(mesh);
+
+    Graph graph;
+    graph.offsets.assign(nElements + 1, 0);
+    for (std::size_t e = 0; e < nElements; ++e) {
+        std::size_t count = 0;
+        for (int k = 0; k < 3; ++k) count += across[3 * e + k] >= 0 ? 1 : 0;
+        graph.offsets[e + 1] = graph.offsets[e] + count;
+    }
+    graph.neighbors.reserve(graph.offsets[nElements]);
+    for (MeshIndex neighbor : across) {
+        if (neighbor >= 0) graph.neighbors.push_back(neighbor);
+    }
+    graph.edgeWeights.assign(graph.neighbors.size(), 1);
+    graph.vertexWeights.assign(nElements, 1);
+    return graph;
+}
+
+// Heavy edge matching: every vertex is merged with its unmatched neighbour of heaviest edge,
+// unless the pair would exceed maxVertexWeight. coarseOf maps the vertices to the coarse graph.
+Graph coarsen(const Graph& g, std::vector<MeshIndex>& coarseOf, MeshIndex maxVertexWeight, std::mt19937& rng) {
+    const std::size_t n = g.size();
+    std::vector<MeshIndex> match(n, -1);
+    std::vector<MeshIndex> order(n);
+    std::iota(order.begin(), order.end(), MeshIndex(0));
+    std::shuffle(order.begin(), order.end(), rng);
+
+    for (MeshIndex v : order) {
+        if (match[v] >= 0) continue;
+        MeshIndex best = v, bestWeight = -1;
+        for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+            MeshIndex u = g.neighbors[k];
+            if (match[u] < 0 && u != v && g.edgeWeights[k] > bestWeight &&
+                g.vertexWeights[v] + g.vertexWeights[u] <= maxVertexWeight) {
+                best = u;
+                bestWeight = g.edgeWeights[k];
+            }
+        }
+        match[v] = best;
+        match[best] = v;
+    }
+
+    // Coarse vertices are numbered in the order of their lower fine vertex
+    coarseOf.assign(n, -1);
+    MeshIndex coarseCount = 0;
+    for (std::size_t v = 0; v < n; ++v) {
+        if (coarseOf[v] < 0) coarseOf[v] = coarseOf[match[v]] = coarseCount++;
+    }
+
+    Graph coarse;
+    coarse.vertexWeights.assign(coarseCount, 0);
+    coarse.offsets.reserve(coarseCount + 1);
+    coarse.offsets.push_back(0);
+    coarse.neighbors.reserve(g.neighbors.size());
+    coarse.edgeWeights.reserve(g.neighbors.size());
+    std::vector<std::size_t> slot(coarseCount, std::numeric_limits<std::size_t>::max());
+    for (std::size_t v = 0; v < n; ++v) {
+        if (static_cast<std::size_t>(match[v]) < v) continue; // Handled with its partner
+        const MeshIndex c = coarseOf[v];
+        const std::size_t rowBegin = coarse.neighbors.size();
+        const MeshIndex members[2] = { static_cast<MeshIndex>(v), match[v] };
+        for (int m = 0; m < (members[1] == members[0] ? 1 : 2); ++m) {
+            const MeshIndex member = members[m];
+            coarse.vertexWeights[c] += g.vertexWeights[member];
+            for (std::size_t k = g.offsets[member]; k < g.offsets[member + 1]; ++k) {
+                MeshIndex cu = coarseOf[g.neighbors[k]];
+                if (cu == c) continue;
+                if (slot[cu] == std::numeric_limits<std::size_t>::max()) {
+                    slot[cu] = coarse.neighbors.size();
+                    coarse.neighbors.push_back(cu);
+                    coarse.edgeWeights.push_back(g.edgeWeights[k]);
+                } else {
+                    coarse.edgeWeights[slot[cu]] += g.edgeWeights[k];
+                }
+            }
+        }
+        for (std::size_t k = rowBegin; k < coarse.neighbors.size(); ++k) {
+            slot[coarse.neighbors[k]] = std::numeric_limits<std::size_t>::max();
+        }
+        coarse.offsets.push_back(coarse.neighbors.size());
+    }
+    return coarse;
+}
+
+std::int64_t cutOf(const Graph& g, const std::vector<char>& side) {
+    std::int64_t cut = 0;
+    for (std::size_t v = 0; v < g.size(); ++v) {
+        for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+            if (side[g.neighbors[k]] != side[v]) cut += g.edgeWeights[k];
+        }
+    }
+    return cut / 2;
+}
+
+// Fiduccia-Mattheyses refinement of a bisection: move boundary vertices with the best gain
+// (reduction of the cut) while the sides stay within their allowed weights, accepting
+// temporary losses, then roll back to the best state of the pass
+void refine(const Graph& g, std::vector<char>& side, const std::int64_t target[2], double tolerance) {
+    const std::size_t n = g.size();
+    if (n < 2) return;
+    const MeshIndex heaviest = *std::max_element(g.vertexWeights.begin(), g.vertexWeights.end());
+    const std::int64_t maxWeight[2] = {
+        static_cast<std::int64_t>(target[0] * (1.0 + tolerance)) + heaviest,
+        static_cast<std::int64_t>(target[1] * (1.0 + tolerance)) + heaviest
+    };
+
+    std::int64_t weight[2] = { 0, 0 };
+    std::vector<std::int64_t> gain(n, 0); // External minus internal edge weight
+    for (std::size_t v = 0; v < n; ++v) {
+        weight[static_cast<int>(side[v])] += g.vertexWeights[v];
+        for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+            gain[v] += side[g.neighbors[k]] != side[v] ? g.edgeWeights[k] : -g.edgeWeights[k];
+        }
+    }
+    std::int64_t cut = cutOf(g, side);
+
+    auto overweight = [&]() {
+        return std::max<std::int64_t>(0, weight[0] - maxWeight[0]) + std::max<std::int64_t>(0, weight[1] - maxWeight[1]);
+    };
+    auto move = [&](MeshIndex v) {
+        const int from = side[v], to = 1 - from;
+        side[v] = static_cast<char>(to);
+        weight[from] -= g.vertexWeights[v];
+        weight[to] += g.vertexWeights[v];
+        cut -= gain[v];
+        gain[v] = -gain[v];
+        for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+            MeshIndex u = g.neighbors[k];
+            gain[u] += side[u] == to ? -2 * g.edgeWeights[k] : 2 * g.edgeWeights[k];
+        }
+    };
+
+    using Entry = std::pair<std::int64_t, MeshIndex>;
+    std::vector<char> locked(n);
+    std::vector<MeshIndex> moves;
+    for (int pass = 0; pass < kRefinementPasses; ++pass) {
+        std::priority_queue<Entry> heap[2];
+        for (std::size_t v = 0; v < n; ++v) {
+            for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+                if (side[g.neighbors[k]] != side[v]) {
+                    heap[static_cast<int>(side[v])].emplace(gain[v], static_cast<MeshIndex>(v));
+                    break;
+                }
+            }
+        }
+        std::fill(locked.begin(), locked.end(), 0);
+        moves.clear();
+
+        std::int64_t bestOverweight = overweight(), bestCut = cut;
+        std::size_t bestMoves = 0;
+        int fruitless = 0;
+        // Top of a heap after dropping stale entries, -1 if empty
+        auto top = [&](int s) -> MeshIndex {
+            while (!heap[s].empty()) {
+                Entry entry = heap[s].top();
+                MeshIndex v = entry.second;
+                if (!locked[v] && side[v] == s && entry.first == gain[v]) return v;
+                heap[s].pop();
+            }
+            return -1;
+        };
+
+        while (fruitless < kMaxFruitlessMoves) {
+            int from;
+            if (weight[0] > maxWeight[0]) {
+                from = 0;
+            } else if (weight[1] > maxWeight[1]) {
+                from = 1;
+            } else {
+                MeshIndex a = top(0), b = top(1);
+                if (a < 0 && b < 0) break;
+                from = b < 0 || (a >= 0 && gain[a] >= gain[b]) ? 0 : 1;
+            }
+            MeshIndex v = top(from);
+            if (v < 0) break;
+            heap[from].pop();
+            locked[v] = 1;
+            const int to = 1 - from;
+            if (weight[to] + g.vertexWeights[v] > maxWeight[to] && weight[from] <= maxWeight[from]) {
+                continue; // Would unbalance the bisection
+            }
+
+            move(v);
+            moves.push_back(v);
+            for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+                MeshIndex u = g.neighbors[k];
+                if (!locked[u]) heap[static_cast<int>(side[u])].emplace(gain[u], u);
+            }
+
+            std::int64_t over = overweight();
+            if (over < bestOverweight || (over == bestOverweight && cut < bestCut)) {
+                bestOverweight = over;
+                bestCut = cut;
+                bestMoves = moves.size();
+                fruitless = 0;
+            } else {
+                ++fruitless;
+            }
+        }
+
+        while (moves.size() > bestMoves) {
+            move(moves.back());
+            moves.pop_back();
+        }
+        if (bestMoves == 0) break;
+    }
+}
+
+// Initial bisection of a small graph: grow side 0 breadth-first from a random vertex until it
+// reaches its target weight, refine, and keep the best of several attempts
+std::vector<char> growBisection(const Graph& g, const std::int64_t target[2], double tolerance, std::mt19937& rng) {
+    const std::size_t n = g.size();
+    std::vector<char> best, side(n), queued(n);
+    std::int64_t bestCut = std::numeric_limits<std::int64_t>::max();
+    std::vector<MeshIndex> queue;
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+
+    for (int trial = 0; trial < kInitialTrials; ++trial) {
+        std::fill(side.begin(), side.end(), 1);
+        std::fill(queued.begin(), queued.end(), 0);
+        queue.clear();
+        std::size_t head = 0;
+        std::int64_t grown = 0;
+        while (grown < target[0]) {
+            if (head == queue.size()) {
+                // Start (or continue, for disconnected graphs) from an unreached vertex
+                std::size_t start = pick(rng), k = 0;
+                while (k < n && queued[(start + k) % n]) ++k;
+                if (k == n) break;
+                MeshIndex seed = static_cast<MeshIndex>((start + k) % n);
+                queued[seed] = 1;
+                queue.push_back(seed);
+            }
+            MeshIndex v = queue[head++];
+            side[v] = 0;
+            grown += g.vertexWeights[v];
+            for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+                MeshIndex u = g.neighbors[k];
+                if (!queued[u]) {
+                    queued[u] = 1;
+                    queue.push_back(u);
+                }
+            }
+        }
+        refine(g, side, target, tolerance);
+        std::int64_t cut = cutOf(g, side);
+        if (cut < bestCut) {
+            bestCut = cut;
+            best = side;
+        }
+    }
+    return best;
+}
+
+// Multilevel bisection with a `fraction` of the vertex weight on side 0
+std::vector<char> bisect(const Graph& g, double fraction, double tolerance, std::mt19937& rng) {
+    const std::int64_t total = g.totalWeight();
+    const std::int64_t target[2] = { std::llround(total * fraction), total - std::llround(total * fraction) };
+    const MeshIndex maxVertexWeight = static_cast<MeshIndex>(
+        std::max<std::int64_t>(1, static_cast<std::int64_t>(1.5 * total / kCoarsestSize)));
+
+    std::vector<Graph> levels;
+    std::vector<std::vector<MeshIndex>> maps;
+    while ((levels.empty() ? g : levels.back()).size() > kCoarsestSize) {
+        const Graph& current = levels.empty() ? g : levels.back();
+        std::vector<MeshIndex> map;
+        Graph coarse = coarsen(current, map, maxVertexWeight, rng);
+        if (coarse.size() > 0.95 * current.size()) break; // Matching has stalled
+        maps.push_back(std::move(map));
+        levels.push_back(std::move(coarse));
+    }
+
+    std::vector<char> side = growBisection(levels.empty() ? g : levels.back(), target, tolerance, rng);
+    for (std::size_t level = levels.size(); level-- > 0;) {
+        const Graph& fine = level == 0 ? g : levels[level - 1];
+        std::vector<char> fineSide(fine.size());
+        for (std::size_t v = 0; v < fine.size(); ++v) fineSide[v] = side[maps[level][v]];
+        side.swap(fineSide);
+        refine(fine, side, target, tolerance);
+    }
+    return side;
+}
+
+// Subgraphs induced by the two sides of a bisection; ids maps vertices to elements
+void split(const Graph& g, const std::vector<char>& side, const std::vector<MeshIndex>& ids,
+           Graph halves[2], std::vector<MeshIndex> halfIds[2]) {
+    const std::size_t n = g.size();
+    std::vector<MeshIndex> local(n);
+    for (std::size_t v = 0; v < n; ++v) {
+        std::vector<MeshIndex>& members = halfIds[static_cast<int>(side[v])];
+        local[v] = static_cast<MeshIndex>(members.size());
+        members.push_back(ids[v]);
+    }
+    for (int h = 0; h < 2; ++h) {
+        halves[h].offsets.assign(1, 0);
+        halves[h].offsets.reserve(halfIds[h].size() + 1);
+        halves[h].vertexWeights.reserve(halfIds[h].size());
+    }
+    for (std::size_t v = 0; v < n; ++v) {
+        Graph& half = halves[static_cast<int>(side[v])];
+        for (std::size_t k = g.offsets[v]; k < g.offsets[v + 1]; ++k) {
+            MeshIndex u = g.neighbors[k];
+            if (side[u] == side[v]) {
+                half.neighbors.push_back(local[u]);
+                half.edgeWeights.push_back(g.edgeWeights[k]);
+            }
+        }
+        half.offsets.push_back(half.neighbors.size());
+        half.vertexWeights.push_back(g.vertexWeights[v]);
+    }
+}
+
+void recursiveBisection(const Graph& g, const std::vector<MeshIndex>& ids, int firstPart, int parts,
+                        double tolerance, std::uint64_t seed, std::vector<int>& elementPart) {
+    if (parts == 1 || g.size() <= static_cast<std::size_t>(parts)) {
+        // One part, or at most one element per part
+        for (std::size_t v = 0; v < ids.size(); ++v) {
+            elementPart[ids[v]] = firstPart + (parts == 1 ? 0 : static_cast<int>(v));
+        }
+        return;
+    }
+
+    const int leftParts = parts / 2;
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(seed));
+    std::vector<char> side = bisect(g, static_cast<double>(leftParts) / parts, tolerance, rng);
+
+    Graph halves[2];
+    std::vector<MeshIndex> halfIds[2];
+    split(g, side, ids, halves, halfIds);
+    auto recurse = [&](int h) {
+        recursiveBisection(halves[h], halfIds[h], h == 0 ? firstPart : firstPart + leftParts,
+                           h == 0 ? leftParts : parts - leftParts, tolerance, 2 * seed + 1 + h, elementPart);
+    };
+    if (g.size() >= 2 * kParallelSize) {
+        parallelChunks(2, 2, [&](std::size_t chunk, std::size_t, std::size_t) { recurse(static_cast<int>(chunk)); });
+    } else {
+        recurse(0);
+        recurse(1);
+    }
+}
+
+// Recursive coordinate bisection of elements [begin, end) by their centroids
+void coordinateBisection(const std::vector<double>& cx, const std::vector<double>& cy, MeshIndex* begin, MeshIndex* end,
+                         int firstPart, int parts, std::vector<int>& elementPart) {
+    const std::size_t count = static_cast<std::size_t>(end - begin);
+    if (parts == 1 || count == 0) {
+        for (MeshIndex* e = begin; e != end; ++e) elementPart[*e] = firstPart;
+        return;
+    }
+
+    double xMin = cx[*begin], xMax = xMin, yMin = cy[*begin], yMax = yMin;
+    for (MeshIndex* e = begin; e != end; ++e) {
+        xMin = std::min(xMin, cx[*e]); xMax = std::max(xMax, cx[*e]);
+        yMin = std::min(yMin, cy[*e]); yMax = std::max(yMax, cy[*e]);
+    }
+    const std::vector<double>& key = xMax - xMin >= yMax - yMin ? cx : cy;
+
+    const int leftParts = parts / 2;
+    MeshIndex* middle = begin + count * leftParts / parts;
+    std::nth_element(begin, middle, end, [&](MeshIndex a, MeshIndex b) {
+        return key[a] < key[b] || (key[a] == key[b] && a < b);
+    });
+
+    auto recurse = [&](int h) {
+        if (h == 0) coordinateBisection(cx, cy, begin, middle, firstPart, leftParts, elementPart);
+        else coordinateBisection(cx, cy, middle, end, firstPart + leftParts, parts - leftParts, elementPart);
+    };
+    if (count >= 2 * kParallelSize) {
+        parallelChunks(2, 2, [&](std::size_t chunk, std::size_t, std::size_t) { recurse(static_cast<int>(chunk)); });
+    } else {
+        recurse(0);
+        recurse(1);
+    }
+}
+
+} // namespace
+
+MeshPartitioner::MeshPartitioner(PartitionMethod method) : method_(method) {}
+
+const char* MeshPartitioner::toString(PartitionMethod method) {
+    switch (method) {
+    case PartitionMethod::CoordinateBisection: return "coordinate bisection";
+    default: return "multilevel bisection";
+    }
+}
+
+MeshPartition MeshPartitioner::partition(const Mesh& mesh, int parts) const {
+    auto start = std::chrono::steady_clock::now();
+    const std::size_t nElements = mesh.elementCount();
+    if (parts < 1 || static_cast<std::size_t>(parts) > nElements) {
+        throw std::invalid_argument("Partition needs between 1 and element count parts");
+    }
+
+    MeshPartition result;
+    result.method = method_;
+    result.elementPart.assign(nElements, 0);
+    const Graph dual = dualGraph(mesh);
+
+    if (method_ == PartitionMethod::Multilevel) {
+        // Imbalance compounds over the levels of bisection, so each level gets an equal share
+        int depth = 0;
+        while ((1 << depth) < parts) ++depth;
+        const double levelTolerance = std::pow(1.0 + tolerance_, 1.0 / std::max(depth, 1)) - 1.0;
+        std::vector<MeshIndex> ids(nElements);
+        std::iota(ids.begin(), ids.end(), MeshIndex(0));
+        recursiveBisection(dual, ids, 0, parts, levelTolerance, 1, result.elementPart);
+    } else {
+        std::vector<double> cx(nElements), cy(nElements);
+        parallelFor(nElements, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t e = begin; e < end; ++e) {
+                const MeshIndex* t = &mesh.connectivity[3 * e];
+                cx[e] = (mesh.x[t[0]] + mesh.x[t[1]] + mesh.x[t[2]]) / 3.0;
+                cy[e] = (mesh.y[t[0]] + mesh.y[t[1]] + mesh.y[t[2]]) / 3.0;
+            }
+        });
+        std::vector<MeshIndex> order(nElements);
+        std::iota(order.begin(), order.end(), MeshIndex(0));
+        coordinateBisection(cx, cy, order.data(), order.data() + nElements, 0, parts, result.elementPart);
+    }
+
+    for (std::size_t e = 0; e < nElements; ++e) {
+        for (std::size_t k = dual.offsets[e]; k < dual.offsets[e + 1]; ++k) {
+            MeshIndex f = dual.neighbors[k];
+            if (static_cast<std::size_t>(f) > e && result.elementPart[f] != result.elementPart[e]) ++result.edgeCut;
+        }
+    }
+
+    // Subdomains: elements, then nodes with the parts sharing them
+    result.subdomains.resize(parts);
+    for (std::size_t e = 0; e < nElements; ++e) {
+        result.subdomains[result.elementPart[e]].elements.push_back(static_cast<MeshIndex>(e));
+    }
+    std::shared_ptr<const MeshAdjacency> adjacency = mesh.adjacency();
+    result.nodeOwner.assign(mesh.nodeCount(), -1);
+    std::vector<int> sharers;
+    for (std::size_t i = 0; i < mesh.nodeCount(); ++i) {
+        sharers.clear();
+        for (MeshIndex e : adjacency->elementsOf(static_cast<MeshIndex>(i))) {
+            int part = result.elementPart[e];
+            if (std::find(sharers.begin(), sharers.end(), part) == sharers.end()) sharers.push_back(part);
+        }
+        if (sharers.empty()) continue;
+        std::sort(sharers.begin(), sharers.end());
+        result.nodeOwner[i] = sharers.front();
+        for (int part : sharers) {
+            MeshSubdomain& subdomain = result.subdomains[part];
+            const MeshIndex local = static_cast<MeshIndex>(subdomain.nodes.size());
+            subdomain.nodes.push_back(static_cast<MeshIndex>(i));
+            if (sharers.size() > 1) {
+                subdomain.interfaceNodes.push_back(static_cast<MeshIndex>(i));
+                for (int other : sharers) {
+                    if (other != part) subdomain.halo[other].push_back(local);
+                }
+            }
+        }
+        if (sharers.size() > 1) ++result.interfaceNodes;
+    }
+
+    std::size_t largest = 0;
+    for (const MeshSubdomain& subdomain : result.subdomains) largest = std::max(largest, subdomain.elements.size());
+    result.imbalance = static_cast<double>(largest) * parts / static_cast<double>(nElements);
+    result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+std::string MeshPartition::describe() const {
+    std::size_t smallest = std::numeric_limits<std::size_t>::max(), largest = 0;
+    for (const MeshSubdomain& subdomain : subdomains) {
+        smallest = std::min(smallest, subdomain.elements.size());
+        largest = std::max(largest, subdomain.elements.size());
+    }
+    std::ostringstream out;
+    out << "Mesh partition (" << MeshPartitioner::toString(method) << "): " << subdomains.size() << " parts of "
+        << smallest << " to " << largest << " elements\n"
+        << "  edge cut " << edgeCut << ", interface nodes " << interfaceNodes << ", imbalance " << imbalance
+        << ", " << milliseconds << " ms\n";
+    return out.str();
+}
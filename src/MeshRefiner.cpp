@@ -0,0 +1,159 @@
+#include "MeshRefiner.h"
+#include "MeshAdjacency.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <stdexcept>
+
+void MeshRefiner::labelLongestEdges(Mesh& mesh) {
+    for (std::size_t e = 0; e < mesh.elementCount(); ++e) {
+        MeshIndex* t = &mesh.connectivity[3 * e];
+        int longest = 0;
+        double longestLength = -1.0;
+        for (int k = 0; k < 3; ++k) {
+            MeshIndex a = t[(k + 1) % 3], b = t[(k + 2) % 3];
+            double dx = mesh.x[b] - mesh.x[a], dy = mesh.y[b] - mesh.y[a];
+            double length = dx * dx + dy * dy;
+            if (length > longestLength) {
+                longest = k;
+                longestLength = length;
+            }
+        }
+        MeshIndex rotated[3] = { t[longest], t[(longest + 1) % 3], t[(longest + 2) % 3] };
+        std::copy(rotated, rotated + 3, t);
+    }
+    mesh.id = newMeshId();
+}
+
+Mesh MeshRefiner::refine(const Mesh& mesh, const std::vector<MeshIndex>& marked) {
+    return refineMarked(mesh, &marked);
+}
+
+Mesh MeshRefiner::refineUniformly(const Mesh& mesh) {
+    return refineMarked(mesh, nullptr);
+}
+
+Mesh MeshRefiner::refineMarked(const Mesh& mesh, const std::vector<MeshIndex>* marked) {
+    auto start = std::chrono::steady_clock::now();
+    const std::size_t n = mesh.nodeCount();
+    const std::size_t nElements = mesh.elementCount();
+    statistics_ = Statistics();
+    statistics_.markedElements = marked ? marked->size() : nElements;
+
+    // Number the edges: edgeOf[3e + k] is the edge opposite corner k of element e
+    const std::vector<MeshIndex> across = mesh.adjacency()->elementNeighbors(mesh);
+    std::vector<MeshIndex> edgeOf(3 * nElements, -1);
+    std::vector<std::array<MeshIndex, 2>> edgeNodes;
+    std::vector<char> boundaryEdge;
+    edgeNodes.reserve(3 * nElements / 2 + n);
+    for (std::size_t e = 0; e < nElements; ++e) {
+        for (int k = 0; k < 3; ++k) {
+            if (edgeOf[3 * e + k] >= 0) continue;
+            const MeshIndex edge = static_cast<MeshIndex>(edgeNodes.size());
+            edgeOf[3 * e + k] = edge;
+            edgeNodes.push_back({ mesh.connectivity[3 * e + (k + 1) % 3], mesh.connectivity[3 * e + (k + 2) % 3] });
+            MeshIndex neighbor = across[3 * e + k];
+            boundaryEdge.push_back(neighbor < 0);
+            if (neighbor < 0) continue;
+            for (int j = 0; j < 3; ++j) {
+                if (across[3 * neighbor + j] == static_cast<MeshIndex>(e)) edgeOf[3 * neighbor + j] = edge;
+            }
+        }
+    }
+
+    // Mark the refinement edges of the marked elements, then close the marking: an element
+    // with any marked edge gets its refinement edge marked too. Uniform refinement marks all edges.
+    std::vector<char> edgeMarked(edgeNodes.size(), marked ? 0 : 1);
+    std::vector<MeshIndex> queue;
+    auto markRefinementEdge = [&](MeshIndex e) {
+        MeshIndex edge = edgeOf[3 * e];
+        if (edgeMarked[edge]) return;
+        edgeMarked[edge] = 1;
+        if (across[3 * e] >= 0) queue.push_back(across[3 * e]);
+    };
+    if (marked) {
+        for (MeshIndex e : *marked) {
+            if (e < 0 || static_cast<std::size_t>(e) >= nElements) {
+                throw std::out_of_range("Marked element index out of range");
+            }
+            markRefinementEdge(e);
+        }
+    }
+    while (!queue.empty()) {
+        MeshIndex e = queue.back();
+        queue.pop_back();
+        if (!edgeMarked[edgeOf[3 * e]] && (edgeMarked[edgeOf[3 * e + 1]] || edgeMarked[edgeOf[3 * e + 2]])) {
+            markRefinementEdge(e);
+        }
+    }
+
+    // Midpoint nodes of the marked edges
+    Mesh refined;
+    refined.id = newMeshId();
+    std::vector<MeshIndex> midpoint(edgeNodes.size(), -1);
+    std::size_t newNodes = 0;
+    for (char flag : edgeMarked) newNodes += flag ? 1 : 0;
+    if (!fitsMeshIndex(n + newNodes)) {
+        throw std::runtime_error("Refined mesh is too large for MeshIndex; build with FEMSOLVER_INDEX64");
+    }
+    refined.x.assign(mesh.x.begin(), mesh.x.end());
+    refined.y.assign(mesh.y.begin(), mesh.y.end());
+    refined.x.reserve(n + newNodes);
+    refined.y.reserve(n + newNodes);
+    std::vector<std::uint32_t> tags(n + newNodes, 0u);
+    std::copy(mesh.boundaryTags.begin(), mesh.boundaryTags.begin() + std::min(n, mesh.boundaryTags.size()), tags.begin());
+    for (std::size_t edge = 0; edge < edgeNodes.size(); ++edge) {
+        if (!edgeMarked[edge]) continue;
+        MeshIndex a = edgeNodes[edge][0], b = edgeNodes[edge][1];
+        midpoint[edge] = static_cast<MeshIndex>(refined.x.size());
+        if (boundaryEdge[edge]) tags[midpoint[edge]] = mesh.boundaryTag(a) & mesh.boundaryTag(b);
+        refined.addNode(0.5 * (mesh.x[a] + mesh.x[b]), 0.5 * (mesh.y[a] + mesh.y[b]));
+    }
+
+    // Bisect. Element (p, q, r) with refinement edge (q, r) and midpoint m has the children
+    // (m, p, q) and (m, r, p), whose refinement edges (p, q) and (r, p) are edges of the parent.
+    refined.connectivity.reserve(3 * (nElements + 3 * newNodes));
+    for (std::size_t e = 0; e < nElements; ++e) {
+        const MeshIndex* t = &mesh.connectivity[3 * e];
+        const MeshIndex a = t[0], b = t[1], c = t[2];
+        const MeshIndex m = midpoint[edgeOf[3 * e]];
+        if (m < 0) {
+            refined.addElement({ a, b, c });
+            continue;
+        }
+        ++statistics_.refinedElements;
+        const MeshIndex mab = midpoint[edgeOf[3 * e + 2]];
+        const MeshIndex mca = midpoint[edgeOf[3 * e + 1]];
+        if (mab < 0) {
+            refined.addElement({ m, a, b });
+        } else {
+            refined.addElement({ mab, m, a });
+            refined.addElement({ mab, b, m });
+        }
+        if (mca < 0) {
+            refined.addElement({ m, c, a });
+        } else {
+            refined.addElement({ mca, m, c });
+            refined.addElement({ mca, a, m });
+        }
+    }
+
+    // Boundaries keep their bits; the sets are rebuilt from the tags
+    if (!mesh.boundaryTagNames.empty()) {
+        refined.boundaryTagNames = mesh.boundaryTagNames;
+        refined.boundarySets.resize(mesh.boundaryTagNames.size());
+        for (std::size_t i = 0; i < tags.size(); ++i) {
+            for (std::uint32_t bits = tags[i]; bits; bits &= bits - 1) {
+                std::size_t bit = 0;
+                while (!(bits & (1u << bit))) ++bit;
+                if (bit < refined.boundarySets.size()) refined.boundarySets[bit].push_back(static_cast<MeshIndex>(i));
+            }
+        }
+        refined.boundaryTags = std::move(tags);
+    }
+
+    statistics_.newNodes = newNodes;
+    statistics_.elements = refined.elementCount();
+    statistics_.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return refined;
+}
@@ -0,0 +1,300 @@
+#include "MeshRenumbering.h"
+#include "MeshAdjacency.h"
+#include "SpaceFillingCurve.h"
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Breadth-first search from start over nodes not yet numbered. Returns the visit order and
+// the index in it where the last level begins; level[] is used as scratch (-1 = unvisited).
+std::vector<MeshIndex> levelStructure(const MeshAdjacency& adjacency, MeshIndex start, std::vector<MeshIndex>& level,
+                                      std::size_t& lastLevelBegin, MeshIndex& depth) {
+    std::vector<MeshIndex> order{ start };
+    level[start] = 0;
+    lastLevelBegin = 0;
+    depth = 0;
+    for (std::size_t head = 0; head < order.size(); ++head) {
+        MeshIndex node = order[head];
+        if (level[node] > depth) {
+            depth = level[node];
+            lastLevelBegin = head;
+        }
+        for (MeshIndex neighbor : adjacency.neighborsOf(node)) {
+            if (level[neighbor] < 0) {
+                level[neighbor] = level[node] + 1;
+                order.push_back(neighbor);
+            }
+        }
+    }
+    return order;
+}
+
+// George-Liu search for a node of (nearly) maximal eccentricity in the component of start
+MeshIndex pseudoPeripheralNode(const MeshAdjacency& adjacency, MeshIndex start, std::vector<MeshIndex>& level) {
+    MeshIndex node = start;
+    MeshIndex depth = -1;
+    for (;;) {
+        std::size_t lastLevelBegin;
+        MeshIndex nodeDepth;
+        std::vector<MeshIndex> order = levelStructure(adjacency, node, level, lastLevelBegin, nodeDepth);
+        for (MeshIndex visited : order) {
+            level[visited] = -1;
+        }
+        if (nodeDepth <= depth) {
+            return node;
+        }
+        depth = nodeDepth;
+
+        // Continue from the lowest-degree node of the last level
+        MeshIndex next = order[lastLevelBegin];
+        for (std::size_t k = lastLevelBegin + 1; k < order.size(); ++k) {
+            if (adjacency.degree(order[k]) < adjacency.degree(next)) {
+                next = order[k];
+            }
+        }
+        if (next == node) {
+            return node;
+        }
+        node = next;
+    }
+}
+
+} // namespace
+
+std::vector<double> MeshPermutation::toOriginalOrder(const std::vector<double>& renumbered) const {
+    if (renumbered.size() != nodeNewToOld.size()) {
+        throw std::invalid_argument("Nodal vector size does not match the permutation");
+    }
+    std::vector<double> original(renumbered.size());
+    for (std::size_t i = 0; i < renumbered.size(); ++i) {
+        original[nodeNewToOld[i]] = renumbered[i];
+    }
+    return original;
+}
+
+std::vector<double> MeshPermutation::toRenumberedOrder(const std::vector<double>& original) const {
+    if (original.size() != nodeNewToOld.size()) {
+        throw std::invalid_argument("Nodal vector size does not match the permutation");
+    }
+    std::vector<double> renumbered(original.size());
+    for (std::size_t i = 0; i < original.size(); ++i) {
+        renumbered[i] = original[nodeNewToOld[i]];
+    }
+    return renumbered;
+}
+
+std::string RenumberingReport::describe() const {
+    std::ostringstream out;
+    out << "Node ordering: " << MeshRenumberer::toString(ordering) << "\n"
+        << "  bandwidth " << bandwidthBefore << " -> " << bandwidthAfter << "\n"
+        << "  profile   " << profileBefore << " -> " << profileAfter << "\n";
+    return out.str();
+}
+
+MeshRenumberer::MeshRenumberer(NodeOrdering ordering) : ordering_(ordering) {}
+
+Mesh MeshRenumberer::renumber(const Mesh& mesh, MeshPermutation& permutation, RenumberingReport& report) const {
+    permutation = computePermutation(mesh);
+    Mesh renumbered = apply(mesh, permutation);
+
+    report.ordering = ordering_;
+    report.bandwidthBefore = bandwidth(mesh);
+    report.profileBefore = profile(mesh);
+    report.bandwidthAfter = bandwidth(renumbered);
+    report.profileAfter = profile(renumbered);
+    return renumbered;
+}
+
+MeshPermutation MeshRenumberer::computePermutation(const Mesh& mesh) const {
+    const MeshIndex nNodes = static_cast<MeshIndex>(mesh.nodeCount());
+    const MeshIndex nElements = static_cast<MeshIndex>(mesh.elementCount());
+
+    MeshPermutation permutation;
+    switch (ordering_) {
+    case NodeOrdering::ReverseCuthillMcKee:
+        permutation.nodeNewToOld = reverseCuthillMcKee(mesh);
+        break;
+    case NodeOrdering::Hilbert:
+    case NodeOrdering::Morton:
+        permutation.nodeNewToOld = spaceFillingCurve(mesh, ordering_ == NodeOrdering::Hilbert);
+        break;
+    default:
+        permutation.nodeNewToOld.resize(nNodes);
+        for (MeshIndex i = 0; i < nNodes; ++i) permutation.nodeNewToOld[i] = i;
+        break;
+    }
+
+    permutation.nodeOldToNew.resize(nNodes);
+    for (MeshIndex i = 0; i < nNodes; ++i) {
+        permutation.nodeOldToNew[permutation.nodeNewToOld[i]] = i;
+    }
+
+    // Elements ordered by their lowest renumbered node (ties keep the original order)
+    std::vector<MeshIndex> lowestNode(nElements);
+    for (MeshIndex e = 0; e < nElements; ++e) {
+        const MeshIndex* nodes = &mesh.connectivity[3 * static_cast<std::size_t>(e)];
+        lowestNode[e] = std::min({ permutation.nodeOldToNew[nodes[0]], permutation.nodeOldToNew[nodes[1]],
+                                   permutation.nodeOldToNew[nodes[2]] });
+    }
+    permutation.elementNewToOld.resize(nElements);
+    for (MeshIndex e = 0; e < nElements; ++e) permutation.elementNewToOld[e] = e;
+    std::stable_sort(permutation.elementNewToOld.begin(), permutation.elementNewToOld.end(),
+                     [&](MeshIndex a, MeshIndex b) { return lowestNode[a] < lowestNode[b]; });
+
+    return permutation;
+}
+
+Mesh MeshRenumberer::apply(const Mesh& mesh, const MeshPermutation& permutation) {
+    const std::size_t nNodes = mesh.nodeCount();
+    const std::size_t nElements = mesh.elementCount();
+    if (permutation.nodeNewToOld.size() != nNodes || permutation.elementNewToOld.size() != nElements) {
+        throw std::invalid_argument("Permutation does not match the mesh");
+    }
+
+    Mesh renumbered;
+    renumbered.id = newMeshId();
+    renumbered.reserve(nNodes, nElements);
+    for (std::size_t i = 0; i < nNodes; ++i) {
+        MeshIndex old = permutation.nodeNewToOld[i];
+        renumbered.addNode(mesh.x[old], mesh.y[old]);
+    }
+    for (std::size_t e = 0; e < nElements; ++e) {
+        Element element = mesh.element(permutation.elementNewToOld[e]);
+        for (MeshIndex& node : element) {
+            node = permutation.nodeOldToNew[node];
+        }
+        renumbered.addElement(element);
+    }
+
+    // Boundaries keep their bits; tags move with the nodes and the sets are re-sorted
+    renumbered.boundaryTagNames = mesh.boundaryTagNames;
+    renumbered.boundaryTags.assign(nNodes, 0u);
+    for (std::size_t i = 0; i < nNodes; ++i) {
+        renumbered.boundaryTags[i] = mesh.boundaryTag(permutation.nodeNewToOld[i]);
+    }
+    renumbered.boundarySets.resize(mesh.boundarySets.size());
+    for (std::size_t bit = 0; bit < mesh.boundarySets.size(); ++bit) {
+        std::vector<MeshIndex>& set = renumbered.boundarySets[bit];
+        for (MeshIndex node : mesh.boundarySets[bit]) {
+            set.push_back(permutation.nodeOldToNew[node]);
+        }
+        std::sort(set.begin(), set.end());
+    }
+
+    return renumbered;
+}
+
+std::size_t MeshRenumberer::bandwidth(const Mesh& mesh) {
+    std::size_t result = 0;
+    for (std::size_t e = 0; e < mesh.elementCount(); ++e) {
+        const MeshIndex* nodes = &mesh.connectivity[3 * e];
+        MeshIndex lo = std::min({ nodes[0], nodes[1], nodes[2] });
+        MeshIndex hi = std::max({ nodes[0], nodes[1], nodes[2] });
+        result = std::max(result, static_cast<std::size_t>(hi - lo));
+    }
+    return result;
+}
+
+std::size_t MeshRenumberer::profile(const Mesh& mesh) {
+    const std::size_t nNodes = mesh.nodeCount();
+    std::vector<MeshIndex> lowest(nNodes);
+    for (std::size_t i = 0; i < nNodes; ++i) lowest[i] = static_cast<MeshIndex>(i);
+
+    for (std::size_t e = 0; e < mesh.elementCount(); ++e) {
+        const MeshIndex* nodes = &mesh.connectivity[3 * e];
+        MeshIndex lo = std::min({ nodes[0], nodes[1], nodes[2] });
+        for (int a = 0; a < 3; ++a) {
+            lowest[nodes[a]] = std::min(lowest[nodes[a]], lo);
+        }
+    }
+
+    std::size_t result = 0;
+    for (std::size_t i = 0; i < nNodes; ++i) {
+        result += i - static_cast<std::size_t>(lowest[i]);
+    }
+    return result;
+}
+
+const char* MeshRenumberer::toString(NodeOrdering ordering) {
+    switch (ordering) {
+    case NodeOrdering::ReverseCuthillMcKee: return "reverse Cuthill-McKee";
+    case NodeOrdering::Hilbert: return "Hilbert curve";
+    case NodeOrdering::Morton: return "Morton curve";
+    default: return "original";
+    }
+}
+
+std::vector<MeshIndex> MeshRenumberer::reverseCuthillMcKee(const Mesh& mesh) {
+    const MeshIndex nNodes = static_cast<MeshIndex>(mesh.nodeCount());
+    std::shared_ptr<const MeshAdjacency> sharedAdjacency = mesh.adjacency();
+    const MeshAdjacency& adjacency = *sharedAdjacency;
+
+    // Components are started in order of increasing degree, each from a pseudo-peripheral node
+    std::vector<MeshIndex> candidates(nNodes);
+    for (MeshIndex i = 0; i < nNodes; ++i) candidates[i] = i;
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&](MeshIndex a, MeshIndex b) { return adjacency.degree(a) < adjacency.degree(b); });
+
+    std::vector<MeshIndex> order;
+    order.reserve(nNodes);
+    std::vector<char> numbered(nNodes, 0);
+    std::vector<MeshIndex> level(nNodes, -1);
+    std::vector<MeshIndex> neighbors;
+
+    for (MeshIndex candidate : candidates) {
+        if (numbered[candidate]) continue;
+
+        MeshIndex start = pseudoPeripheralNode(adjacency, candidate, level);
+        std::size_t head = order.size();
+        order.push_back(start);
+        numbered[start] = 1;
+
+        // Cuthill-McKee: visit neighbours in order of increasing degree
+        for (; head < order.size(); ++head) {
+            MeshIndex node = order[head];
+            neighbors.clear();
+            for (MeshIndex neighbor : adjacency.neighborsOf(node)) {
+                if (!numbered[neighbor]) {
+                    numbered[neighbor] = 1;
+                    neighbors.push_back(neighbor);
+                }
+            }
+            std::stable_sort(neighbors.begin(), neighbors.end(),
+                             [&](MeshIndex a, MeshIndex b) { return adjacency.degree(a) < adjacency.degree(b); });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+std::vector<MeshIndex> MeshRenumberer::spaceFillingCurve(const Mesh& mesh, bool hilbert) {
+    const std::size_t nNodes = mesh.nodeCount();
+    std::vector<MeshIndex> order(nNodes);
+    if (nNodes == 0) return order;
+
+    auto xRange = std::minmax_element(mesh.x.begin(), mesh.x.end());
+    auto yRange = std::minmax_element(mesh.y.begin(), mesh.y.end());
+    double xMin = *xRange.first, yMin = *yRange.first;
+    // One scale for both axes, so the curve follows the geometry of wide domains
+    double extent = std::max(*xRange.second - xMin, *yRange.second - yMin);
+    double scale = extent > 0.0 ? 65535.0 / extent : 0.0;
+
+    std::vector<std::uint64_t> keys(nNodes);
+    for (std::size_t i = 0; i < nNodes; ++i) {
+        auto gx = static_cast<std::uint32_t>((mesh.x[i] - xMin) * scale + 0.5);
+        auto gy = static_cast<std::uint32_t>((mesh.y[i] - yMin) * scale + 0.5);
+        gx = std::min<std::uint32_t>(gx, 65535u);
+        gy = std::min<std::uint32_t>(gy, 65535u);
+        keys[i] = hilbert ? hilbertIndex(gx, gy) : mortonIndex(gx, gy);
+        order[i] = static_cast<MeshIndex>(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](MeshIndex a, MeshIndex b) { return keys[a] < keys[b]; });
+    return order;
+}
@@ -0,0 +1,367 @@
+#include "OperatorAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const double kInf = std::numeric_limits<double>::infinity();
+const double kTwoPi = 2.0 * M_PI;
+
+// Threshold below which the assembly treats a convection component as zero
+const double kConvectionThreshold = 1e-9;
+
+Interval nanInterval() {
+    Interval result = Interval::entire();
+    result.nan = true;
+    return result;
+}
+
+// Round the bounds outward by one ulp to cover the error of a library function
+Interval widen(Interval a) {
+    if (std::isnan(a.lo)) a.lo = -kInf;
+    if (std::isnan(a.hi)) a.hi = kInf;
+    a.lo = std::nextafter(a.lo, -kInf);
+    a.hi = std::nextafter(a.hi, kInf);
+    return a;
+}
+
+bool isFinite(const Interval& a) {
+    return std::isfinite(a.lo) && std::isfinite(a.hi);
+}
+
+// Directed rounding of sums and products: the rounding error is recovered exactly
+// (two-sum, fma) and the result is moved one ulp only when it was rounded the wrong way
+double addDown(double a, double b) {
+    double s = a + b;
+    double bb = s - a;
+    double err = (a - (s - bb)) + (b - bb);
+    return err < 0.0 ? std::nextafter(s, -kInf) : s;
+}
+
+double addUp(double a, double b) {
+    double s = a + b;
+    double bb = s - a;
+    double err = (a - (s - bb)) + (b - bb);
+    return err > 0.0 ? std::nextafter(s, kInf) : s;
+}
+
+// Product bounds with 0 * inf taken as 0
+double mulDown(double a, double b) {
+    if (a == 0.0 || b == 0.0) return 0.0;
+    double p = a * b;
+    return std::fma(a, b, -p) < 0.0 ? std::nextafter(p, -kInf) : p;
+}
+
+double mulUp(double a, double b) {
+    if (a == 0.0 || b == 0.0) return 0.0;
+    double p = a * b;
+    return std::fma(a, b, -p) > 0.0 ? std::nextafter(p, kInf) : p;
+}
+
+// Whether some phase + 2*pi*k may lie in [lo, hi]; errs on the side of yes
+bool mayContainPhase(double lo, double hi, double phase) {
+    double margin = 1e-12 * (1.0 + std::abs(lo) + std::abs(hi));
+    double k = std::ceil((lo - margin - phase) / kTwoPi);
+    return phase + k * kTwoPi <= hi + margin;
+}
+
+Interval sinCosRange(const Interval& a, bool isCos) {
+    if (a.nan || !isFinite(a)) return nanInterval();
+    if (a.hi - a.lo >= kTwoPi) return Interval(-1.0, 1.0);
+
+    double f1 = isCos ? std::cos(a.lo) : std::sin(a.lo);
+    double f2 = isCos ? std::cos(a.hi) : std::sin(a.hi);
+    Interval result = widen(Interval(std::min(f1, f2), std::max(f1, f2)));
+
+    double maxPhase = isCos ? 0.0 : M_PI / 2.0;
+    double minPhase = isCos ? M_PI : -M_PI / 2.0;
+    if (mayContainPhase(a.lo, a.hi, maxPhase)) result.hi = 1.0;
+    if (mayContainPhase(a.lo, a.hi, minPhase)) result.lo = -1.0;
+    result.lo = std::max(result.lo, -1.0);
+    result.hi = std::min(result.hi, 1.0);
+    return result;
+}
+
+Interval tanRange(const Interval& a) {
+    if (a.nan || !isFinite(a)) return nanInterval();
+    if (a.hi - a.lo >= M_PI || mayContainPhase(a.lo, a.hi, M_PI / 2.0) ||
+        mayContainPhase(a.lo, a.hi, -M_PI / 2.0)) {
+        return Interval::entire();
+    }
+    return widen(Interval(std::tan(a.lo), std::tan(a.hi)));
+}
+
+// Square root of the nonnegative part; sqrt is correctly rounded, so the fma residual gives the direction
+Interval sqrtRange(const Interval& a) {
+    double lo = std::max(a.lo, 0.0), hi = std::max(a.hi, 0.0);
+    double rlo = std::sqrt(lo), rhi = std::sqrt(hi);
+    if (std::fma(rlo, rlo, -lo) > 0.0) rlo = std::nextafter(rlo, 0.0);
+    if (std::fma(rhi, rhi, -hi) < 0.0) rhi = std::nextafter(rhi, kInf);
+    return Interval(rlo, rhi);
+}
+
+Interval absRange(const Interval& a) {
+    if (a.nan) return nanInterval();
+    if (a.lo >= 0.0) return a;
+    if (a.hi <= 0.0) return -a;
+    return Interval(0.0, std::max(-a.lo, a.hi));
+}
+
+double magnitude(const Interval& a) {
+    return std::max(std::abs(a.lo), std::abs(a.hi));
+}
+
+} // namespace
+
+Interval operator+(const Interval& a, const Interval& b) {
+    if (a.nan || b.nan) return nanInterval();
+    return Interval(addDown(a.lo, b.lo), addUp(a.hi, b.hi));
+}
+
+Interval operator-(const Interval& a, const Interval& b) {
+    if (a.nan || b.nan) return nanInterval();
+    return Interval(addDown(a.lo, -b.hi), addUp(a.hi, -b.lo));
+}
+
+Interval operator-(const Interval& a) {
+    Interval result(-a.hi, -a.lo);
+    result.nan = a.nan;
+    return result;
+}
+
+Interval operator*(const Interval& a, const Interval& b) {
+    if (a.nan || b.nan) return nanInterval();
+    if (a.isPoint() && a.lo == 0.0) return Interval(0.0);
+    if (b.isPoint() && b.lo == 0.0) return Interval(0.0);
+
+    double lo = std::min({ mulDown(a.lo, b.lo), mulDown(a.lo, b.hi), mulDown(a.hi, b.lo), mulDown(a.hi, b.hi) });
+    double hi = std::max({ mulUp(a.lo, b.lo), mulUp(a.lo, b.hi), mulUp(a.hi, b.lo), mulUp(a.hi, b.hi) });
+    return Interval(lo, hi);
+}
+
+Interval sqr(const Interval& a) {
+    if (a.nan) return nanInterval();
+    if (a.lo >= 0.0) return Interval(mulDown(a.lo, a.lo), mulUp(a.hi, a.hi));
+    if (a.hi <= 0.0) return Interval(mulDown(a.hi, a.hi), mulUp(a.lo, a.lo));
+    return Interval(0.0, std::max(mulUp(a.lo, a.lo), mulUp(a.hi, a.hi)));
+}
+
+Interval hull(const Interval& a, const Interval& b) {
+    Interval result(std::min(a.lo, b.lo), std::max(a.hi, b.hi));
+    result.nan = a.nan || b.nan;
+    return result;
+}
+
+OperatorAnalyzer::OperatorAnalyzer(int maxDepth)
+    : maxDepth_(std::max(0, maxDepth)) {
+}
+
+Interval OperatorAnalyzer::evaluate(const CompiledExpression& expression, const Interval& x, const Interval& y) {
+    using OpCode = CompiledExpression::OpCode;
+
+    if (!expression.isValid() || expression.isConstant()) {
+        return Interval(expression.constantValue());
+    }
+
+    // A point where evaluation fails yields 0; mayFail records that such points may exist
+    bool mayFail = false;
+    std::vector<Interval> stack;
+    stack.reserve(static_cast<std::size_t>(expression.stackDepth()));
+
+    for (const CompiledExpression::Instruction& instruction : expression.program()) {
+        switch (instruction.op) {
+            case OpCode::Constant: stack.push_back(Interval(instruction.value)); continue;
+            case OpCode::VarX: stack.push_back(x); continue;
+            case OpCode::VarY: stack.push_back(y); continue;
+            default: break;
+        }
+
+        if (instruction.op == OpCode::Add || instruction.op == OpCode::Sub ||
+            instruction.op == OpCode::Mul || instruction.op == OpCode::Div) {
+            Interval right = stack.back();
+            stack.pop_back();
+            Interval& left = stack.back();
+
+            switch (instruction.op) {
+                case OpCode::Add: left = left + right; break;
+                case OpCode::Sub: left = left - right; break;
+                case OpCode::Mul: left = left * right; break;
+                default:
+                    if (right.nan) {
+                        left = nanInterval();
+                    } else if (right.isPoint() && right.lo == 0.0) {
+                        return Interval(0.0); // Fails at every point
+                    } else if (right.lo <= 0.0 && right.hi >= 0.0) {
+                        mayFail = true;
+                        left = (left.isPoint() && left.lo == 0.0) ? Interval(0.0) : Interval::entire();
+                    } else {
+                        left = left * widen(Interval(1.0 / right.hi, 1.0 / right.lo));
+                    }
+                    break;
+            }
+            continue;
+        }
+
+        Interval& top = stack.back();
+        switch (instruction.op) {
+            case OpCode::Neg: top = -top; break;
+            case OpCode::Sin: top = sinCosRange(top, false); break;
+            case OpCode::Cos: top = sinCosRange(top, true); break;
+            case OpCode::Tan: top = tanRange(top); break;
+            case OpCode::Exp:
+                if (!top.nan) top = widen(Interval(std::exp(top.lo), std::exp(top.hi)));
+                break;
+            case OpCode::Log:
+                if (top.nan || top.lo < 0.0) {
+                    top = nanInterval();
+                } else {
+                    top = widen(Interval(std::log(top.lo), std::log(top.hi)));
+                }
+                break;
+            case OpCode::Sqrt:
+                if (top.nan) break;
+                if (top.hi < 0.0) return Interval(0.0); // Fails at every point
+                if (top.lo < 0.0) mayFail = true;
+                top = sqrtRange(top);
+                break;
+            case OpCode::Abs: top = absRange(top); break;
+            default: break;
+        }
+    }
+
+    Interval result = stack.empty() ? Interval(0.0) : stack.back();
+    return mayFail ? hull(result, Interval(0.0)) : result;
+}
+
+OperatorAnalyzer::Report OperatorAnalyzer::analyze(
+    const CompiledExpression& a11, const CompiledExpression& a12, const CompiledExpression& a22,
+    const CompiledExpression& b1, const CompiledExpression& b2, const CompiledExpression& c,
+    double Lx, double Ly, bool hasDirichletBoundary
+) const {
+    Report report;
+
+    // Properties proven on every leaf box, and point witnesses that rule them out for good
+    bool ellipticEverywhere = true, reactionNonnegative = true, symmetricEverywhere = true;
+    bool reactionPositiveSomewhere = false;
+    bool ellipticRefuted = false, reactionRefuted = false, asymmetryWitnessed = false;
+    bool firstLeaf = true;
+
+    struct Box {
+        double x0, x1, y0, y1;
+        int depth;
+    };
+    std::vector<Box> pending = { { 0.0, Lx, 0.0, Ly, 0 } };
+
+    while (!pending.empty()) {
+        Box box = pending.back();
+        pending.pop_back();
+        ++report.boxes;
+
+        Interval x(box.x0, box.x1), y(box.y0, box.y1);
+        Interval a11Range = evaluate(a11, x, y);
+        Interval a12Range = evaluate(a12, x, y);
+        Interval a22Range = evaluate(a22, x, y);
+        Interval b1Range = evaluate(b1, x, y);
+        Interval b2Range = evaluate(b2, x, y);
+        Interval cRange = evaluate(c, x, y);
+
+        // The assembly weights a12 twice, so the diffusion tensor is [a11, 2*a12; 2*a12, a22]
+        Interval discriminant = a11Range * a22Range - sqr(Interval(2.0) * a12Range);
+        Interval convection = sqrtRange(sqr(b1Range) + sqr(b2Range));
+        if (b1Range.nan || b2Range.nan) convection = nanInterval();
+
+        bool elliptic = !a11Range.nan && !discriminant.nan && a11Range.lo > 0.0 && discriminant.lo > 0.0;
+        bool nonnegative = !cRange.nan && cRange.lo >= 0.0;
+        bool symmetric = !b1Range.nan && !b2Range.nan &&
+                         magnitude(b1Range) < kConvectionThreshold && magnitude(b2Range) < kConvectionThreshold;
+
+        // Point values at the box centre can settle a property negatively
+        double xm = 0.5 * (box.x0 + box.x1), ym = 0.5 * (box.y0 + box.y1);
+        double a11Point = a11.evaluate(xm, ym), a12Point = a12.evaluate(xm, ym), a22Point = a22.evaluate(xm, ym);
+        if (!(a11Point > 0.0 && a11Point * a22Point - 4.0 * a12Point * a12Point > 0.0)) ellipticRefuted = true;
+        if (!(c.evaluate(xm, ym) >= 0.0)) reactionRefuted = true;
+        if (!(std::abs(b1.evaluate(xm, ym)) < kConvectionThreshold &&
+              std::abs(b2.evaluate(xm, ym)) < kConvectionThreshold)) asymmetryWitnessed = true;
+
+        bool undecided = (!elliptic && !ellipticRefuted) ||
+                         (!nonnegative && !reactionRefuted) ||
+                         (!symmetric && !asymmetryWitnessed);
+        if (undecided && box.depth < maxDepth_) {
+            // Bisect the longer side
+            if (box.x1 - box.x0 >= box.y1 - box.y0) {
+                pending.push_back({ box.x0, xm, box.y0, box.y1, box.depth + 1 });
+                pending.push_back({ xm, box.x1, box.y0, box.y1, box.depth + 1 });
+            } else {
+                pending.push_back({ box.x0, box.x1, box.y0, ym, box.depth + 1 });
+                pending.push_back({ box.x0, box.x1, ym, box.y1, box.depth + 1 });
+            }
+            continue;
+        }
+
+        if (firstLeaf) {
+            report.a11 = a11Range;
+            report.a22 = a22Range;
+            report.discriminant = discriminant;
+            report.c = cRange;
+            report.convection = convection;
+            firstLeaf = false;
+        } else {
+            report.a11 = hull(report.a11, a11Range);
+            report.a22 = hull(report.a22, a22Range);
+            report.discriminant = hull(report.discriminant, discriminant);
+            report.c = hull(report.c, cRange);
+            report.convection = hull(report.convection, convection);
+        }
+
+        ellipticEverywhere = ellipticEverywhere && elliptic;
+        reactionNonnegative = reactionNonnegative && nonnegative;
+        symmetricEverywhere = symmetricEverywhere && symmetric;
+        reactionPositiveSomewhere = reactionPositiveSomewhere || (nonnegative && cRange.lo > 0.0);
+    }
+
+    report.elliptic = ellipticEverywhere;
+    report.symmetric = symmetricEverywhere;
+
+    if (!report.elliptic) {
+        report.classification = OperatorClass::PossiblyIndefinite;
+    } else if (!report.symmetric) {
+        report.classification = OperatorClass::Nonsymmetric;
+    } else if (reactionNonnegative && (hasDirichletBoundary || reactionPositiveSomewhere)) {
+        report.classification = OperatorClass::SymmetricPositiveDefinite;
+    } else {
+        report.classification = OperatorClass::PossiblyIndefinite;
+    }
+
+    return report;
+}
+
+const char* OperatorAnalyzer::toString(OperatorClass classification) {
+    switch (classification) {
+        case OperatorClass::SymmetricPositiveDefinite: return "symmetric positive definite";
+        case OperatorClass::Nonsymmetric: return "nonsymmetric";
+        default: return "possibly indefinite";
+    }
+}
+
+std::string OperatorAnalyzer::Report::describe() const {
+    auto range = [](const Interval& a) {
+        std::ostringstream oss;
+        if (a.nan) {
+            oss << "undefined";
+        } else {
+            oss << "[" << a.lo << ", " << a.hi << "]";
+        }
+        return oss.str();
+    };
+
+    std::ostringstream oss;
+    oss << "Operator: " << toString(classification) << " (" << boxes << " boxes)\n";
+    oss << "  a11 in " << range(a11) << "\n";
+    oss << "  a22 in " << range(a22) << "\n";
+    oss << "  det(A) in " << range(discriminant) << "\n";
+    oss << "  c in " << range(c) << "\n";
+    oss << "  |b| in " << range(convection) << "\n";
+    return oss.str();
+}
@@ -0,0 +1,92 @@
+#include "QuadraticMesh.h"
+#include "MeshAdjacency.h"
+#include <stdexcept>
+
+QuadraticMesh QuadraticMesh::fromLinear(const Mesh& mesh) {
+    const std::size_t n = mesh.nodeCount();
+    const std::size_t nElements = mesh.elementCount();
+    const std::vector<MeshIndex> across = mesh.adjacency()->elementNeighbors(mesh);
+
+    // Every interior edge is seen from two elements; the first one numbers its midpoint
+    std::vector<MeshIndex> midpoint(3 * nElements, -1);
+    std::size_t edges = 0;
+    for (std::size_t e = 0; e < nElements; ++e) {
+        for (int k = 0; k < 3; ++k) {
+            if (midpoint[3 * e + k] >= 0) continue;
+            midpoint[3 * e + k] = static_cast<MeshIndex>(n + edges++);
+            MeshIndex neighbor = across[3 * e + k];
+            if (neighbor < 0) continue;
+            for (int j = 0; j < 3; ++j) {
+                if (across[3 * neighbor + j] == static_cast<MeshIndex>(e)) midpoint[3 * neighbor + j] = midpoint[3 * e + k];
+            }
+        }
+    }
+    if (!fitsMeshIndex(n + edges)) {
+        throw std::runtime_error("Quadratic mesh is too large for MeshIndex; build with FEMSOLVER_INDEX64");
+    }
+
+    QuadraticMesh quadratic;
+    quadratic.id = newMeshId();
+    quadratic.vertexCount = n;
+    quadratic.x.resize(n + edges);
+    quadratic.y.resize(n + edges);
+    std::copy(mesh.x.begin(), mesh.x.end(), quadratic.x.begin());
+    std::copy(mesh.y.begin(), mesh.y.end(), quadratic.y.begin());
+    quadratic.connectivity.resize(6 * nElements);
+    std::vector<std::uint32_t> tags(n + edges, 0u);
+    for (std::size_t i = 0; i < n; ++i) tags[i] = mesh.boundaryTag(i);
+
+    for (std::size_t e = 0; e < nElements; ++e) {
+        const MeshIndex* t = &mesh.connectivity[3 * e];
+        MeshIndex* q = &quadratic.connectivity[6 * e];
+        for (int k = 0; k < 3; ++k) {
+            MeshIndex a = t[(k + 1) % 3], b = t[(k + 2) % 3], m = midpoint[3 * e + k];
+            q[k] = t[k];
+            q[3 + k] = m;
+            quadratic.x[m] = 0.5 * (mesh.x[a] + mesh.x[b]);
+            quadratic.y[m] = 0.5 * (mesh.y[a] + mesh.y[b]);
+            if (across[3 * e + k] < 0) tags[m] = mesh.boundaryTag(a) & mesh.boundaryTag(b);
+        }
+    }
+
+    if (!mesh.boundaryTagNames.empty()) {
+        quadratic.boundaryTagNames = mesh.boundaryTagNames;
+        quadratic.boundarySets.resize(mesh.boundaryTagNames.size());
+        for (std::size_t i = 0; i < tags.size(); ++i) {
+            for (std::size_t bit = 0; bit < quadratic.boundarySets.size(); ++bit) {
+                if (tags[i] & (1u << bit)) quadratic.boundarySets[bit].push_back(static_cast<MeshIndex>(i));
+            }
+        }
+        quadratic.boundaryTags = std::move(tags);
+    }
+    return quadratic;
+}
+
+Mesh QuadraticMesh::subdivided() const {
+    Mesh mesh;
+    mesh.id = newMeshId();
+    mesh.x = x;
+    mesh.y = y;
+    mesh.connectivity.reserve(12 * elementCount());
+    for (std::size_t e = 0; e < elementCount(); ++e) {
+        const MeshIndex* q = &connectivity[6 * e];
+        // Corner triangles keep the orientation of the element, then the middle one
+        mesh.addElement({ q[0], q[5], q[4] });
+        mesh.addElement({ q[5], q[1], q[3] });
+        mesh.addElement({ q[4], q[3], q[2] });
+        mesh.addElement({ q[3], q[4], q[5] });
+    }
+    mesh.boundaryTags = boundaryTags;
+    mesh.boundaryTagNames = boundaryTagNames;
+    mesh.boundarySets = boundarySets;
+    return mesh;
+}
+
+int QuadraticMesh::boundaryTagBit(const std::string& name) const {
+    for (std::size_t bit = 0; bit < boundaryTagNames.size(); ++bit) {
+        if (!boundaryTagNames[bit].empty() && boundaryTagNames[bit] == name) {
+            return static_cast<int>(bit);
+        }
+    }
+    return -1;
+}
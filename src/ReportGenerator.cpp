@@ -1,10 +1,13 @@
 #include "ReportGenerator.h"
+#include "StructuredMeshView.h"
+#include "MeshCache.h"
 #include <algorithm>
 #include <numeric>
 #include <iomanip>
 
+template <class MeshType>
 void ReportGenerator::generateReport(
-    const Mesh& mesh,
+    const MeshType& mesh,
     const std::vector<double>& solution,
     const std::map<std::string, std::string>& equationCoefficients,
     const std::map<std::string, BoundaryConditionData>& boundaryConditions,
@@ -50,18 +53,20 @@ void ReportGenerator::generateReport(
     file << "Node\tX\t\tY\t\tValue\n";
     file << "----\t-\t\t-\t\t-----\n";
     
-    for (size_t i = 0; i < std::min(mesh.nodes.size(), solution.size()); ++i) {
+    for (size_t i = 0; i < std::min(mesh.nodeCount(), solution.size()); ++i) {
+        const Node& node = mesh.node(i);
         file << i << "\t"
-             << std::fixed << std::setprecision(6) << mesh.nodes[i].first << "\t"
-             << std::fixed << std::setprecision(6) << mesh.nodes[i].second << "\t"
+             << std::fixed << std::setprecision(6) << node.first << "\t"
+             << std::fixed << std::setprecision(6) << node.second << "\t"
              << std::fixed << std::setprecision(8) << solution[i] << "\n";
     }
 
     file.close();
 }
 
+template <class MeshType>
 void ReportGenerator::exportSolutionData(
-    const Mesh& mesh,
+    const MeshType& mesh,
     const std::vector<double>& solution,
     const std::string& filename
 ) {
@@ -75,18 +80,20 @@ void ReportGenerator::exportSolutionData(
     file << "# Format: Node_Index X_Coord Y_Coord Solution_Value\n";
 
     // Write solution data
-    for (size_t i = 0; i < std::min(mesh.nodes.size(), solution.size()); ++i) {
+    for (size_t i = 0; i < std::min(mesh.nodeCount(), solution.size()); ++i) {
+        const Node& node = mesh.node(i);
         file << i << " " 
-             << mesh.nodes[i].first << " " 
-             << mesh.nodes[i].second << " " 
+             << node.first << " " 
+             << node.second << " " 
              << solution[i] << "\n";
     }
 
     file.close();
 }
 
+template <class MeshType>
 void ReportGenerator::exportMeshData(
-    const Mesh& mesh,
+    const MeshType& mesh,
     const std::string& filename
 ) {
     std::ofstream file(filename);
@@ -99,27 +106,30 @@ void ReportGenerator::exportMeshData(
     file << "# Nodes:\n";
 
     // Write nodes
-    for (size_t i = 0; i < mesh.nodes.size(); ++i) {
-        file << "N " << i << " " << mesh.nodes[i].first << " " << mesh.nodes[i].second << "\n";
+    for (size_t i = 0; i < mesh.nodeCount(); ++i) {
+        const Node& node = mesh.node(i);
+        file << "N " << i << " " << node.first << " " << node.second << "\n";
     }
 
     file << "# Elements:\n";
 
     // Write elements
-    for (size_t i = 0; i < mesh.elements.size(); ++i) {
+    for (size_t i = 0; i < mesh.elementCount(); ++i) {
+        const Element& element = mesh.element(i);
         file << "E " << i << " " 
-             << mesh.elements[i][0] << " " 
-             << mesh.elements[i][1] << " " 
-             << mesh.elements[i][2] << "\n";
+             << element[0] << " " 
+             << element[1] << " " 
+             << element[2] << "\n";
     }
 
     file << "# Boundaries:\n";
 
     // Write boundary information
-    for (const auto& boundary : mesh.boundaries) {
-        file << "# Boundary: " << boundary.first << "\n";
-        for (int nodeIdx : boundary.second) {
-            file << "B " << boundary.first << " " << nodeIdx << "\n";
+    for (const std::string& name : mesh.boundaryNames()) {
+        file << "# Boundary: " << name << "\n";
+        auto boundary = mesh.findBoundary(name);
+        for (MeshIndex nodeIdx : *boundary) {
+            file << "B " << name << " " << nodeIdx << "\n";
         }
     }
 
@@ -152,18 +162,21 @@ std::string ReportGenerator::generateSolutionStatistics(const std::vector<double
     return oss.str();
 }
 
-std::string ReportGenerator::generateMeshInformation(const Mesh& mesh) {
+template <class MeshType>
+std::string ReportGenerator::generateMeshInformation(const MeshType& mesh) {
     std::ostringstream oss;
-    oss << "Number of nodes: " << mesh.nodes.size() << "\n";
-    oss << "Number of elements: " << mesh.elements.size() << "\n";
-    oss << "Domain dimensions: X=[" << mesh.nodes.front().first << ", " 
-        << mesh.nodes.back().first << "], Y=[" << mesh.nodes.front().second 
-        << ", " << mesh.nodes.back().second << "]\n";
+    const Node& first = mesh.node(0);
+    const Node& last = mesh.node(mesh.nodeCount() - 1);
+    oss << "Number of nodes: " << mesh.nodeCount() << "\n";
+    oss << "Number of elements: " << mesh.elementCount() << "\n";
+    oss << "Domain dimensions: X=[" << first.first << ", " 
+        << last.first << "], Y=[" << first.second 
+        << ", " << last.second << "]\n";
 
     // Boundary information
     oss << "Boundary nodes:\n";
-    for (const auto& boundary : mesh.boundaries) {
-        oss << "  " << boundary.first << ": " << boundary.second.size() << " nodes\n";
+    for (const std::string& name : mesh.boundaryNames()) {
+        oss << "  " << name << ": " << mesh.findBoundary(name)->size() << " nodes\n";
     }
 
     return oss.str();
@@ -209,4 +222,18 @@ std::string ReportGenerator::generateProcessSteps() {
            "4. Application of boundary conditions\n"
            "5. Solution of linear system of equations\n"
            "6. Post-processing and visualization\n";
-}
\ No newline at end of file
+}
+
+// Export works on explicit, implicit structured and memory-mapped meshes
+template void ReportGenerator::generateReport<Mesh>(const Mesh&, const std::vector<double>&,
+    const std::map<std::string, std::string>&, const std::map<std::string, BoundaryConditionData>&, const std::string&);
+template void ReportGenerator::generateReport<StructuredMeshView>(const StructuredMeshView&, const std::vector<double>&,
+    const std::map<std::string, std::string>&, const std::map<std::string, BoundaryConditionData>&, const std::string&);
+template void ReportGenerator::exportSolutionData<Mesh>(const Mesh&, const std::vector<double>&, const std::string&);
+template void ReportGenerator::exportSolutionData<StructuredMeshView>(const StructuredMeshView&, const std::vector<double>&, const std::string&);
+template void ReportGenerator::exportMeshData<Mesh>(const Mesh&, const std::string&);
+template void ReportGenerator::exportMeshData<StructuredMeshView>(const StructuredMeshView&, const std::string&);
+template void ReportGenerator::generateReport<MappedMesh>(const MappedMesh&, const std::vector<double>&,
+    const std::map<std::string, std::string>&, const std::map<std::string, BoundaryConditionData>&, const std::string&);
+template void ReportGenerator::exportSolutionData<MappedMesh>(const MappedMesh&, const std::vector<double>&, const std::string&);
+template void ReportGenerator::exportMeshData<MappedMesh>(const MappedMesh&, const std::string&);
@@ -52,7 +52,7 @@ bool SolutionManager::solveCurrentProblem() {
 
             // Get the solution and mesh
             m_solution = ellipticApp->getSolution();
-            m_mesh = ellipticApp->getMesh();
+            m_mesh = ellipticApp->getSharedMesh();
             
             m_status = "Solution computed successfully!";
             return true;
@@ -92,7 +92,7 @@ bool SolutionManager::solveWithParameters(
 
             // Get the solution and mesh
             m_solution = ellipticApp->getSolution();
-            m_mesh = ellipticApp->getMesh();
+            m_mesh = ellipticApp->getSharedMesh();
             
             m_status = "Solution computed successfully!";
             return true;
@@ -113,7 +113,8 @@ const std::vector<double>& SolutionManager::getSolution() const {
 
 // Get the mesh data
 const Mesh& SolutionManager::getMesh() const {
-    return m_mesh;
+    static const Mesh emptyMesh;
+    return m_mesh ? *m_mesh : emptyMesh;
 }
 
 // Update solution based on current AppData
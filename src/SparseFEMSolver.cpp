@@ -0,0 +1,464 @@
+#include "SparseFEMSolver.h"
+#include "AssemblyKernels.h"
+#include "BoundaryValueCache.h"
+#include "EllipticFEMSolver.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace {
+
+// Symmetric 6-point rule of degree 4 on the reference triangle: barycentric coordinates and
+// weights (summing to one, to be scaled by the element area)
+constexpr int kQuadraturePoints = 6;
+constexpr double kQuadratureA = 0.445948490915965, kWeightA = 0.223381589678011;
+constexpr double kQuadratureB = 0.091576213509771, kWeightB = 0.109951743655322;
+constexpr double kBarycentric[kQuadraturePoints][3] = {
+    { kQuadratureA, kQuadratureA, 1.0 - 2.0 * kQuadratureA },
+    { kQuadratureA, 1.0 - 2.0 * kQuadratureA, kQuadratureA },
+    { 1.0 - 2.0 * kQuadratureA, kQuadratureA, kQuadratureA },
+    { kQuadratureB, kQuadratureB, 1.0 - 2.0 * kQuadratureB },
+    { kQuadratureB, 1.0 - 2.0 * kQuadratureB, kQuadratureB },
+    { 1.0 - 2.0 * kQuadratureB, kQuadratureB, kQuadratureB },
+};
+constexpr double kWeights[kQuadraturePoints] = { kWeightA, kWeightA, kWeightA, kWeightB, kWeightB, kWeightB };
+
+// Element matrix and load vector of a quadratic triangle
+struct QuadraticLocalSystem {
+    double K[6][6];
+    double F[6];
+};
+
+// Coefficient values at the quadrature points of one element
+struct QuadraturePointCoefficients {
+    const double* a11;
+    const double* a12;
+    const double* a22;
+    const double* b1;
+    const double* b2;
+    const double* c;
+    const double* f;
+};
+
+// Local system of a quadratic triangle. Shape functions in barycentric coordinates: vertex k is
+// l_k (2 l_k - 1), the midpoint opposite vertex k is 4 l_(k+1) l_(k+2).
+void computeQuadraticLocalSystem(const double* xs, const double* ys, const QuadraturePointCoefficients& coeffs, QuadraticLocalSystem& local) {
+    double detJ = (xs[1] - xs[0]) * (ys[2] - ys[0]) - (xs[2] - xs[0]) * (ys[1] - ys[0]);
+    double area = 0.5 * std::abs(detJ);
+    const double dL_dx[3] = { (ys[1] - ys[2]) / detJ, (ys[2] - ys[0]) / detJ, (ys[0] - ys[1]) / detJ };
+    const double dL_dy[3] = { (xs[2] - xs[1]) / detJ, (xs[0] - xs[2]) / detJ, (xs[1] - xs[0]) / detJ };
+
+    for (int i = 0; i < 6; ++i) {
+        local.F[i] = 0.0;
+        for (int j = 0; j < 6; ++j) local.K[i][j] = 0.0;
+    }
+
+    for (int q = 0; q < kQuadraturePoints; ++q) {
+        const double* l = kBarycentric[q];
+        double N[6], dN_dx[6], dN_dy[6];
+        for (int k = 0; k < 3; ++k) {
+            int k1 = (k + 1) % 3, k2 = (k + 2) % 3;
+            N[k] = l[k] * (2.0 * l[k] - 1.0);
+            dN_dx[k] = (4.0 * l[k] - 1.0) * dL_dx[k];
+            dN_dy[k] = (4.0 * l[k] - 1.0) * dL_dy[k];
+            N[3 + k] = 4.0 * l[k1] * l[k2];
+            dN_dx[3 + k] = 4.0 * (l[k2] * dL_dx[k1] + l[k1] * dL_dx[k2]);
+            dN_dy[3 + k] = 4.0 * (l[k2] * dL_dy[k1] + l[k1] * dL_dy[k2]);
+        }
+
+        double w = kWeights[q] * area;
+        double a11 = coeffs.a11[q], a12_twice = 2.0 * coeffs.a12[q], a22 = coeffs.a22[q];
+        double b1 = coeffs.b1[q], b2 = coeffs.b2[q], c = coeffs.c[q];
+        bool convects = !(std::abs(b1) < 1e-9 && std::abs(b2) < 1e-9);
+        for (int i = 0; i < 6; ++i) {
+            // A grad(Ni), with the mixed coefficient weighted like the linear assembly
+            double fluxX = a11 * dN_dx[i] + a12_twice * dN_dy[i];
+            double fluxY = a12_twice * dN_dx[i] + a22 * dN_dy[i];
+            for (int j = 0; j < 6; ++j) {
+                double value = fluxX * dN_dx[j] + fluxY * dN_dy[j] + c * N[i] * N[j];
+                if (convects) value += N[i] * (b1 * dN_dx[j] + b2 * dN_dy[j]);
+                local.K[i][j] += w * value;
+            }
+            local.F[i] += w * coeffs.f[q] * N[i];
+        }
+    }
+}
+
+// Two-point Gauss rule on [0, 1], applied in each direction of a grid cell
+constexpr int kGaussPoints = 2;
+constexpr double kGaussOffset = 0.288675134594812882; // 0.5 / sqrt(3)
+constexpr double kGaussWeight = 0.5;
+// 1D linear shape functions at the Gauss points, [function][point]: values, and derivatives in
+// the reference coordinate
+constexpr double kLineValues[2][kGaussPoints] = {
+    { 0.5 + kGaussOffset, 0.5 - kGaussOffset },
+    { 0.5 - kGaussOffset, 0.5 + kGaussOffset },
+};
+constexpr double kLineDerivatives[2][kGaussPoints] = { { -1.0, -1.0 }, { 1.0, 1.0 } };
+
+// Element matrix and load vector of a bilinear quadrilateral. Local node a + 2 b is corner
+// (a, b) of the cell: south-west, south-east, north-west, north-east.
+struct BilinearLocalSystem {
+    double K[4][4];
+    double F[4];
+};
+
+// Local system of an axis-aligned hx x hy cell. The coefficients hold the values at Gauss
+// point (qx, qy) at index qx + 2 qy. Every term of the bilinear form is a product of 1D factors,
+// so the sums over the points are taken one direction at a time: first over qy for each pair
+// of y factors, then over qx, instead of evaluating all 16 products at every point.
+void computeBilinearLocalSystem(double hx, double hy, const QuadraturePointCoefficients& coeffs, BilinearLocalSystem& local) {
+    typedef double LineTable[2][kGaussPoints];
+    struct Term {
+        const double* coefficient;
+        double scale;
+        const LineTable* xTest;
+        const LineTable* xTrial;
+        const LineTable* yTest;
+        const LineTable* yTrial;
+    };
+    const LineTable* L = &kLineValues;
+    const LineTable* D = &kLineDerivatives;
+    // Diffusion (with the mixed coefficient weighted like the linear assembly), convection
+    // N_i b.grad(N_j) and reaction
+    const Term terms[] = {
+        { coeffs.a11, 1.0 / (hx * hx), D, D, L, L },
+        { coeffs.a12, 2.0 / (hx * hy), D, L, L, D },
+        { coeffs.a12, 2.0 / (hx * hy), L, D, D, L },
+        { coeffs.a22, 1.0 / (hy * hy), L, L, D, D },
+        { coeffs.b1, 1.0 / hx, L, D, L, L },
+        { coeffs.b2, 1.0 / hy, L, L, L, D },
+        { coeffs.c, 1.0, L, L, L, L },
+    };
+
+    const double area = hx * hy;
+    for (int i = 0; i < 4; ++i) {
+        local.F[i] = 0.0;
+        for (int j = 0; j < 4; ++j) local.K[i][j] = 0.0;
+    }
+
+    for (const Term& term : terms) {
+        const double* w = term.coefficient;
+        if (w[0] == 0.0 && w[1] == 0.0 && w[2] == 0.0 && w[3] == 0.0) continue;
+        // Sum over qy: S[qx][b][d] for test y factor b and trial y factor d
+        double S[kGaussPoints][2][2];
+        for (int qx = 0; qx < kGaussPoints; ++qx) {
+            for (int b = 0; b < 2; ++b) {
+                for (int d = 0; d < 2; ++d) {
+                    double sum = 0.0;
+                    for (int qy = 0; qy < kGaussPoints; ++qy) {
+                        sum += w[qx + kGaussPoints * qy] * (*term.yTest)[b][qy] * (*term.yTrial)[d][qy];
+                    }
+                    S[qx][b][d] = kGaussWeight * sum;
+                }
+            }
+        }
+        // Sum over qx
+        const double scale = term.scale * area * kGaussWeight;
+        for (int a = 0; a < 2; ++a) {
+            for (int c = 0; c < 2; ++c) {
+                double x0 = (*term.xTest)[a][0] * (*term.xTrial)[c][0];
+                double x1 = (*term.xTest)[a][1] * (*term.xTrial)[c][1];
+                for (int b = 0; b < 2; ++b) {
+                    for (int d = 0; d < 2; ++d) {
+                        local.K[a + 2 * b][c + 2 * d] += scale * (x0 * S[0][b][d] + x1 * S[1][b][d]);
+                    }
+                }
+            }
+        }
+    }
+
+    // Load, factorized the same way
+    for (int b = 0; b < 2; ++b) {
+        double fy[kGaussPoints];
+        for (int qx = 0; qx < kGaussPoints; ++qx) {
+            fy[qx] = kGaussWeight * (coeffs.f[qx] * kLineValues[b][0] + coeffs.f[qx + kGaussPoints] * kLineValues[b][1]);
+        }
+        for (int a = 0; a < 2; ++a) {
+            local.F[a + 2 * b] = area * kGaussWeight * (kLineValues[a][0] * fy[0] + kLineValues[a][1] * fy[1]);
+        }
+    }
+}
+
+} // namespace
+
+SparseFEMSolver::SparseFEMSolver(
+    CoefficientFunction a11_func,
+    CoefficientFunction a12_func,
+    CoefficientFunction a22_func,
+    CoefficientFunction b1_func,
+    CoefficientFunction b2_func,
+    CoefficientFunction c_func,
+    CoefficientFunction f_func
+) : a11_func_(EllipticFEMSolver::toBatchFunction(a11_func)),
+    a12_func_(EllipticFEMSolver::toBatchFunction(a12_func)),
+    a22_func_(EllipticFEMSolver::toBatchFunction(a22_func)),
+    b1_func_(EllipticFEMSolver::toBatchFunction(b1_func)),
+    b2_func_(EllipticFEMSolver::toBatchFunction(b2_func)),
+    c_func_(EllipticFEMSolver::toBatchFunction(c_func)),
+    f_func_(EllipticFEMSolver::toBatchFunction(f_func))
+{
+}
+
+void SparseFEMSolver::setBatchCoefficients(
+    BatchCoefficientFunction a11_func, BatchCoefficientFunction a12_func, BatchCoefficientFunction a22_func,
+    BatchCoefficientFunction b1_func, BatchCoefficientFunction b2_func,
+    BatchCoefficientFunction c_func, BatchCoefficientFunction f_func
+) {
+    if (a11_func) a11_func_ = std::move(a11_func);
+    if (a12_func) a12_func_ = std::move(a12_func);
+    if (a22_func) a22_func_ = std::move(a22_func);
+    if (b1_func) b1_func_ = std::move(b1_func);
+    if (b2_func) b2_func_ = std::move(b2_func);
+    if (c_func) c_func_ = std::move(c_func);
+    if (f_func) f_func_ = std::move(f_func);
+}
+
+std::vector<double> SparseFEMSolver::solve(const Mesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    return solveOn(mesh, boundaryConditions);
+}
+
+std::vector<double> SparseFEMSolver::solve(const QuadraticMesh& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    return solveOn(mesh, boundaryConditions);
+}
+
+std::vector<double> SparseFEMSolver::solve(const StructuredMeshView& grid, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    return solveOn(grid, boundaryConditions);
+}
+
+std::pair<SparseMatrix, std::vector<double>> SparseFEMSolver::assemble(const Mesh& mesh) const {
+    const std::size_t nElements = mesh.elementCount();
+    SparseMatrix K = SparseMatrix::fromElements(mesh.nodeCount(), mesh.connectivity.data(), nElements, 3);
+    std::vector<double> F(mesh.nodeCount(), 0.0);
+
+    // Centroid coefficients in blocks, as in assembleElements
+    double xc[kAssemblyBlockSize], yc[kAssemblyBlockSize];
+    double a11[kAssemblyBlockSize], a12[kAssemblyBlockSize], a22[kAssemblyBlockSize];
+    double b1[kAssemblyBlockSize], b2[kAssemblyBlockSize];
+    double c[kAssemblyBlockSize], f[kAssemblyBlockSize];
+    LocalSystem local;
+    for (std::size_t blockStart = 0; blockStart < nElements; blockStart += kAssemblyBlockSize) {
+        const std::size_t blockSize = std::min(kAssemblyBlockSize, nElements - blockStart);
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const MeshIndex* t = &mesh.connectivity[3 * (blockStart + k)];
+            xc[k] = (mesh.x[t[0]] + mesh.x[t[1]] + mesh.x[t[2]]) / 3.0;
+            yc[k] = (mesh.y[t[0]] + mesh.y[t[1]] + mesh.y[t[2]]) / 3.0;
+        }
+        a11_func_(xc, yc, a11, blockSize);
+        a12_func_(xc, yc, a12, blockSize);
+        a22_func_(xc, yc, a22, blockSize);
+        b1_func_(xc, yc, b1, blockSize);
+        b2_func_(xc, yc, b2, blockSize);
+        c_func_(xc, yc, c, blockSize);
+        f_func_(xc, yc, f, blockSize);
+
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const MeshIndex* t = &mesh.connectivity[3 * (blockStart + k)];
+            computeLocalSystem(
+                mesh.x[t[0]], mesh.y[t[0]], mesh.x[t[1]], mesh.y[t[1]], mesh.x[t[2]], mesh.y[t[2]],
+                a11[k], a12[k], a22[k], b1[k], b2[k], c[k], f[k], true, local
+            );
+            for (int i = 0; i < 3; ++i) {
+                for (int j = 0; j < 3; ++j) K.add(t[i], t[j], local.K[i][j]);
+                F[t[i]] += local.F[i];
+            }
+        }
+    }
+    return std::make_pair(std::move(K), std::move(F));
+}
+
+std::pair<SparseMatrix, std::vector<double>> SparseFEMSolver::assemble(const QuadraticMesh& mesh) const {
+    const std::size_t nElements = mesh.elementCount();
+    SparseMatrix K = SparseMatrix::fromElements(mesh.nodeCount(), mesh.connectivity.data(), nElements, 6);
+    std::vector<double> F(mesh.nodeCount(), 0.0);
+
+    // Coefficients at the quadrature points of a block of elements at a time
+    constexpr std::size_t kPoints = kAssemblyBlockSize * kQuadraturePoints;
+    std::vector<double> xq(kPoints), yq(kPoints);
+    std::vector<double> a11(kPoints), a12(kPoints), a22(kPoints), b1(kPoints), b2(kPoints), c(kPoints), f(kPoints);
+    QuadraticLocalSystem local;
+    for (std::size_t blockStart = 0; blockStart < nElements; blockStart += kAssemblyBlockSize) {
+        const std::size_t blockSize = std::min(kAssemblyBlockSize, nElements - blockStart);
+        const std::size_t points = blockSize * kQuadraturePoints;
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const MeshIndex* t = &mesh.connectivity[6 * (blockStart + k)];
+            for (int q = 0; q < kQuadraturePoints; ++q) {
+                const double* l = kBarycentric[q];
+                xq[k * kQuadraturePoints + q] = l[0] * mesh.x[t[0]] + l[1] * mesh.x[t[1]] + l[2] * mesh.x[t[2]];
+                yq[k * kQuadraturePoints + q] = l[0] * mesh.y[t[0]] + l[1] * mesh.y[t[1]] + l[2] * mesh.y[t[2]];
+            }
+        }
+        a11_func_(xq.data(), yq.data(), a11.data(), points);
+        a12_func_(xq.data(), yq.data(), a12.data(), points);
+        a22_func_(xq.data(), yq.data(), a22.data(), points);
+        b1_func_(xq.data(), yq.data(), b1.data(), points);
+        b2_func_(xq.data(), yq.data(), b2.data(), points);
+        c_func_(xq.data(), yq.data(), c.data(), points);
+        f_func_(xq.data(), yq.data(), f.data(), points);
+
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const MeshIndex* t = &mesh.connectivity[6 * (blockStart + k)];
+            const double xs[3] = { mesh.x[t[0]], mesh.x[t[1]], mesh.x[t[2]] };
+            const double ys[3] = { mesh.y[t[0]], mesh.y[t[1]], mesh.y[t[2]] };
+            const std::size_t offset = k * kQuadraturePoints;
+            QuadraturePointCoefficients coeffs = {
+                &a11[offset], &a12[offset], &a22[offset], &b1[offset], &b2[offset], &c[offset], &f[offset]
+            };
+            computeQuadraticLocalSystem(xs, ys, coeffs, local);
+            for (int i = 0; i < 6; ++i) {
+                for (int j = 0; j < 6; ++j) K.add(t[i], t[j], local.K[i][j]);
+                F[t[i]] += local.F[i];
+            }
+        }
+    }
+    return std::make_pair(std::move(K), std::move(F));
+}
+
+std::pair<SparseMatrix, std::vector<double>> SparseFEMSolver::assemble(const StructuredMeshView& grid) const {
+    const MeshIndex Nx = grid.getNx();
+    const std::size_t cellsPerRow = static_cast<std::size_t>(grid.getNx() - 1);
+    const std::size_t nCells = cellsPerRow * (grid.getNy() - 1);
+
+    // Cell corners in local order, for the pattern and the scatter
+    std::vector<MeshIndex> cells(4 * nCells);
+    for (std::size_t cell = 0; cell < nCells; ++cell) {
+        MeshIndex n1 = static_cast<MeshIndex>(cell / cellsPerRow) * Nx + static_cast<MeshIndex>(cell % cellsPerRow);
+        MeshIndex* t = &cells[4 * cell];
+        t[0] = n1;
+        t[1] = n1 + 1;
+        t[2] = n1 + Nx;
+        t[3] = n1 + Nx + 1;
+    }
+    SparseMatrix K = SparseMatrix::fromElements(grid.nodeCount(), cells.data(), nCells, 4);
+    std::vector<double> F(grid.nodeCount(), 0.0);
+
+    // Coefficients at the Gauss points of a block of cells at a time
+    constexpr int kCellPoints = kGaussPoints * kGaussPoints;
+    constexpr std::size_t kPoints = kAssemblyBlockSize * kCellPoints;
+    std::vector<double> xq(kPoints), yq(kPoints);
+    std::vector<double> a11(kPoints), a12(kPoints), a22(kPoints), b1(kPoints), b2(kPoints), c(kPoints), f(kPoints);
+    std::vector<double> hx(kAssemblyBlockSize), hy(kAssemblyBlockSize);
+    BilinearLocalSystem local;
+    for (std::size_t blockStart = 0; blockStart < nCells; blockStart += kAssemblyBlockSize) {
+        const std::size_t blockSize = std::min(kAssemblyBlockSize, nCells - blockStart);
+        const std::size_t points = blockSize * kCellPoints;
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const MeshIndex* t = &cells[4 * (blockStart + k)];
+            Node southWest = grid.node(t[0]);
+            Node northEast = grid.node(t[3]);
+            hx[k] = northEast.first - southWest.first;
+            hy[k] = northEast.second - southWest.second;
+            for (int qy = 0; qy < kGaussPoints; ++qy) {
+                for (int qx = 0; qx < kGaussPoints; ++qx) {
+                    xq[k * kCellPoints + qx + kGaussPoints * qy] = southWest.first + kLineValues[1][qx] * hx[k];
+                    yq[k * kCellPoints + qx + kGaussPoints * qy] = southWest.second + kLineValues[1][qy] * hy[k];
+                }
+            }
+        }
+        a11_func_(xq.data(), yq.data(), a11.data(), points);
+        a12_func_(xq.data(), yq.data(), a12.data(), points);
+        a22_func_(xq.data(), yq.data(), a22.data(), points);
+        b1_func_(xq.data(), yq.data(), b1.data(), points);
+        b2_func_(xq.data(), yq.data(), b2.data(), points);
+        c_func_(xq.data(), yq.data(), c.data(), points);
+        f_func_(xq.data(), yq.data(), f.data(), points);
+
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const MeshIndex* t = &cells[4 * (blockStart + k)];
+            const std::size_t offset = k * kCellPoints;
+            QuadraturePointCoefficients coeffs = {
+                &a11[offset], &a12[offset], &a22[offset], &b1[offset], &b2[offset], &c[offset], &f[offset]
+            };
+            computeBilinearLocalSystem(hx[k], hy[k], coeffs, local);
+            for (int i = 0; i < 4; ++i) {
+                for (int j = 0; j < 4; ++j) K.add(t[i], t[j], local.K[i][j]);
+                F[t[i]] += local.F[i];
+            }
+        }
+    }
+    return std::make_pair(std::move(K), std::move(F));
+}
+
+template <class MeshType>
+std::vector<std::pair<MeshIndex, double>> SparseFEMSolver::applyBoundaryConditions(
+    const MeshType& mesh,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+    std::vector<double>& F_global
+) const {
+    // Values of every condition at its own boundary nodes, in boundary order
+    auto resolved = resolveBoundaryConditions(mesh, boundaryConditions);
+    std::uint32_t dirichletMask = 0, neumannMask = 0;
+    for (const auto& condition : resolved) (condition.dirichlet ? dirichletMask : neumannMask) |= condition.mask;
+
+    // Dirichlet nodes (the last Dirichlet condition in name order wins); linear triangles take
+    // the Neumann values as nodal loads
+    constexpr bool edgeFluxes = std::is_same<MeshType, QuadraticMesh>::value ||
+                                std::is_same<MeshType, StructuredMeshView>::value;
+    std::vector<std::pair<MeshIndex, double>> dirichletNodes;
+    forEachBoundaryConditionNode(
+        mesh, resolved,
+        [&](MeshIndex i, bool dirichlet, double dirichletValue, const std::vector<double>& neumannValues) {
+            if (dirichlet) {
+                dirichletNodes.emplace_back(i, dirichletValue);
+            } else if (!edgeFluxes) {
+                for (double value : neumannValues) F_global[i] += value;
+            }
+        });
+
+    if constexpr (std::is_same<MeshType, QuadraticMesh>::value) {
+        // Flux densities integrated along the boundary edges against the quadratic edge functions
+        auto valueAt = [](const auto& condition, MeshIndex node) {
+            const std::vector<MeshIndex>& nodes = *condition.boundary; // Ascending
+            return (*condition.values)[std::lower_bound(nodes.begin(), nodes.end(), node) - nodes.begin()];
+        };
+        for (std::size_t e = 0; e < mesh.elementCount(); ++e) {
+            const MeshIndex* t = &mesh.connectivity[6 * e];
+            for (int k = 0; k < 3; ++k) {
+                MeshIndex a = t[(k + 1) % 3], m = t[3 + k], b = t[(k + 2) % 3];
+                std::uint32_t tags = mesh.boundaryTag(m);
+                if (!(tags & neumannMask) || (tags & dirichletMask)) continue;
+                double h = std::hypot(mesh.x[b] - mesh.x[a], mesh.y[b] - mesh.y[a]);
+                for (const auto& condition : resolved) {
+                    if (condition.dirichlet || !(tags & condition.mask)) continue;
+                    double qa = valueAt(condition, a), qm = valueAt(condition, m), qb = valueAt(condition, b);
+                    F_global[a] += h / 30.0 * (4.0 * qa + 2.0 * qm - qb);
+                    F_global[m] += h / 30.0 * (2.0 * qa + 16.0 * qm + 2.0 * qb);
+                    F_global[b] += h / 30.0 * (-qa + 2.0 * qm + 4.0 * qb);
+                }
+            }
+        }
+    } else if constexpr (std::is_same<MeshType, StructuredMeshView>::value) {
+        // Flux densities integrated along the cell sides of every Neumann side of the grid
+        // against the linear edge functions
+        for (const auto& condition : resolved) {
+            if (condition.dirichlet) continue;
+            const StructuredMeshView::BoundaryRange& nodes = *condition.boundary;
+            const std::vector<double>& values = *condition.values;
+            for (std::size_t k = 0; k + 1 < nodes.size(); ++k) {
+                MeshIndex a = nodes[k], b = nodes[k + 1];
+                if (mesh.boundaryTag(a) & mesh.boundaryTag(b) & dirichletMask) continue;
+                Node pa = mesh.node(a), pb = mesh.node(b);
+                double h = std::hypot(pb.first - pa.first, pb.second - pa.second);
+                double qa = values[k], qb = values[k + 1];
+                F_global[a] += h / 6.0 * (2.0 * qa + qb);
+                F_global[b] += h / 6.0 * (qa + 2.0 * qb);
+            }
+        }
+    }
+    return dirichletNodes;
+}
+
+template <class MeshType>
+std::vector<double> SparseFEMSolver::solveOn(const MeshType& mesh, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    auto [K, F] = assemble(mesh);
+    K.applyDirichlet(applyBoundaryConditions(mesh, boundaryConditions, F), F);
+
+    std::vector<double> solution(mesh.nodeCount(), 0.0);
+    report_ = K.isSymmetric() ? solveConjugateGradient(K, F, solution, tolerance_, maxIterations_)
+                              : solveBiCGStab(K, F, solution, tolerance_, maxIterations_);
+    if (!report_.converged) {
+        throw std::runtime_error("Iterative solver did not converge: " + report_.describe());
+    }
+    return solution;
+}
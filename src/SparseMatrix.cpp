@@ -0,0 +1,146 @@
+#include "SparseMatrix.h"
+#include "KrylovSolvers.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+SparseMatrix SparseMatrix::fromElements(
+    std::size_t size, const MeshIndex* connectivity, std::size_t elementCount, int nodesPerElement
+) {
+    // Elements of every node, by counting sort
+    const std::size_t entries = elementCount * nodesPerElement;
+    std::vector<std::size_t> elementOffsets(size + 1, 0);
+    for (std::size_t k = 0; k < entries; ++k) {
+        MeshIndex node = connectivity[k];
+        if (node < 0 || static_cast<std::size_t>(node) >= size) {
+            throw std::out_of_range("Element node index out of range");
+        }
+        ++elementOffsets[node + 1];
+    }
+    for (std::size_t i = 0; i < size; ++i) elementOffsets[i + 1] += elementOffsets[i];
+    std::vector<MeshIndex> nodeElements(entries);
+    std::vector<std::size_t> cursor(elementOffsets.begin(), elementOffsets.end() - 1);
+    for (std::size_t k = 0; k < entries; ++k) {
+        nodeElements[cursor[connectivity[k]]++] = static_cast<MeshIndex>(k / nodesPerElement);
+    }
+
+    // Row patterns: the sorted nodes of the elements around each node
+    std::vector<std::vector<MeshIndex>> rows(size);
+    parallelFor(size, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            std::vector<MeshIndex>& row = rows[i];
+            for (std::size_t k = elementOffsets[i]; k < elementOffsets[i + 1]; ++k) {
+                const MeshIndex* nodes = connectivity + static_cast<std::size_t>(nodeElements[k]) * nodesPerElement;
+                row.insert(row.end(), nodes, nodes + nodesPerElement);
+            }
+            if (row.empty()) row.push_back(static_cast<MeshIndex>(i)); // Keep a diagonal for unused nodes
+            std::sort(row.begin(), row.end());
+            row.erase(std::unique(row.begin(), row.end()), row.end());
+        }
+    }, 1024);
+
+    SparseMatrix matrix;
+    matrix.rowOffsets_.resize(size + 1, 0);
+    for (std::size_t i = 0; i < size; ++i) matrix.rowOffsets_[i + 1] = matrix.rowOffsets_[i] + rows[i].size();
+    matrix.columns_.resize(matrix.rowOffsets_[size]);
+    matrix.values_.assign(matrix.rowOffsets_[size], 0.0);
+    for (std::size_t i = 0; i < size; ++i) {
+        std::copy(rows[i].begin(), rows[i].end(), matrix.columns_.begin() + matrix.rowOffsets_[i]);
+    }
+    return matrix;
+}
+
+std::size_t SparseMatrix::find(MeshIndex row, MeshIndex column) const {
+    auto first = columns_.begin() + rowOffsets_[row];
+    auto last = columns_.begin() + rowOffsets_[row + 1];
+    auto it = std::lower_bound(first, last, column);
+    if (it == last || *it != column) {
+        throw std::out_of_range("Sparse matrix entry outside the pattern");
+    }
+    return static_cast<std::size_t>(it - columns_.begin());
+}
+
+double SparseMatrix::at(MeshIndex row, MeshIndex column) const {
+    auto first = columns_.begin() + rowOffsets_[row];
+    auto last = columns_.begin() + rowOffsets_[row + 1];
+    auto it = std::lower_bound(first, last, column);
+    return (it != last && *it == column) ? values_[it - columns_.begin()] : 0.0;
+}
+
+void SparseMatrix::multiply(const std::vector<double>& x, std::vector<double>& y) const {
+    const std::size_t n = size();
+    y.resize(n);
+    parallelFor(n, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            double sum = 0.0;
+            for (std::size_t k = rowOffsets_[i]; k < rowOffsets_[i + 1]; ++k) {
+                sum += values_[k] * x[columns_[k]];
+            }
+            y[i] = sum;
+        }
+    }, 16384);
+}
+
+std::vector<double> SparseMatrix::diagonal() const {
+    std::vector<double> d(size(), 0.0);
+    for (std::size_t i = 0; i < d.size(); ++i) d[i] = at(static_cast<MeshIndex>(i), static_cast<MeshIndex>(i));
+    return d;
+}
+
+void SparseMatrix::applyDirichlet(const std::vector<std::pair<MeshIndex, double>>& nodes, std::vector<double>& rhs) {
+    const std::size_t n = size();
+    std::vector<char> fixed(n, 0);
+    std::vector<double> value(n, 0.0);
+    for (const auto& node : nodes) {
+        fixed[node.first] = 1;
+        value[node.first] = node.second;
+    }
+
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t k = rowOffsets_[i]; k < rowOffsets_[i + 1]; ++k) {
+            MeshIndex j = columns_[k];
+            if (fixed[i]) {
+                values_[k] = static_cast<std::size_t>(j) == i ? 1.0 : 0.0;
+            } else if (fixed[j]) {
+                rhs[i] -= values_[k] * value[j];
+                values_[k] = 0.0;
+            }
+        }
+        if (fixed[i]) rhs[i] = value[i];
+    }
+}
+
+bool SparseMatrix::isSymmetric(double tolerance) const {
+    double largest = 0.0;
+    for (double v : values_) largest = std::max(largest, std::abs(v));
+    for (std::size_t i = 0; i < size(); ++i) {
+        for (std::size_t k = rowOffsets_[i]; k < rowOffsets_[i + 1]; ++k) {
+            double transposed = at(columns_[k], static_cast<MeshIndex>(i));
+            if (std::abs(values_[k] - transposed) > tolerance * largest) return false;
+        }
+    }
+    return true;
+}
+
+std::string IterativeSolveReport::describe() const {
+    std::ostringstream out;
+    out << method << ": " << iterations << " iterations, relative residual " << relativeResidual
+        << (converged ? "" : " (not converged)") << "\n";
+    return out.str();
+}
+
+IterativeSolveReport solveConjugateGradient(
+    const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x,
+    double tolerance, int maxIterations
+) {
+    return krylov::conjugateGradient(A, b, x, tolerance, maxIterations);
+}
+
+IterativeSolveReport solveBiCGStab(
+    const SparseMatrix& A, const std::vector<double>& b, std::vector<double>& x,
+    double tolerance, int maxIterations
+) {
+    return krylov::biCGStab(A, b, x, tolerance, maxIterations);
+}
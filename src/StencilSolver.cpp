@@ -0,0 +1,341 @@
+#include "StencilSolver.h"
+#include "AssemblyKernels.h"
+#include "BoundaryValueCache.h"
+#include "EllipticFEMSolver.h"
+#include "KrylovSolvers.h"
+#include "ParallelFor.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+// Row and column steps of the stencil directions
+constexpr int kRowSteps[StencilOperator::DirectionCount] = { 0, 0, 0, -1, 1, -1, 1 };
+constexpr int kColumnSteps[StencilOperator::DirectionCount] = { 0, -1, 1, 0, 0, 1, -1 };
+
+// Grid nodes per parallel chunk of the row kernels
+constexpr std::size_t kNodesPerChunk = 16384;
+
+} // namespace
+
+StencilOperator::StencilOperator(int Nx, int Ny) : Nx_(Nx), Ny_(Ny) {
+    if (Nx < 2 || Ny < 2) {
+        throw std::invalid_argument("Stencil operators need at least 2 x 2 grid nodes");
+    }
+    for (AlignedDoubleVector& weights : weights_) {
+        weights.assign(size(), 0.0);
+    }
+}
+
+std::ptrdiff_t StencilOperator::offset(Direction direction) const {
+    return static_cast<std::ptrdiff_t>(kRowSteps[direction]) * Nx_ + kColumnSteps[direction];
+}
+
+StencilOperator::Direction StencilOperator::direction(int rowStep, int columnStep) {
+    for (int d = 0; d < DirectionCount; ++d) {
+        if (kRowSteps[d] == rowStep && kColumnSteps[d] == columnStep) {
+            return static_cast<Direction>(d);
+        }
+    }
+    throw std::invalid_argument("Node coupling outside the 7-point stencil");
+}
+
+template <bool Residual>
+void StencilOperator::applyRows(std::size_t rowBegin, std::size_t rowEnd, const double* x, const double* b, double* out) const {
+    const std::size_t Nx = static_cast<std::size_t>(Nx_);
+    const double* wC = weights_[Center].data();
+    const double* wW = weights_[West].data();
+    const double* wE = weights_[East].data();
+    const double* wS = weights_[South].data();
+    const double* wN = weights_[North].data();
+    const double* wSE = weights_[SouthEast].data();
+    const double* wNW = weights_[NorthWest].data();
+
+    // Nodes on the boundary of the grid: only the neighbours that exist
+    auto boundaryNode = [&](std::size_t row, std::size_t col) {
+        const std::size_t k = row * Nx + col;
+        double sum = wC[k] * x[k];
+        for (int d = West; d < DirectionCount; ++d) {
+            std::ptrdiff_t r = static_cast<std::ptrdiff_t>(row) + kRowSteps[d];
+            std::ptrdiff_t c = static_cast<std::ptrdiff_t>(col) + kColumnSteps[d];
+            if (r < 0 || r >= Ny_ || c < 0 || c >= Nx_) continue;
+            sum += weights_[d][k] * x[static_cast<std::size_t>(r) * Nx + c];
+        }
+        out[k] = Residual ? b[k] - sum : sum;
+    };
+
+    // Interior nodes [first, last) of a row with their own weights
+    auto variableNodes = [&](std::size_t first, std::size_t last) {
+        for (std::size_t k = first; k < last; ++k) {
+            double sum = wC[k] * x[k] + wW[k] * x[k - 1] + wE[k] * x[k + 1] +
+                         wS[k] * x[k - Nx] + wN[k] * x[k + Nx] +
+                         wSE[k] * x[k - Nx + 1] + wNW[k] * x[k + Nx - 1];
+            out[k] = Residual ? b[k] - sum : sum;
+        }
+    };
+    // Interior nodes [first, last) of a row with the constant stencil
+    auto constantNodes = [&](std::size_t first, std::size_t last) {
+        const double cC = interiorWeights_[Center], cW = interiorWeights_[West], cE = interiorWeights_[East];
+        const double cS = interiorWeights_[South], cN = interiorWeights_[North];
+        const double cSE = interiorWeights_[SouthEast], cNW = interiorWeights_[NorthWest];
+        for (std::size_t k = first; k < last; ++k) {
+            double sum = cC * x[k] + cW * x[k - 1] + cE * x[k + 1] + cS * x[k - Nx] + cN * x[k + Nx] +
+                         cSE * x[k - Nx + 1] + cNW * x[k + Nx - 1];
+            out[k] = Residual ? b[k] - sum : sum;
+        }
+    };
+
+    for (std::size_t row = rowBegin; row < rowEnd; ++row) {
+        if (row == 0 || row + 1 == static_cast<std::size_t>(Ny_)) {
+            for (std::size_t col = 0; col < Nx; ++col) boundaryNode(row, col);
+            continue;
+        }
+        boundaryNode(row, 0);
+        // Interior of the row: fixed offsets, unit stride in every array
+        const std::size_t first = row * Nx + 1, last = row * Nx + Nx - 1;
+        if (constantInterior_ && row >= 2 && row + 2 < static_cast<std::size_t>(Ny_)) {
+            variableNodes(first, first + 1);
+            constantNodes(first + 1, last - 1);
+            variableNodes(last - 1, last);
+        } else {
+            variableNodes(first, last);
+        }
+        boundaryNode(row, Nx - 1);
+    }
+}
+
+void StencilOperator::multiply(const std::vector<double>& x, std::vector<double>& y) const {
+    y.resize(size());
+    parallelFor(static_cast<std::size_t>(Ny_), [&](std::size_t begin, std::size_t end) {
+        applyRows<false>(begin, end, x.data(), nullptr, y.data());
+    }, std::max<std::size_t>(1, kNodesPerChunk / Nx_));
+}
+
+void StencilOperator::residual(const std::vector<double>& b, const std::vector<double>& x, std::vector<double>& r) const {
+    r.resize(size());
+    parallelFor(static_cast<std::size_t>(Ny_), [&](std::size_t begin, std::size_t end) {
+        applyRows<true>(begin, end, x.data(), b.data(), r.data());
+    }, std::max<std::size_t>(1, kNodesPerChunk / Nx_));
+}
+
+void StencilOperator::smooth(const std::vector<double>& b, std::vector<double>& x, int sweeps, double omega) const {
+    const std::size_t n = size();
+    const std::size_t Nx = static_cast<std::size_t>(Nx_);
+    std::vector<double> scaledInverse(n), next(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        double d = weights_[Center][k];
+        scaledInverse[k] = d != 0.0 ? omega / d : 0.0;
+    }
+    for (int sweep = 0; sweep < sweeps; ++sweep) {
+        // Residual and update of a block of rows while it is in cache
+        parallelFor(static_cast<std::size_t>(Ny_), [&](std::size_t begin, std::size_t end) {
+            applyRows<true>(begin, end, x.data(), b.data(), next.data());
+            for (std::size_t k = begin * Nx; k < end * Nx; ++k) next[k] = x[k] + scaledInverse[k] * next[k];
+        }, std::max<std::size_t>(1, kNodesPerChunk / Nx_));
+        x.swap(next);
+    }
+}
+
+bool StencilOperator::detectConstantInterior(double tolerance) {
+    constantInterior_ = false;
+    if (Nx_ < 5 || Ny_ < 5) return false;
+
+    const std::size_t Nx = static_cast<std::size_t>(Nx_);
+    const std::size_t reference = 2 * Nx + 2;
+    double largest = 0.0;
+    for (int d = 0; d < DirectionCount; ++d) largest = std::max(largest, std::abs(weights_[d][reference]));
+    for (std::size_t row = 2; row + 2 < static_cast<std::size_t>(Ny_); ++row) {
+        for (std::size_t k = row * Nx + 2; k < row * Nx + Nx - 2; ++k) {
+            for (int d = 0; d < DirectionCount; ++d) {
+                if (std::abs(weights_[d][k] - weights_[d][reference]) > tolerance * largest) return false;
+            }
+        }
+    }
+    for (int d = 0; d < DirectionCount; ++d) interiorWeights_[d] = weights_[d][reference];
+    constantInterior_ = true;
+    return true;
+}
+
+std::vector<double> StencilOperator::diagonal() const {
+    return std::vector<double>(weights_[Center].begin(), weights_[Center].end());
+}
+
+void StencilOperator::applyDirichlet(const std::vector<std::pair<MeshIndex, double>>& nodes, std::vector<double>& rhs) {
+    const std::size_t n = size();
+    constantInterior_ = false;
+    std::vector<char> fixed(n, 0);
+    std::vector<double> value(n, 0.0);
+    for (const auto& node : nodes) {
+        fixed[node.first] = 1;
+        value[node.first] = node.second;
+    }
+
+    for (std::size_t k = 0; k < n; ++k) {
+        const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(k / Nx_);
+        const std::ptrdiff_t col = static_cast<std::ptrdiff_t>(k % Nx_);
+        for (int d = West; d < DirectionCount; ++d) {
+            double& w = weights_[d][k];
+            if (fixed[k]) {
+                w = 0.0;
+                continue;
+            }
+            std::ptrdiff_t r = row + kRowSteps[d], c = col + kColumnSteps[d];
+            if (r < 0 || r >= Ny_ || c < 0 || c >= Nx_) continue;
+            std::size_t neighbour = static_cast<std::size_t>(r) * Nx_ + c;
+            if (fixed[neighbour]) {
+                rhs[k] -= w * value[neighbour];
+                w = 0.0;
+            }
+        }
+        if (fixed[k]) {
+            weights_[Center][k] = 1.0;
+            rhs[k] = value[k];
+        }
+    }
+}
+
+bool StencilOperator::isSymmetric(double tolerance) const {
+    double largest = 0.0;
+    for (const AlignedDoubleVector& weights : weights_) {
+        for (double w : weights) largest = std::max(largest, std::abs(w));
+    }
+    // Each coupling against its reverse at the neighbour
+    const Direction pairs[3][2] = { { East, West }, { North, South }, { NorthWest, SouthEast } };
+    for (std::size_t k = 0; k < size(); ++k) {
+        const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(k / Nx_);
+        const std::ptrdiff_t col = static_cast<std::ptrdiff_t>(k % Nx_);
+        for (const auto& pair : pairs) {
+            std::ptrdiff_t r = row + kRowSteps[pair[0]], c = col + kColumnSteps[pair[0]];
+            if (r < 0 || r >= Ny_ || c < 0 || c >= Nx_) continue;
+            double reverse = weights_[pair[1]][static_cast<std::size_t>(r) * Nx_ + c];
+            if (std::abs(weights_[pair[0]][k] - reverse) > tolerance * largest) return false;
+        }
+    }
+    return true;
+}
+
+SparseMatrix StencilOperator::toSparseMatrix() const {
+    // Pattern of the triangles of the grid, which is exactly the stencil
+    StructuredMeshView grid(1.0, 1.0, Nx_, Ny_);
+    MeshIndexVector connectivity;
+    connectivity.reserve(3 * grid.elementCount());
+    for (std::size_t e = 0; e < grid.elementCount(); ++e) {
+        Element element = grid.element(e);
+        connectivity.insert(connectivity.end(), element.begin(), element.end());
+    }
+    SparseMatrix matrix = SparseMatrix::fromElements(size(), connectivity.data(), grid.elementCount(), 3);
+
+    for (std::size_t k = 0; k < size(); ++k) {
+        const std::ptrdiff_t row = static_cast<std::ptrdiff_t>(k / Nx_);
+        const std::ptrdiff_t col = static_cast<std::ptrdiff_t>(k % Nx_);
+        for (int d = Center; d < DirectionCount; ++d) {
+            std::ptrdiff_t r = row + kRowSteps[d], c = col + kColumnSteps[d];
+            if (r < 0 || r >= Ny_ || c < 0 || c >= Nx_) continue;
+            matrix.add(static_cast<MeshIndex>(k), static_cast<MeshIndex>(r * Nx_ + c), weights_[d][k]);
+        }
+    }
+    return matrix;
+}
+
+StencilSolver::StencilSolver(
+    CoefficientFunction a11_func,
+    CoefficientFunction a12_func,
+    CoefficientFunction a22_func,
+    CoefficientFunction b1_func,
+    CoefficientFunction b2_func,
+    CoefficientFunction c_func,
+    CoefficientFunction f_func
+) : a11_func_(EllipticFEMSolver::toBatchFunction(a11_func)),
+    a12_func_(EllipticFEMSolver::toBatchFunction(a12_func)),
+    a22_func_(EllipticFEMSolver::toBatchFunction(a22_func)),
+    b1_func_(EllipticFEMSolver::toBatchFunction(b1_func)),
+    b2_func_(EllipticFEMSolver::toBatchFunction(b2_func)),
+    c_func_(EllipticFEMSolver::toBatchFunction(c_func)),
+    f_func_(EllipticFEMSolver::toBatchFunction(f_func))
+{
+}
+
+std::pair<StencilOperator, std::vector<double>> StencilSolver::assemble(const StructuredMeshView& grid) const {
+    StencilOperator A(grid.getNx(), grid.getNy());
+    std::vector<double> F(grid.nodeCount(), 0.0);
+    const std::size_t Nx = static_cast<std::size_t>(grid.getNx());
+
+    // Centroid coefficients in blocks, as in assembleElements
+    const std::size_t nElements = grid.elementCount();
+    double xc[kAssemblyBlockSize], yc[kAssemblyBlockSize];
+    double a11[kAssemblyBlockSize], a12[kAssemblyBlockSize], a22[kAssemblyBlockSize];
+    double b1[kAssemblyBlockSize], b2[kAssemblyBlockSize];
+    double c[kAssemblyBlockSize], f[kAssemblyBlockSize];
+    LocalSystem local;
+    for (std::size_t blockStart = 0; blockStart < nElements; blockStart += kAssemblyBlockSize) {
+        const std::size_t blockSize = std::min(kAssemblyBlockSize, nElements - blockStart);
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const Element element = grid.element(blockStart + k);
+            const Node p1 = grid.node(element[0]), p2 = grid.node(element[1]), p3 = grid.node(element[2]);
+            xc[k] = (p1.first + p2.first + p3.first) / 3.0;
+            yc[k] = (p1.second + p2.second + p3.second) / 3.0;
+        }
+        a11_func_(xc, yc, a11, blockSize);
+        a12_func_(xc, yc, a12, blockSize);
+        a22_func_(xc, yc, a22, blockSize);
+        b1_func_(xc, yc, b1, blockSize);
+        b2_func_(xc, yc, b2, blockSize);
+        c_func_(xc, yc, c, blockSize);
+        f_func_(xc, yc, f, blockSize);
+
+        for (std::size_t k = 0; k < blockSize; ++k) {
+            const Element element = grid.element(blockStart + k);
+            const Node p1 = grid.node(element[0]), p2 = grid.node(element[1]), p3 = grid.node(element[2]);
+            computeLocalSystem(
+                p1.first, p1.second, p2.first, p2.second, p3.first, p3.second,
+                a11[k], a12[k], a22[k], b1[k], b2[k], c[k], f[k], true, local
+            );
+            for (int i = 0; i < 3; ++i) {
+                const std::size_t ni = static_cast<std::size_t>(element[i]);
+                for (int j = 0; j < 3; ++j) {
+                    const std::size_t nj = static_cast<std::size_t>(element[j]);
+                    int rowStep = static_cast<int>(nj / Nx) - static_cast<int>(ni / Nx);
+                    int columnStep = static_cast<int>(nj % Nx) - static_cast<int>(ni % Nx);
+                    A.addWeight(StencilOperator::direction(rowStep, columnStep), ni, local.K[i][j]);
+                }
+                F[ni] += local.F[i];
+            }
+        }
+    }
+    return std::make_pair(std::move(A), std::move(F));
+}
+
+std::vector<std::pair<MeshIndex, double>> StencilSolver::applyBoundaryConditions(
+    const StructuredMeshView& grid,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+    std::vector<double>& F_global
+) const {
+    // Dirichlet nodes and nodal Neumann loads, from the values of every condition at its own
+    // boundary nodes
+    std::vector<std::pair<MeshIndex, double>> dirichletNodes;
+    forEachBoundaryConditionNode(
+        grid, resolveBoundaryConditions(grid, boundaryConditions),
+        [&](MeshIndex i, bool dirichlet, double dirichletValue, const std::vector<double>& neumannValues) {
+            if (dirichlet) {
+                dirichletNodes.emplace_back(i, dirichletValue);
+            } else {
+                for (double value : neumannValues) F_global[i] += value;
+            }
+        });
+    return dirichletNodes;
+}
+
+std::vector<double> StencilSolver::solve(const StructuredMeshView& grid, const std::map<std::string, BoundaryConditionData>& boundaryConditions) {
+    auto [A, F] = assemble(grid);
+    A.applyDirichlet(applyBoundaryConditions(grid, boundaryConditions, F), F);
+    A.detectConstantInterior();
+
+    std::vector<double> solution(grid.nodeCount(), 0.0);
+    report_ = A.isSymmetric() ? krylov::conjugateGradient(A, F, solution, tolerance_, maxIterations_)
+                              : krylov::biCGStab(A, F, solution, tolerance_, maxIterations_);
+    if (!report_.converged) {
+        throw std::runtime_error("Iterative solver did not converge: " + report_.describe());
+    }
+    return solution;
+}
@@ -0,0 +1,60 @@
+#include "StructuredMeshView.h"
+#include <stdexcept>
+
+StructuredMeshView::StructuredMeshView(double Lx, double Ly, int Nx, int Ny,
+                                       const AxisSpacing& xSpacing, const AxisSpacing& ySpacing)
+    : id(newMeshId()), Lx_(Lx), Ly_(Ly), Nx_(Nx), Ny_(Ny) {
+    if (Lx <= 0 || Ly <= 0 || Nx < 2 || Ny < 2) {
+        throw std::invalid_argument("Invalid mesh parameters: Lx, Ly must be positive, Nx, Ny must be >= 2");
+    }
+    if (!fitsMeshIndex(static_cast<std::size_t>(Nx) * Ny) ||
+        !fitsMeshIndex(2 * static_cast<std::size_t>(Nx - 1) * (Ny - 1))) {
+        throw std::invalid_argument("Mesh too large for 32-bit indices: build with FEMSOLVER_INDEX64");
+    }
+    dx_ = Lx_ / (Nx_ - 1);
+    dy_ = Ly_ / (Ny_ - 1);
+
+    if (!xSpacing.isUniform() || !ySpacing.isUniform()) {
+        graded_ = true;
+        xs_ = std::make_shared<const std::vector<double>>(xSpacing.coordinates(Lx_, Nx_));
+        ys_ = std::make_shared<const std::vector<double>>(ySpacing.coordinates(Ly_, Ny_));
+    }
+}
+
+std::optional<StructuredMeshView::BoundaryRange> StructuredMeshView::findBoundary(const std::string& name) const {
+    if (name == "west") return BoundaryRange(0, Nx_, Ny_);            // x = 0
+    if (name == "east") return BoundaryRange(Nx_ - 1, Nx_, Ny_);      // x = Lx
+    if (name == "south") return BoundaryRange(0, 1, Nx_);             // y = 0
+    if (name == "north") return BoundaryRange(static_cast<MeshIndex>(Ny_ - 1) * Nx_, 1, Nx_); // y = Ly
+    return std::nullopt;
+}
+
+int StructuredMeshView::boundaryTagBit(const std::string& name) const {
+    return BoundaryTags::builtinBit(name);
+}
+
+std::vector<std::string> StructuredMeshView::boundaryNames() const {
+    // Alphabetical, as Mesh::boundaryNames
+    return { "east", "north", "south", "west" };
+}
+
+Mesh StructuredMeshView::materialize() const {
+    Mesh mesh;
+    mesh.id = id;
+
+    mesh.reserve(nodeCount(), elementCount());
+    for (std::size_t i = 0; i < nodeCount(); ++i) {
+        Node p = node(i);
+        mesh.addNode(p.first, p.second);
+    }
+    for (std::size_t e = 0; e < elementCount(); ++e) {
+        mesh.addElement(element(e));
+    }
+
+    for (const std::string& name : boundaryNames()) {
+        BoundaryRange range = *findBoundary(name);
+        mesh.addBoundary(name, std::vector<MeshIndex>(range.begin(), range.end()));
+    }
+
+    return mesh;
+}
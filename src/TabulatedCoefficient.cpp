@@ -0,0 +1,240 @@
+#include "TabulatedCoefficient.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Binary layout: magic, int32 nx, int32 ny, 4 doubles (xMin, xMax, yMin, yMax), then nx*ny doubles.
+// Everything is stored in native (little-endian on all supported targets) byte order.
+const char kGridMagic[8] = { 'F', 'E', 'M', 'G', 'R', 'I', 'D', '1' };
+const std::size_t kGridHeaderSize = sizeof(kGridMagic) + 2 * sizeof(std::int32_t) + 4 * sizeof(double);
+
+inline int clampIndex(int i, int n) {
+    return i < 0 ? 0 : (i >= n ? n - 1 : i);
+}
+
+// Catmull-Rom weights for the four samples around local coordinate s in [0, 1]
+inline void cubicWeights(double s, double w[4]) {
+    w[0] = 0.5 * s * (s * (2.0 - s) - 1.0);
+    w[1] = 0.5 * (s * s * (3.0 * s - 5.0) + 2.0);
+    w[2] = 0.5 * s * (s * (4.0 - 3.0 * s) + 1.0);
+    w[3] = 0.5 * s * s * (s - 1.0);
+}
+
+bool hasTextExtension(const std::string& filename) {
+    std::size_t dot = filename.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = filename.substr(dot + 1);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char ch) { return static_cast<char>(std::tolower(ch)); });
+    return ext == "csv" || ext == "txt";
+}
+
+} // namespace
+
+TabulatedCoefficient::TabulatedCoefficient(int nx, int ny, double xMin, double xMax, double yMin, double yMax,
+                                           std::vector<double> values, GridInterpolation interpolation)
+    : nx_(nx), ny_(ny), xMin_(xMin), xMax_(xMax), yMin_(yMin), yMax_(yMax),
+      interpolation_(interpolation), storage_(std::move(values)) {
+    if (storage_.size() != static_cast<std::size_t>(nx) * static_cast<std::size_t>(ny)) {
+        throw std::invalid_argument("Tabulated coefficient: value count does not match grid size");
+    }
+    values_ = storage_.data();
+    initializeGeometry();
+}
+
+void TabulatedCoefficient::initializeGeometry() {
+    if (nx_ < 2 || ny_ < 2) {
+        throw std::invalid_argument("Tabulated coefficient: grid must have at least 2 x 2 samples");
+    }
+    if (!(xMax_ > xMin_) || !(yMax_ > yMin_)) {
+        throw std::invalid_argument("Tabulated coefficient: grid bounds must be increasing");
+    }
+    invDx_ = (nx_ - 1) / (xMax_ - xMin_);
+    invDy_ = (ny_ - 1) / (yMax_ - yMin_);
+}
+
+std::shared_ptr<TabulatedCoefficient> TabulatedCoefficient::loadCSV(
+    const std::string& filename,
+    double xMin, double xMax, double yMin, double yMax,
+    GridInterpolation interpolation
+) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open grid file: " + filename);
+    }
+
+    std::vector<double> values;
+    int nx = -1, ny = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::replace(line.begin(), line.end(), ';', ' ');
+        std::istringstream row(line);
+
+        int count = 0;
+        double v;
+        while (row >> v) {
+            values.push_back(v);
+            ++count;
+        }
+        if (!row.eof()) {
+            throw std::runtime_error("Invalid number in grid file " + filename + " at row " + std::to_string(ny + 1));
+        }
+        if (nx < 0) {
+            nx = count;
+        } else if (count != nx) {
+            throw std::runtime_error("Inconsistent column count in grid file " + filename + " at row " + std::to_string(ny + 1));
+        }
+        ++ny;
+    }
+
+    return std::make_shared<TabulatedCoefficient>(nx, ny, xMin, xMax, yMin, yMax, std::move(values), interpolation);
+}
+
+std::shared_ptr<TabulatedCoefficient> TabulatedCoefficient::loadBinary(
+    const std::string& filename,
+    GridInterpolation interpolation
+) {
+    MappedFile file(filename);
+    if (file.size() < kGridHeaderSize || std::memcmp(file.data(), kGridMagic, sizeof(kGridMagic)) != 0) {
+        throw std::runtime_error("Not a binary grid file: " + filename);
+    }
+
+    const char* p = file.data() + sizeof(kGridMagic);
+    std::int32_t nx, ny;
+    double bounds[4];
+    std::memcpy(&nx, p, sizeof(nx)); p += sizeof(nx);
+    std::memcpy(&ny, p, sizeof(ny)); p += sizeof(ny);
+    std::memcpy(bounds, p, sizeof(bounds));
+
+    std::size_t count = static_cast<std::size_t>(nx > 0 ? nx : 0) * static_cast<std::size_t>(ny > 0 ? ny : 0);
+    if (file.size() != kGridHeaderSize + count * sizeof(double)) {
+        throw std::runtime_error("Binary grid file has unexpected size: " + filename);
+    }
+
+    std::shared_ptr<TabulatedCoefficient> grid(new TabulatedCoefficient());
+    grid->nx_ = nx;
+    grid->ny_ = ny;
+    grid->xMin_ = bounds[0];
+    grid->xMax_ = bounds[1];
+    grid->yMin_ = bounds[2];
+    grid->yMax_ = bounds[3];
+    grid->interpolation_ = interpolation;
+    grid->initializeGeometry();
+
+    // The header is a multiple of 8 bytes and mappings are page aligned, so the samples can be read in place
+    const char* samples = file.data() + kGridHeaderSize;
+    if (file.size() >= kMapThresholdBytes) {
+        grid->values_ = reinterpret_cast<const double*>(samples);
+        grid->mapped_ = std::move(file);
+    } else {
+        grid->storage_.resize(count);
+        std::memcpy(grid->storage_.data(), samples, count * sizeof(double));
+        grid->values_ = grid->storage_.data();
+    }
+    return grid;
+}
+
+std::shared_ptr<TabulatedCoefficient> TabulatedCoefficient::load(
+    const std::string& filename,
+    double xMin, double xMax, double yMin, double yMax,
+    GridInterpolation interpolation
+) {
+    if (hasTextExtension(filename)) {
+        return loadCSV(filename, xMin, xMax, yMin, yMax, interpolation);
+    }
+    return loadBinary(filename, interpolation);
+}
+
+void TabulatedCoefficient::saveBinary(const std::string& filename) const {
+    std::ofstream file(filename, std::ios_base::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file for writing: " + filename);
+    }
+
+    std::int32_t nx = nx_, ny = ny_;
+    double bounds[4] = { xMin_, xMax_, yMin_, yMax_ };
+    file.write(kGridMagic, sizeof(kGridMagic));
+    file.write(reinterpret_cast<const char*>(&nx), sizeof(nx));
+    file.write(reinterpret_cast<const char*>(&ny), sizeof(ny));
+    file.write(reinterpret_cast<const char*>(bounds), sizeof(bounds));
+    file.write(reinterpret_cast<const char*>(values_), static_cast<std::streamsize>(sizeof(double) * nx_ * ny_));
+
+    if (!file) {
+        throw std::runtime_error("Error writing grid file: " + filename);
+    }
+}
+
+void TabulatedCoefficient::locate(double t, double tMin, double invStep, int n, int& cell, double& local) {
+    double u = (t - tMin) * invStep;
+    u = u < 0.0 ? 0.0 : (u > n - 1 ? n - 1 : u);
+    cell = static_cast<int>(u);
+    if (cell > n - 2) cell = n - 2;
+    local = u - cell;
+}
+
+double TabulatedCoefficient::bilinear(double x, double y) const {
+    int i, j;
+    double s, t;
+    locate(x, xMin_, invDx_, nx_, i, s);
+    locate(y, yMin_, invDy_, ny_, j, t);
+
+    const double* row0 = values_ + static_cast<std::size_t>(j) * nx_ + i;
+    const double* row1 = row0 + nx_;
+    double bottom = row0[0] + s * (row0[1] - row0[0]);
+    double top = row1[0] + s * (row1[1] - row1[0]);
+    return bottom + t * (top - bottom);
+}
+
+double TabulatedCoefficient::bicubic(double x, double y) const {
+    int i, j;
+    double s, t;
+    locate(x, xMin_, invDx_, nx_, i, s);
+    locate(y, yMin_, invDy_, ny_, j, t);
+
+    double wx[4], wy[4];
+    cubicWeights(s, wx);
+    cubicWeights(t, wy);
+
+    int cols[4];
+    for (int k = 0; k < 4; ++k) cols[k] = clampIndex(i - 1 + k, nx_);
+
+    double result = 0.0;
+    for (int r = 0; r < 4; ++r) {
+        const double* row = values_ + static_cast<std::size_t>(clampIndex(j - 1 + r, ny_)) * nx_;
+        double rowValue = wx[0] * row[cols[0]] + wx[1] * row[cols[1]] + wx[2] * row[cols[2]] + wx[3] * row[cols[3]];
+        result += wy[r] * rowValue;
+    }
+    return result;
+}
+
+double TabulatedCoefficient::operator()(double x, double y) const {
+    return interpolation_ == GridInterpolation::Bicubic ? bicubic(x, y) : bilinear(x, y);
+}
+
+void TabulatedCoefficient::evaluate(const double* x, const double* y, double* out, std::size_t n) const {
+    // Dispatch once per batch so the inner loops stay branch-free
+    if (interpolation_ == GridInterpolation::Bicubic) {
+        for (std::size_t k = 0; k < n; ++k) out[k] = bicubic(x[k], y[k]);
+    } else {
+        for (std::size_t k = 0; k < n; ++k) out[k] = bilinear(x[k], y[k]);
+    }
+}
+
+CoefficientFunction TabulatedCoefficient::toFunction(std::shared_ptr<const TabulatedCoefficient> grid) {
+    return [grid](double x, double y) -> double { return (*grid)(x, y); };
+}
+
+BatchCoefficientFunction TabulatedCoefficient::toBatchFunction(std::shared_ptr<const TabulatedCoefficient> grid) {
+    return [grid](const double* x, const double* y, double* out, std::size_t n) {
+        grid->evaluate(x, y, out, n);
+    };
+}
\ No newline at end of file
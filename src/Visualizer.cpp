@@ -3,7 +3,41 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <algorithm>
 
+namespace {
+
+template <class MeshType>
+void printSummary(const MeshType& mesh, const std::vector<double>& solution) {
+    std::cout << "Plotting solution with " << mesh.nodeCount() << " nodes and "
+              << mesh.elementCount() << " elements" << std::endl;
+
+    // In a real implementation, this would create a plot using a graphics library
+    // For now, we'll just print some information
+    std::cout << "Solution range: [" << *std::min_element(solution.begin(), solution.end())
+              << ", " << *std::max_element(solution.begin(), solution.end()) << "]" << std::endl;
+}
+
+template <class MeshType>
+void writePlotData(std::ostream& file, const MeshType& mesh, const std::vector<double>& solution) {
+    // Write node data
+    for (size_t i = 0; i < mesh.nodeCount(); ++i) {
+        Node node = mesh.node(i);
+        file << i << ", "
+             << node.first << ", "
+             << node.second << ", "
+             << solution[i] << std::endl;
+    }
+
+    // Write element data
+    file << std::endl << "# Elements (Node indices)" << std::endl;
+    for (size_t e = 0; e < mesh.elementCount(); ++e) {
+        Element element = mesh.element(e);
+        file << element[0] << " " << element[1] << " " << element[2] << std::endl;
+    }
+}
+
+} // namespace
 
 Visualizer::Visualizer() {
     reportGenerator_ = std::make_unique<ReportGenerator>();
@@ -14,16 +48,21 @@ Visualizer::~Visualizer() = default;
 void Visualizer::plotSolution(const Mesh& mesh, const std::vector<double>& solution, const std::string& title) {
     // Store the data temporarily
     mesh_ = mesh;
+    mappedMesh_.reset();
     solution_ = solution;
     title_ = title;
 
-    std::cout << "Plotting solution with " << mesh.nodes.size() << " nodes and "
-              << mesh.elements.size() << " elements" << std::endl;
+    printSummary(mesh, solution);
+}
 
-    // In a real implementation, this would create a plot using a graphics library
-    // For now, we'll just print some information
-    std::cout << "Solution range: [" << *std::min_element(solution.begin(), solution.end())
-              << ", " << *std::max_element(solution.begin(), solution.end()) << "]" << std::endl;
+void Visualizer::plotSolution(const MappedMesh& mesh, const std::vector<double>& solution, const std::string& title) {
+    // The handle shares the mapping, so only the solution is copied
+    mesh_ = Mesh();
+    mappedMesh_ = mesh;
+    solution_ = solution;
+    title_ = title;
+
+    printSummary(mesh, solution);
 }
 
 void Visualizer::exportPlot(const std::string& filename) {
@@ -37,18 +76,10 @@ void Visualizer::exportPlot(const std::string& filename) {
     file << "# Solution data for: " << title_ << std::endl;
     file << "# Node_Id, X, Y, Solution_Value" << std::endl;
 
-    // Write node data
-    for (size_t i = 0; i < mesh_.nodes.size(); ++i) {
-        file << i << ", "
-             << mesh_.nodes[i].first << ", "
-             << mesh_.nodes[i].second << ", "
-             << solution_[i] << std::endl;
-    }
-
-    // Write element data
-    file << std::endl << "# Elements (Node indices)" << std::endl;
-    for (const auto& element : mesh_.elements) {
-        file << element[0] << " " << element[1] << " " << element[2] << std::endl;
+    if (mappedMesh_) {
+        writePlotData(file, *mappedMesh_, solution_);
+    } else {
+        writePlotData(file, mesh_, solution_);
     }
 
     file.close();
@@ -70,4 +101,21 @@ void Visualizer::generateReport(
     } else {
         throw std::runtime_error("Report generator not initialized");
     }
-}
\ No newline at end of file
+}
+
+void Visualizer::generateReport(
+    const MappedMesh& mesh,
+    const std::vector<double>& solution,
+    const std::map<std::string, std::string>& equationCoefficients,
+    const std::map<std::string, BoundaryConditionData>& boundaryConditions,
+    const std::string& filename
+) {
+    if (reportGenerator_) {
+        reportGenerator_->generateReport(
+            mesh, solution, equationCoefficients, boundaryConditions, filename
+        );
+        std::cout << "Detailed report generated: " << filename << std::endl;
+    } else {
+        throw std::runtime_error("Report generator not initialized");
+    }
+}
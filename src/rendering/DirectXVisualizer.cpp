@@ -2,6 +2,7 @@
 #include "../include/rendering/DirectXVisualizer.h"
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 DirectXVisualizer::DirectXVisualizer()
     : hwndTarget_(nullptr), device_(nullptr), context_(nullptr), swapChain_(nullptr),
@@ -518,7 +519,7 @@ bool DirectXVisualizer::createConstantBuffer() {
 }
 
 bool DirectXVisualizer::createMeshBuffers(const Mesh& mesh, const std::vector<double>& solution, int Nx, int Ny) {
-    if (solution.empty() || mesh.nodes.empty() || mesh.elements.empty()) {
+    if (solution.empty() || mesh.empty() || mesh.elementCount() == 0) {
         return false;
     }
 
@@ -531,7 +532,7 @@ bool DirectXVisualizer::createMeshBuffers(const Mesh& mesh, const std::vector<do
 
     // Create vertices from mesh nodes with color based on solution values
     std::vector<VertexPosColor> vertices;
-    vertices.reserve(mesh.nodes.size());
+    vertices.reserve(mesh.nodeCount());
 
     // Calculate domain center and dimensions for proper positioning
     double minX = std::numeric_limits<double>::max();
@@ -539,11 +540,17 @@ bool DirectXVisualizer::createMeshBuffers(const Mesh& mesh, const std::vector<do
     double minY = std::numeric_limits<double>::max();
     double maxY = std::numeric_limits<double>::lowest();
 
-    for (const auto& node : mesh.nodes) {
-        minX = std::min(minX, node.first);
-        maxX = std::max(maxX, node.first);
-        minY = std::min(minY, node.second);
-        maxY = std::max(maxY, node.second);
+    // Separate scans over the contiguous coordinate arrays vectorize well
+    const size_t nodeCount = mesh.nodeCount();
+    const double* xs = mesh.x.data();
+    const double* ys = mesh.y.data();
+    for (size_t i = 0; i < nodeCount; ++i) {
+        minX = std::min(minX, xs[i]);
+        maxX = std::max(maxX, xs[i]);
+    }
+    for (size_t i = 0; i < nodeCount; ++i) {
+        minY = std::min(minY, ys[i]);
+        maxY = std::max(maxY, ys[i]);
     }
 
     domainLx_ = static_cast<float>(maxX - minX);
@@ -557,12 +564,12 @@ bool DirectXVisualizer::createMeshBuffers(const Mesh& mesh, const std::vector<do
     cameraTargetZ_ = 0.0f;
     cameraTargetY_ = static_cast<float>((minVal + maxVal) / 2.0);
 
-    for (size_t i = 0; i < mesh.nodes.size(); ++i) {
+    for (size_t i = 0; i < nodeCount; ++i) {
         VertexPosColor vertex;
         vertex.position = DirectX::XMFLOAT3(
-            static_cast<float>(mesh.nodes[i].first) - static_cast<float>(centerX),  // x coordinate is first in pair, centered
+            static_cast<float>(xs[i]) - static_cast<float>(centerX),  // x coordinate, centered
             static_cast<float>(solution[i]), // Use solution value as Y coordinate for 3D visualization
-            static_cast<float>(mesh.nodes[i].second) - static_cast<float>(centerY)  // y coordinate is second in pair, centered
+            static_cast<float>(ys[i]) - static_cast<float>(centerY)   // y coordinate, centered
         );
 
         // Map solution value to color (blue to red gradient)
@@ -577,13 +584,19 @@ bool DirectXVisualizer::createMeshBuffers(const Mesh& mesh, const std::vector<do
         vertices.push_back(vertex);
     }
 
-    // Create indices from mesh elements (triangles)
-    std::vector<unsigned long> indices;
-    for (const auto& element : mesh.elements) {
-        // Each element is a triangle with 3 nodes (std::array<int, 3>)
-        for (int j = 0; j < 3; ++j) {
-            indices.push_back(element[j]);  // Access array element directly
-        }
+    // Create indices from the flat connectivity (3 nodes per triangle). The index buffer is
+    // DXGI_FORMAT_R32_UINT, so meshes numbered beyond 32 bits cannot be drawn
+    if (nodeCount > std::numeric_limits<UINT>::max()) {
+        return false;
+    }
+    // Buffer sizes are UINT byte counts as well
+    const size_t maxBytes = std::numeric_limits<UINT>::max();
+    if (vertices.size() > maxBytes / sizeof(VertexPosColor) || mesh.connectivity.size() > maxBytes / sizeof(UINT)) {
+        return false;
+    }
+    std::vector<UINT> indices(mesh.connectivity.size());
+    for (size_t k = 0; k < indices.size(); ++k) {
+        indices[k] = static_cast<UINT>(mesh.connectivity[k]);
     }
 
     // Release existing buffers if they exist
@@ -614,7 +627,7 @@ bool DirectXVisualizer::createMeshBuffers(const Mesh& mesh, const std::vector<do
     // Create new index buffer
     D3D11_BUFFER_DESC indexBufferDesc = {};
     indexBufferDesc.Usage = D3D11_USAGE_DEFAULT; // Changed from DYNAMIC for simplicity
-    indexBufferDesc.ByteWidth = sizeof(unsigned long) * static_cast<UINT>(indices.size());
+    indexBufferDesc.ByteWidth = sizeof(UINT) * static_cast<UINT>(indices.size());
     indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
     indexBufferDesc.CPUAccessFlags = 0;
 